@@ -0,0 +1,96 @@
+##################################################################
+# Codegen regression test: counts instructions, branches and divisions of every probe function
+# Usage (normally invoked by the SafeIntegralCodegen target):
+#  cmake -DOBJDUMP=<objdump> -DOBJECT_O2=<object> -DOBJECT_O3=<object> -DBASELINE=<csv> [-DUPDATE_BASELINE=ON] -P Codegen.cmake
+#
+# Only the hot part of every function is measured (the ".cold" parts with the throw statements are ignored).
+# The test fails if any probe needs more instructions, branches or divisions than recorded in the baseline.
+# Since codegen depends on the compiler, there is one baseline for every compiler and major version.
+
+cmake_minimum_required(VERSION 3.2)
+
+set(METRICS instructions branches divisions)
+set(ENTRIES "")
+foreach(level O2 O3)
+	set(object "${OBJECT_${level}}")
+	execute_process(COMMAND "${OBJDUMP}" -d --no-show-raw-insn "${object}"
+		OUTPUT_VARIABLE disasm RESULT_VARIABLE res)
+	if(NOT res EQUAL 0)
+		message(FATAL_ERROR "Unable to disassemble ${object}")
+	endif()
+	string(REGEX REPLACE "[][;]" "_" disasm "${disasm}") # characters with a special meaning in cmake lists
+	string(REPLACE "\n" ";" lines "${disasm}")
+	set(probes "")
+	set(current "")
+	foreach(line ${lines})
+		if(line MATCHES "^[0-9a-f]+ <([^>]+)>:$")
+			set(current "")
+			if(CMAKE_MATCH_1 MATCHES "^_?(probe_[A-Za-z0-9_]+)$")
+				set(current ${CMAKE_MATCH_1})
+				list(APPEND probes ${current})
+				set(${current}_insn 0)
+				set(${current}_branch 0)
+				set(${current}_div 0)
+			endif()
+		elseif(current AND line MATCHES "^ +[0-9a-f]+:\t([a-z][a-z0-9]*)")
+			set(mnemonic ${CMAKE_MATCH_1})
+			if(mnemonic MATCHES "^(nop|nopw|nopl|xchg)$" OR line MATCHES "\tdata16|\tcs nopw")
+				continue() # padding between functions
+			endif()
+			math(EXPR ${current}_insn "${${current}_insn} + 1")
+			if(mnemonic MATCHES "^j")
+				math(EXPR ${current}_branch "${${current}_branch} + 1")
+			endif()
+			if(mnemonic MATCHES "^i?div")
+				math(EXPR ${current}_div "${${current}_div} + 1")
+			endif()
+		endif()
+	endforeach()
+	foreach(probe ${probes})
+		list(APPEND ENTRIES "${probe},${level},${${probe}_insn},${${probe}_branch},${${probe}_div}")
+	endforeach()
+endforeach()
+
+if(UPDATE_BASELINE OR NOT EXISTS "${BASELINE}")
+	string(REPLACE ";" "\n" REPORT "probe,level,instructions,branches,divisions;${ENTRIES}")
+	file(WRITE "${BASELINE}" "${REPORT}\n")
+	message("Baseline written to ${BASELINE}")
+	return()
+endif()
+
+file(STRINGS "${BASELINE}" baseline_lines)
+foreach(line ${baseline_lines})
+	if(line MATCHES "^([^,]+),([^,]+),([0-9]+),([0-9]+),([0-9]+)$")
+		set(base_${CMAKE_MATCH_1}_${CMAKE_MATCH_2} "${CMAKE_MATCH_3};${CMAKE_MATCH_4};${CMAKE_MATCH_5}")
+	endif()
+endforeach()
+
+set(failures 0)
+foreach(line ${ENTRIES})
+	string(REGEX MATCH "^([^,]+),([^,]+),([0-9]+),([0-9]+),([0-9]+)$" unused "${line}")
+	set(probe ${CMAKE_MATCH_1})
+	set(level ${CMAKE_MATCH_2})
+	set(current "${CMAKE_MATCH_3};${CMAKE_MATCH_4};${CMAKE_MATCH_5}")
+	if(NOT DEFINED base_${probe}_${level})
+		message("new      ${probe} (-${level}): ${current}")
+		continue()
+	endif()
+	set(base ${base_${probe}_${level}})
+	foreach(index 0 1 2)
+		list(GET current ${index} now)
+		list(GET base ${index} before)
+		if(now GREATER before)
+			list(GET METRICS ${index} what)
+			message("WORSE    ${probe} (-${level}): ${what} ${before} -> ${now}")
+			math(EXPR failures "${failures} + 1")
+		elseif(now LESS before)
+			list(GET METRICS ${index} what)
+			message("better   ${probe} (-${level}): ${what} ${before} -> ${now}")
+		endif()
+	endforeach()
+endforeach()
+
+if(failures GREATER 0)
+	message(FATAL_ERROR "${failures} codegen regression(s), if expected regenerate the baseline by configuring with -DCODEGEN_UPDATE_BASELINE=ON")
+endif()
+message("No codegen regression")
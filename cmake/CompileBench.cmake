@@ -0,0 +1,61 @@
+##################################################################
+# Measures the frontend time of including every header of the library
+# Usage (normally invoked by the SafeIntegralCompileBench target):
+#  cmake -DCXX=<compiler> -DSRC=<source dir> -DOUT=<output dir> [-DREPEAT=10] [-DSTANDARDS="11;14;17;20"] -P CompileBench.cmake
+#
+# Every configuration (header x standard) is compiled REPEAT times with -fsyntax-only, the best time is reported.
+# The "baseline" entry includes only the standard headers, the "selftest" entry the compile-time tests.
+
+cmake_minimum_required(VERSION 3.23) # string(TIMESTAMP) with %f
+
+if(NOT REPEAT)
+	set(REPEAT 10)
+endif()
+if(NOT STANDARDS)
+	set(STANDARDS "11;14;17;20")
+endif()
+if(NOT SYNTAX_ONLY)
+	set(SYNTAX_ONLY "-fsyntax-only")
+endif()
+
+file(MAKE_DIRECTORY "${OUT}")
+
+set(BASELINE "#include <cstdint>\n#include <limits>\n#include <stdexcept>\n#include <type_traits>\n#if __cplusplus > 201402L\n#include <optional>\n#endif\n")
+file(WRITE "${OUT}/baseline.cpp" "${BASELINE}")
+set(CONFIGS baseline)
+foreach(header errors.hpp safeintegralop_cmp.hpp safeintegralop2.hpp safeintegralop.hpp safeintegral.hpp)
+	string(REPLACE ".hpp" "" name ${header})
+	file(WRITE "${OUT}/${name}.cpp" "${BASELINE}#include \"${SRC}/safeintegral/${header}\"\n")
+	list(APPEND CONFIGS ${name})
+endforeach()
+file(WRITE "${OUT}/selftest.cpp" "#include \"${SRC}/test/testconstexpr.cpp\"\n")
+list(APPEND CONFIGS selftest)
+
+set(REPORT "configuration;standard;best_us\n")
+message("configuration            c++XX   best frontend time [us]")
+foreach(config ${CONFIGS})
+	foreach(std ${STANDARDS})
+		set(best "")
+		foreach(i RANGE 1 ${REPEAT})
+			string(TIMESTAMP start "%s%f" UTC)
+			execute_process(COMMAND "${CXX}" -std=c++${std} ${SYNTAX_ONLY} "${OUT}/${config}.cpp"
+				RESULT_VARIABLE res ERROR_VARIABLE err)
+			string(TIMESTAMP stop "%s%f" UTC)
+			if(NOT res EQUAL 0)
+				message(FATAL_ERROR "${config} (c++${std}) does not compile:\n${err}")
+			endif()
+			math(EXPR elapsed "${stop} - ${start}")
+			if(best STREQUAL "" OR elapsed LESS best)
+				set(best ${elapsed})
+			endif()
+		endforeach()
+		string(LENGTH "${config}" len)
+		math(EXPR pad "25 - ${len}")
+		string(REPEAT " " ${pad} padding)
+		message("${config}${padding}${std}      ${best}")
+		string(APPEND REPORT "${config};${std};${best}\n")
+	endforeach()
+endforeach()
+
+file(WRITE "${OUT}/compilebench.csv" "${REPORT}")
+message("Results written to ${OUT}/compilebench.csv")
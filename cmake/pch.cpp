@@ -0,0 +1 @@
+// Translation unit used only for generating the precompiled header, see option PCH in CMakeLists.txt
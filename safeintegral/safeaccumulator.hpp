@@ -0,0 +1,215 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEACCUMULATOR_HPP
+#define SAFEINTEGRAL_SAFEACCUMULATOR_HPP
+
+#include "safeintegral.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// true if the 64 bits two's complement value w (the unsigned values of T are also < 2^63) can be represented by T
+		template <typename T>
+		constexpr bool word_in_range(const std::uint64_t w) noexcept {
+			return std::uint64_t(w - std::uint64_t(std::numeric_limits<T>::min())) <=
+			    std::uint64_t(std::uint64_t(std::numeric_limits<T>::max()) - std::uint64_t(std::numeric_limits<T>::min()));
+		}
+
+		// true if the 64 bits two's complement value w is in [-2^62, 2^62)
+		constexpr bool in_accumulator_zone(const std::uint64_t w) noexcept {
+			return std::uint64_t(w + (std::uint64_t(1) << 62)) < (std::uint64_t(1) << 63);
+		}
+
+		// exact sum of values of T, in 64 bits (two's complement, the unsigned arithmetic never overflows)
+		// Starting from a sum in [-2^62, 2^62), 2^check_bits values of magnitude at most 2^digits can be added without
+		// wraparound
+		template <typename T, bool = (std::numeric_limits<T>::digits > 32)>
+		struct accumulator_sum {
+			static const unsigned check_bits = 61 - unsigned(std::numeric_limits<T>::digits);
+			std::uint64_t s = 0;
+
+			void add(const T v) noexcept {
+				s += std::uint64_t(v);
+			}
+			void add(const accumulator_sum& other) noexcept {
+				s += other.s;
+			}
+			bool in_zone() const noexcept {
+				return in_accumulator_zone(s);
+			}
+			bool in_range() const noexcept {
+				return word_in_range<T>(s);
+			}
+			T get() const noexcept {
+				return static_cast<T>(s);
+			}
+		};
+
+#if defined(__SIZEOF_INT128__)
+		__extension__ typedef unsigned __int128 uint128_t;
+		__extension__ typedef __int128 int128_t;
+#endif
+
+		// exact sum of values of 64 bits, in 128 bits: hi * 2^64 + lo
+		// Every addition changes hi by at most 1
+		template <typename T>
+		struct accumulator_sum<T, true> {
+			static const unsigned check_bits = 61;
+#if defined(__SIZEOF_INT128__)
+			uint128_t s = 0;
+
+			std::uint64_t lo() const noexcept { return static_cast<std::uint64_t>(s); }
+			std::uint64_t hi() const noexcept { return static_cast<std::uint64_t>(s >> 64); }
+			void add(const T v) noexcept {
+				s += uint128_t(int128_t(v));
+			}
+			void add(const accumulator_sum& other) noexcept {
+				s += other.s;
+			}
+#else
+			std::uint64_t l = 0;
+			std::uint64_t h = 0;
+
+			std::uint64_t lo() const noexcept { return l; }
+			std::uint64_t hi() const noexcept { return h; }
+			void add(const T v) noexcept {
+				const std::uint64_t u = std::uint64_t(v);
+				l += u;
+				// carry, and sign extension of v
+				h += std::uint64_t(l < u) - std::uint64_t(std::is_signed<T>::value && (u >> 63) != 0);
+			}
+			void add(const accumulator_sum& other) noexcept {
+				l += other.l;
+				h += other.h + std::uint64_t(l < other.l);
+			}
+#endif
+			bool in_zone() const noexcept {
+				return in_accumulator_zone(hi());
+			}
+			bool in_range() const noexcept {
+				// hi is the sign extension of lo (or 0 for unsigned types)
+				return hi() == ((std::is_signed<T>::value && (lo() >> 63) != 0) ? ~std::uint64_t(0) : std::uint64_t(0)) && word_in_range<T>(lo());
+			}
+			T get() const noexcept {
+				return static_cast<T>(lo());
+			}
+		};
+	} // end details
+}
+
+/// This class accumulates values of T, for example a counter updated by an event handler, without checking every
+/// addition: the values are added to a sum with more bits than T, and the sum is validated only when it is read.
+/// Like the mathematical sum, intermediate results that cannot be represented by T are not an error, if the final value
+/// can be represented.
+/// The internal sum (64 bits for types up to 32 bits, 128 bits for types of 64 bits) is checked only once every
+/// 2^(61-digits) additions (2^61 for types of 64 bits), when a wraparound could be possible: the hot path is an
+/// addition and a counter, without any throw path. If the internal sum exceeds 2^62 (in magnitude, far outside of the
+/// range of T) the accumulator becomes invalid.
+/// Accumulators of different threads can be combined with merge.
+///
+/// Example Usage:
+/// @code
+/// 	safe_accumulator<std::int32_t> received;
+/// 	void on_message(const message& m){
+/// 		received += m.size;
+/// 	}
+/// 	...
+/// 	safe_integral<std::int32_t> total = received.value(); // throws if the sum does not fit in 32 bits
+/// @endcode
+template <typename T>
+class safe_accumulator {
+		static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "T needs to be an integral type");
+		static_assert(std::numeric_limits<T>::digits <= 64, "unsupported type");
+	private:
+		using sum_type = safeintegralop::details::accumulator_sum<T>;
+		static const std::uint64_t check_period = std::uint64_t(1) << sum_type::check_bits;
+
+		sum_type sum;
+		std::uint64_t until_check = check_period;
+		bool overflow = false;
+
+		void check() noexcept {
+			until_check = check_period;
+			overflow = overflow || !sum.in_zone();
+		}
+
+	public:
+		/// Constructor
+		/// The sum is 0
+		safe_accumulator() noexcept = default;
+
+		/// Constructor
+		/// The sum is init
+		explicit safe_accumulator(const T init) noexcept {
+			sum.add(init);
+		}
+
+		/// Adds v to the sum, without any check
+		safe_accumulator& operator+=(const T v) noexcept {
+			sum.add(v);
+			if(--until_check == 0){
+				check();
+			}
+			return *this;
+		}
+
+		safe_accumulator& operator+=(const safe_integral<T> v) noexcept {
+			return *this += v.getvalue();
+		}
+
+		/// Adds the sum of other, for example the accumulator of another thread (other can be *this)
+		/// Example Usage:
+		/// @code
+		/// 	std::vector<safe_accumulator<std::int64_t>> per_thread = ...
+		/// 	safe_accumulator<std::int64_t> total;
+		/// 	for(const auto& a : per_thread){
+		/// 		total.merge(a);
+		/// 	}
+		/// @endcode
+		void merge(const safe_accumulator& other) noexcept {
+			const sum_type o = other.sum;
+			// both sums in [-2^62, 2^62): the sum of them does not wrap around
+			if(overflow || other.overflow || !sum.in_zone() || !o.in_zone()){
+				overflow = true;
+				return;
+			}
+			sum.add(o);
+			check();
+		}
+
+		/// Returns true if the sum can be represented by T
+		bool is_valid() const noexcept {
+			return !overflow && sum.in_range();
+		}
+
+		/// Returns the sum
+		/// If the sum cannot be represented by T, an exception is thrown
+		safe_integral<T> value() const {
+			return is_valid() ? safe_integral<T>(sum.get()) : throw std::out_of_range("overflow with safe_accumulator");
+		}
+};
+
+template <typename T>
+const std::uint64_t safe_accumulator<T>::check_period;
+
+#endif // SAFEINTEGRAL_SAFEACCUMULATOR_HPP
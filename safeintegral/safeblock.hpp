@@ -0,0 +1,382 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEBLOCK_HPP
+#define SAFEINTEGRAL_SAFEBLOCK_HPP
+
+#include "safeintegral.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// This class represents all values between min and max (included), and implements interval arithmetic.
+/// If an operation may overflow for some values of the operands, the resulting interval is not valid.
+/// Supported operations are +, -, *, / and unary -.
+///
+/// Usage:
+/// 	safe_interval<int>(-10, 10) * safe_interval<int>(0, 100) + 5 -> [-995, 1005]
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+class safe_interval {
+	private:
+		T lo;
+		T hi;
+		bool ok;
+
+		constexpr safe_interval(const T lo_, const T hi_, const bool ok_) noexcept : lo(lo_), hi(hi_), ok(ok_) {}
+
+		static constexpr safe_interval invalid() noexcept {
+			return safe_interval(T{0}, T{0}, false);
+		}
+
+		static constexpr T min2(const T a, const T b) noexcept { return a < b ? a : b; }
+		static constexpr T max2(const T a, const T b) noexcept { return a < b ? b : a; }
+
+		// if f is monotonic in both operands, the extremes are in the corners
+		static constexpr safe_interval corners(const T a, const T b, const T c, const T d) noexcept {
+			return safe_interval(min2(min2(a, b), min2(c, d)), max2(max2(a, b), max2(c, d)), true);
+		}
+
+		constexpr bool contains_zero() const noexcept {
+			return !(lo > T{0}) && !(hi < T{0});
+		}
+
+	public:
+		/// Interval that contains only v
+		constexpr safe_interval(const T v) noexcept : lo(v), hi(v), ok(true) {}
+
+		/// Interval that contains all values between min_ and max_
+		/// If min_ > max_, an exception is thrown
+		constexpr safe_interval(const T min_, const T max_) : lo(min_), hi(max_),
+		    ok(!(max_ < min_) ? true : throw std::out_of_range("safe_interval with min > max")) {}
+
+		constexpr T min() const noexcept { return lo; }
+		constexpr T max() const noexcept { return hi; }
+
+		/// false if an operation used for calculating this interval may overflow
+		constexpr bool is_valid() const noexcept { return ok; }
+
+		constexpr bool contains(const T v) const noexcept { return ok && !(v < lo) && !(hi < v); }
+
+		constexpr friend safe_interval operator+(const safe_interval lhs, const safe_interval rhs) noexcept {
+			return (lhs.ok && rhs.ok && safeintegralop::is_safe_add(lhs.lo, rhs.lo) && safeintegralop::is_safe_add(lhs.hi, rhs.hi)) ?
+			    safe_interval(T(lhs.lo + rhs.lo), T(lhs.hi + rhs.hi), true) : invalid();
+		}
+
+		constexpr friend safe_interval operator-(const safe_interval lhs, const safe_interval rhs) noexcept {
+			return (lhs.ok && rhs.ok && safeintegralop::is_safe_diff(lhs.lo, rhs.hi) && safeintegralop::is_safe_diff(lhs.hi, rhs.lo)) ?
+			    safe_interval(T(lhs.lo - rhs.hi), T(lhs.hi - rhs.lo), true) : invalid();
+		}
+
+		constexpr friend safe_interval operator*(const safe_interval lhs, const safe_interval rhs) noexcept {
+			return (lhs.ok && rhs.ok &&
+			        safeintegralop::is_safe_mult(lhs.lo, rhs.lo) && safeintegralop::is_safe_mult(lhs.lo, rhs.hi) &&
+			        safeintegralop::is_safe_mult(lhs.hi, rhs.lo) && safeintegralop::is_safe_mult(lhs.hi, rhs.hi)) ?
+			    corners(T(lhs.lo * rhs.lo), T(lhs.lo * rhs.hi), T(lhs.hi * rhs.lo), T(lhs.hi * rhs.hi)) : invalid();
+		}
+
+		constexpr friend safe_interval operator/(const safe_interval lhs, const safe_interval rhs) noexcept {
+			return (lhs.ok && rhs.ok && !rhs.contains_zero() &&
+			        safeintegralop::is_safe_div(lhs.lo, rhs.lo) && safeintegralop::is_safe_div(lhs.lo, rhs.hi) &&
+			        safeintegralop::is_safe_div(lhs.hi, rhs.lo) && safeintegralop::is_safe_div(lhs.hi, rhs.hi)) ?
+			    corners(T(lhs.lo / rhs.lo), T(lhs.lo / rhs.hi), T(lhs.hi / rhs.lo), T(lhs.hi / rhs.hi)) : invalid();
+		}
+
+		constexpr safe_interval operator-() const noexcept {
+			return (ok && safeintegralop::is_safe_diff(T{0}, lo) && safeintegralop::is_safe_diff(T{0}, hi)) ?
+			    safe_interval(T(T{0} - hi), T(T{0} - lo), true) : invalid();
+		}
+
+		constexpr safe_interval operator+() const noexcept {
+			return *this;
+		}
+};
+
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+constexpr safe_interval<T> make_safe_interval(const T min, const T max) {
+	return safe_interval<T>(min, max);
+}
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		template <typename T>
+		constexpr T raw_value(const T v) noexcept {
+			return v;
+		}
+
+		template <typename T>
+		constexpr T raw_value(const safe_integral<T> v) noexcept {
+			return v.getvalue();
+		}
+	} // end details
+
+	/// Returns true if f, evaluated with interval arithmetic, cannot overflow for any value of the operands in the intervals
+	/// f must be callable with raw values, safe_integral and safe_interval (for example a generic lambda), and use only the
+	/// operations supported by safe_interval
+	///
+	/// Example Usage:
+	/// @code
+	/// 	const auto f = [](auto a, auto b){ return a * b + a; };
+	/// 	if(is_safe_interval(f, column_a_stats, column_b_stats)){
+	/// 		// unchecked loop, with raw values
+	/// 	}
+	/// @endcode
+	template <typename F, typename... T>
+	constexpr bool is_safe_interval(const F& f, const safe_interval<T>... intervals) {
+		return f(intervals...).is_valid();
+	}
+
+	namespace details{
+		template <typename T, typename In>
+		safe_interval<T> minmax_interval(const In* first, const std::size_t count) {
+			if(count == 0){
+				throw std::out_of_range("minmax_interval of no values");
+			}
+			T lo = raw_value(first[0]);
+			T hi = lo;
+			// branch-free, can be vectorized
+			for(std::size_t i = 1; i != count; ++i){
+				const T v = raw_value(first[i]);
+				lo = v < lo ? v : lo;
+				hi = v < hi ? hi : v;
+			}
+			return safe_interval<T>(lo, hi);
+		}
+
+		// values are validated and transformed in blocks that fit in the L1 cache, so that every value is loaded from memory
+		// only once, and a single overflowing value does not disable the unchecked loop for all other values
+		constexpr std::size_t transform_block_size() noexcept {
+			return 2048;
+		}
+
+		template <typename T, typename In, typename Out, typename F>
+		std::size_t safe_transform(const In* first, const std::size_t count, Out* out, const F& f) {
+			for(std::size_t b = 0; b < count; b += transform_block_size()){
+				const std::size_t n = (count - b < transform_block_size()) ? count - b : transform_block_size();
+				if(is_safe_interval(f, minmax_interval<T>(first + b, n))){
+					for(std::size_t i = b; i != b + n; ++i){
+						out[i] = static_cast<T>(f(raw_value(first[i])));
+					}
+					continue;
+				}
+				std::size_t i = b;
+				try{
+					for(; i != b + n; ++i){
+						out[i] = raw_value(f(safe_integral<T>(first[i])));
+					}
+				} catch(const std::out_of_range&){
+					return i;
+				}
+			}
+			return count;
+		}
+
+		template <typename T, typename In, typename Out, typename F>
+		std::size_t safe_transform(const In* first1, const In* first2, const std::size_t count, Out* out, const F& f) {
+			for(std::size_t b = 0; b < count; b += transform_block_size()){
+				const std::size_t n = (count - b < transform_block_size()) ? count - b : transform_block_size();
+				if(is_safe_interval(f, minmax_interval<T>(first1 + b, n), minmax_interval<T>(first2 + b, n))){
+					for(std::size_t i = b; i != b + n; ++i){
+						out[i] = static_cast<T>(f(raw_value(first1[i]), raw_value(first2[i])));
+					}
+					continue;
+				}
+				std::size_t i = b;
+				try{
+					for(; i != b + n; ++i){
+						out[i] = raw_value(f(safe_integral<T>(first1[i]), safe_integral<T>(first2[i])));
+					}
+				} catch(const std::out_of_range&){
+					return i;
+				}
+			}
+			return count;
+		}
+
+		// the work of safe_transform_parallel is split in chunks of this size, and a worker checks for cancellation only
+		// between two chunks
+		constexpr std::size_t parallel_chunk_size() noexcept {
+			return 8 * transform_block_size();
+		}
+
+		// calls transform_chunk(begin, n) for all chunks of count values, the chunks are distributed to the threads in
+		// ascending order. When a chunk fails, the chunks after the lowest failing index are not started anymore: all chunks
+		// before it have been transformed, so the lowest failing index does not depend on the scheduling
+		template <typename F>
+		std::size_t safe_transform_parallel(const std::size_t count, unsigned threads, const F& transform_chunk) {
+			const std::size_t chunks = (count + parallel_chunk_size() - 1) / parallel_chunk_size();
+			threads = (chunks < threads) ? unsigned(chunks) : threads;
+			if(threads <= 1){
+				return transform_chunk(std::size_t{0}, count);
+			}
+			std::atomic<std::size_t> next_chunk(0);
+			std::atomic<std::size_t> first_failure(count);
+			std::exception_ptr error;
+			std::mutex error_mutex;
+			const auto fail = [&](const std::size_t i){
+				std::size_t current = first_failure.load();
+				while(i < current && !first_failure.compare_exchange_weak(current, i)){
+				}
+			};
+			const auto work = [&]{
+				for(;;){
+					const std::size_t begin = next_chunk.fetch_add(1) * parallel_chunk_size();
+					if(begin >= count || begin >= first_failure.load(std::memory_order_relaxed)){
+						return;
+					}
+					const std::size_t n = (count - begin < parallel_chunk_size()) ? count - begin : parallel_chunk_size();
+					try{
+						const std::size_t res = transform_chunk(begin, n);
+						if(res != n){
+							fail(begin + res);
+						}
+					} catch(...){
+						// not an overflow, rethrown by the calling thread
+						std::lock_guard<std::mutex> lock(error_mutex);
+						if(!error){
+							error = std::current_exception();
+						}
+						fail(begin);
+					}
+				}
+			};
+			std::vector<std::thread> workers;
+			workers.reserve(threads - 1);
+			for(unsigned t = 1; t != threads; ++t){
+				workers.emplace_back(work);
+			}
+			work();
+			for(auto& w : workers){
+				w.join();
+			}
+			if(error){
+				std::rethrow_exception(error);
+			}
+			return first_failure.load();
+		}
+	} // end details
+
+	/// Returns the smallest interval that contains the count values starting at first
+	/// If count is 0, an exception is thrown
+	template <typename T>
+	safe_interval<T> minmax_interval(const T* first, const std::size_t count) {
+		return details::minmax_interval<T>(first, count);
+	}
+
+	template <typename T>
+	safe_interval<T> minmax_interval(const safe_integral<T>* first, const std::size_t count) {
+		return details::minmax_interval<T>(first, count);
+	}
+
+	/// out[i] = f(first[i]) for the count values starting at first (out may be equal to first)
+	/// The values are processed in blocks. The minimum and maximum values of every block are searched first, if f is safe for
+	/// all values in that interval, f is evaluated with raw values and without any check, otherwise with safe_integral.
+	/// Returns the index of the first value for which f overflows (its result, and the following, are not written),
+	/// or count if all values have been transformed
+	///
+	/// Example Usage:
+	/// @code
+	/// 	safe_transform(a.data(), b.data(), a.size(), out.data(), [](auto a, auto b){ return a * b + a; });
+	/// @endcode
+	template <typename T, typename F>
+	std::size_t safe_transform(const T* first, const std::size_t count, T* out, const F& f) {
+		return details::safe_transform<T>(first, count, out, f);
+	}
+
+	/// out[i] = f(first1[i], first2[i]) for the count values starting at first1 and first2
+	/// Like the unary version
+	template <typename T, typename F>
+	std::size_t safe_transform(const T* first1, const T* first2, const std::size_t count, T* out, const F& f) {
+		return details::safe_transform<T>(first1, first2, count, out, f);
+	}
+
+	/// Like safe_transform, but the values are split in chunks, transformed by threads workers. When f overflows, the
+	/// workers stop after their current chunk, and the lowest overflowing index is returned (the same index of
+	/// safe_transform, for every scheduling of the chunks). The values after it may have been written too.
+	/// f is called concurrently by the workers. If f throws an exception that is not std::out_of_range, the exception is
+	/// rethrown after all workers have stopped.
+	///
+	/// Example Usage:
+	/// @code
+	/// 	const auto i = safe_transform_parallel(a.data(), b.data(), a.size(), out.data(), [](auto a, auto b){ return a * b + a; });
+	/// 	if(i != a.size()){
+	/// 		// a[i] * b[i] + a[i] overflows
+	/// 	}
+	/// @endcode
+	template <typename T, typename F>
+	std::size_t safe_transform_parallel(const T* first, const std::size_t count, T* out, const F& f,
+	                                    const unsigned threads = std::thread::hardware_concurrency()) {
+		return details::safe_transform_parallel(count, threads, [&](const std::size_t begin, const std::size_t n){
+			return details::safe_transform<T>(first + begin, n, out + begin, f);
+		});
+	}
+
+	template <typename T, typename F>
+	std::size_t safe_transform_parallel(const T* first1, const T* first2, const std::size_t count, T* out, const F& f,
+	                                    const unsigned threads = std::thread::hardware_concurrency()) {
+		return details::safe_transform_parallel(count, threads, [&](const std::size_t begin, const std::size_t n){
+			return details::safe_transform<T>(first1 + begin, first2 + begin, n, out + begin, f);
+		});
+	}
+
+	/// Like safe_transform with raw values, but an exception is thrown if f overflows, after all preceding values have been
+	/// transformed
+	template <typename T, typename F>
+	void safe_transform(const safe_integral<T>* first, const std::size_t count, safe_integral<T>* out, const F& f) {
+		if(details::safe_transform<T>(first, count, out, f) != count){
+			throw std::out_of_range("overflow with safe_transform");
+		}
+	}
+
+	template <typename T, typename F>
+	void safe_transform(const safe_integral<T>* first1, const safe_integral<T>* first2, const std::size_t count, safe_integral<T>* out, const F& f) {
+		if(details::safe_transform<T>(first1, first2, count, out, f) != count){
+			throw std::out_of_range("overflow with safe_transform");
+		}
+	}
+
+	/// Like safe_transform_parallel with raw values, but an exception is thrown if f overflows
+	template <typename T, typename F>
+	void safe_transform_parallel(const safe_integral<T>* first, const std::size_t count, safe_integral<T>* out, const F& f,
+	                             const unsigned threads = std::thread::hardware_concurrency()) {
+		const auto res = details::safe_transform_parallel(count, threads, [&](const std::size_t begin, const std::size_t n){
+			return details::safe_transform<T>(first + begin, n, out + begin, f);
+		});
+		if(res != count){
+			throw std::out_of_range("overflow with safe_transform_parallel");
+		}
+	}
+
+	template <typename T, typename F>
+	void safe_transform_parallel(const safe_integral<T>* first1, const safe_integral<T>* first2, const std::size_t count, safe_integral<T>* out,
+	                             const F& f, const unsigned threads = std::thread::hardware_concurrency()) {
+		const auto res = details::safe_transform_parallel(count, threads, [&](const std::size_t begin, const std::size_t n){
+			return details::safe_transform<T>(first1 + begin, first2 + begin, n, out + begin, f);
+		});
+		if(res != count){
+			throw std::out_of_range("overflow with safe_transform_parallel");
+		}
+	}
+}
+
+#endif // SAFEINTEGRAL_SAFEBLOCK_HPP
@@ -0,0 +1,100 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEBUFFER_HPP
+#define SAFEINTEGRAL_SAFEBUFFER_HPP
+
+#include "safeintegral.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// default-initialization, the value of integral types is not initialized
+		template <typename U>
+		void default_construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+			::new(static_cast<void*>(p)) U;
+		}
+
+		template <typename T>
+		void default_construct(safe_integral<T>* p) noexcept {
+			::new(static_cast<void*>(p)) safe_integral<T>(safe_uninitialized);
+		}
+	} // end details
+}
+
+/// Allocator that default-initializes the elements instead of value-initializing them, and does not initialize the value
+/// of safe_integral. All other constructions are forwarded to A.
+/// Creating or resizing a container with this allocator does not write the new elements, they need to be assigned before
+/// being read.
+///
+/// Example Usage:
+/// @code
+/// 	std::vector<safe_int, default_init_allocator<safe_int>> v(size); // no memset
+/// 	std::fill(v.begin(), v.end(), 42);
+/// @endcode
+template <typename T, typename A = std::allocator<T>>
+class default_init_allocator : public A {
+	private:
+		using traits = std::allocator_traits<A>;
+	public:
+		template <typename U>
+		struct rebind {
+			using other = default_init_allocator<U, typename traits::template rebind_alloc<U>>;
+		};
+
+		using A::A;
+
+		default_init_allocator() = default;
+
+		// converting constructor, required for rebinding
+		template <typename U, typename B>
+		default_init_allocator(const default_init_allocator<U, B>& other) noexcept : A(other) {}
+
+		template <typename U>
+		void construct(U* p) noexcept(noexcept(safeintegralop::details::default_construct(p))) {
+			safeintegralop::details::default_construct(p);
+		}
+
+		template <typename U, typename... Args>
+		void construct(U* p, Args&&... args) {
+			traits::construct(static_cast<A&>(*this), p, std::forward<Args>(args)...);
+		}
+};
+
+/// Vector whose new elements are not initialized
+template <typename T>
+using uninitialized_vector = std::vector<T, default_init_allocator<T>>;
+
+/// Creates a buffer of count elements, without initializing them
+/// Example Usage:
+/// @code
+/// 	auto buffer = make_uninitialized<safe_int>(1 << 28);
+/// 	read_from_file(buffer.data(), buffer.size());
+/// @endcode
+template <typename T>
+uninitialized_vector<T> make_uninitialized(const std::size_t count) {
+	return uninitialized_vector<T>(count);
+}
+
+#endif // SAFEINTEGRAL_SAFEBUFFER_HPP
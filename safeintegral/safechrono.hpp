@@ -0,0 +1,225 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFECHRONO_HPP
+#define SAFEINTEGRAL_SAFECHRONO_HPP
+
+#include "safeintegral.hpp"
+#include "safeblock.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+
+// safe_integral<T> as rep of std::chrono::duration: every operation of the durations (also the conversions with
+// std::chrono::duration_cast, and the implicit conversions between durations) is checked, and throws std::out_of_range on
+// overflow.
+// Example Usage:
+// @code
+// 	using safe_nanoseconds = std::chrono::duration<safe_integral<std::int64_t>, std::nano>;
+// 	const auto d = safe_nanoseconds(t1) - safe_nanoseconds(t0);
+// @endcode
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// the integral type of a rep of std::chrono::duration
+		template <typename T>
+		struct duration_raw {
+			using type = T;
+		};
+
+		template <typename T>
+		struct duration_raw<safe_integral<T>> {
+			using type = T;
+		};
+
+		// the common type of safe_integral<T> and U is defined only if U is an integral type
+		template <typename T, typename U, bool = std::is_integral<U>::value && !std::is_same<U, bool>::value>
+		struct safe_common_type {};
+
+		template <typename T, typename U>
+		struct safe_common_type<T, U, true> {
+			using type = safe_integral<typename std::common_type<T, U>::type>;
+		};
+
+		template <typename T>
+		constexpr T max3(const T a, const T b, const T c) noexcept {
+			return (a < b) ? ((b < c) ? c : b) : ((a < c) ? c : a);
+		}
+
+		template <typename T>
+		constexpr T min3(const T a, const T b, const T c) noexcept {
+			return (b < a) ? ((c < b) ? c : b) : ((c < a) ? c : a);
+		}
+
+		// std::chrono::duration_cast computes count * num / den with the common type of both reps and std::intmax_t.
+		// [lo, hi] are the counts of the duration From for which this product does not overflow, and the result is
+		// representable by To. They are computed at compile time, a conversion needs one range comparison.
+		template <typename From, typename To, typename Ratio>
+		struct duration_cast_limits {
+			using CR = typename std::common_type<From, To, std::intmax_t>::type;
+			static constexpr CR num = static_cast<CR>(Ratio::num);
+			static constexpr CR den = static_cast<CR>(Ratio::den);
+
+			// v * num <= max, and v * num / den <= max of To: v * num <= max of To * den + den - 1 (if representable)
+			static constexpr CR mul_max = std::numeric_limits<CR>::max() / num;
+			static constexpr CR to_max = static_cast<CR>(std::numeric_limits<To>::max());
+			static constexpr CR div_max = (to_max <= (std::numeric_limits<CR>::max() - (den - 1)) / den) ? (to_max * den + (den - 1)) / num : mul_max;
+			static constexpr CR hi_cr = min3(mul_max, div_max, static_cast<CR>(std::numeric_limits<From>::max()));
+
+			// the same for the negative values (the division truncates toward zero, like the ceil of negative values).
+			// If CR is unsigned, the negative values are not supported
+			static constexpr CR mul_min = std::numeric_limits<CR>::min() / num;
+			static constexpr CR to_min = std::is_signed<CR>::value ? static_cast<CR>(std::numeric_limits<To>::min()) : CR{0};
+			static constexpr CR div_min = !std::is_signed<CR>::value ? CR{0} :
+			    (to_min >= (std::numeric_limits<CR>::min() + (den - 1)) / den) ? (to_min * den - (den - 1)) / num : mul_min;
+			static constexpr CR lo_cr = !std::is_signed<CR>::value ? CR{0} :
+			    max3(mul_min, div_min, static_cast<CR>(std::numeric_limits<From>::min()));
+
+			static constexpr From lo = static_cast<From>(lo_cr);
+			static constexpr From hi = static_cast<From>(hi_cr);
+
+			static constexpr bool valid(const From v) noexcept {
+				return !(v < lo) && !(hi < v);
+			}
+
+			// the same result of std::chrono::duration_cast, v needs to be valid
+			static constexpr To convert(const From v) noexcept {
+				return static_cast<To>(static_cast<CR>(static_cast<CR>(v) * num) / den);
+			}
+		};
+
+		// converts count values, read with get(i) and written with put(i, v), in blocks: if all values of a block are
+		// inside the limits (checked without branches, so that the check can be vectorized), they are converted without
+		// checks. Returns the index of the first value that cannot be converted, or count
+		template <typename Limits, typename Get, typename Put>
+		std::size_t safe_duration_cast_n(const std::size_t count, const Get& get, const Put& put) {
+			for(std::size_t b = 0; b < count; b += transform_block_size()){
+				const std::size_t n = (count - b < transform_block_size()) ? count - b : transform_block_size();
+				bool valid = true;
+				for(std::size_t i = b; i != b + n; ++i){
+					valid &= Limits::valid(get(i));
+				}
+				if(!valid){
+					for(std::size_t i = b; i != b + n; ++i){
+						if(!Limits::valid(get(i))){
+							return i;
+						}
+						put(i, Limits::convert(get(i)));
+					}
+					continue;
+				}
+				for(std::size_t i = b; i != b + n; ++i){
+					put(i, Limits::convert(get(i)));
+				}
+			}
+			return count;
+		}
+	} // end details
+
+	/// Converts a duration to ToDuration, with the same result of std::chrono::duration_cast (the fractional part is
+	/// truncated). The reps of both durations can be integral types or safe_integral.
+	/// If the result is not representable by the rep of ToDuration, or the conversion overflows, an exception is thrown.
+	/// The range of the counts that can be converted is computed at compile time: unlike std::chrono::duration_cast with
+	/// safe_integral reps, that checks the multiplication and the division, the conversion needs a range comparison.
+	///
+	/// Example Usage:
+	/// @code
+	/// 	const auto ns = safe_duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(s)); // throws if s * 10^9 overflows
+	/// @endcode
+	template <typename ToDuration, typename Rep, typename Period>
+	constexpr ToDuration safe_duration_cast(const std::chrono::duration<Rep, Period> d) {
+		using limits = details::duration_cast_limits<typename details::duration_raw<Rep>::type, typename details::duration_raw<typename ToDuration::rep>::type,
+		                                             typename std::ratio_divide<Period, typename ToDuration::period>::type>;
+		return limits::valid(details::raw_value(d.count())) ?
+		    ToDuration(typename ToDuration::rep(limits::convert(details::raw_value(d.count())))) :
+		    throw std::out_of_range("overflow with safe_duration_cast");
+	}
+
+	/// Converts count durations to ToDuration, like safe_duration_cast, for example a column of timestamps.
+	/// Returns the index of the first duration that cannot be converted (the durations before it are converted, and the
+	/// following are not written), or count if all durations have been converted.
+	///
+	/// Example Usage:
+	/// @code
+	/// 	std::vector<std::chrono::duration<safe_integral<std::int64_t>, std::nano>> ns = ...
+	/// 	std::vector<std::chrono::microseconds> us(ns.size());
+	/// 	if(safe_duration_cast(ns.data(), ns.size(), us.data()) != ns.size()){
+	/// 		// overflow
+	/// 	}
+	/// @endcode
+	template <typename ToDuration, typename Rep, typename Period>
+	std::size_t safe_duration_cast(const std::chrono::duration<Rep, Period>* first, const std::size_t count, ToDuration* out) {
+		using From = typename details::duration_raw<Rep>::type;
+		using To = typename details::duration_raw<typename ToDuration::rep>::type;
+		using limits = details::duration_cast_limits<From, To, typename std::ratio_divide<Period, typename ToDuration::period>::type>;
+		return details::safe_duration_cast_n<limits>(count, [first](const std::size_t i){ return details::raw_value(first[i].count()); },
+		                                             [out](const std::size_t i, const To v){ out[i] = ToDuration(typename ToDuration::rep(v)); });
+	}
+
+	/// Like the safe_duration_cast of durations, but the counts of the durations are stored as integral values (or
+	/// safe_integral), for example the nanoseconds of the timestamps of a binary file.
+	///
+	/// Example Usage:
+	/// @code
+	/// 	std::vector<std::int64_t> ns = ...
+	/// 	std::vector<std::int32_t> s(ns.size());
+	/// 	const auto i = safe_duration_count_cast<std::chrono::duration<std::int32_t>, std::chrono::nanoseconds>(ns.data(), ns.size(), s.data());
+	/// @endcode
+	template <typename ToDuration, typename FromDuration>
+	std::size_t safe_duration_count_cast(const typename FromDuration::rep* first, const std::size_t count, typename ToDuration::rep* out) {
+		using From = typename details::duration_raw<typename FromDuration::rep>::type;
+		using To = typename details::duration_raw<typename ToDuration::rep>::type;
+		using limits = details::duration_cast_limits<From, To, typename std::ratio_divide<typename FromDuration::period, typename ToDuration::period>::type>;
+		return details::safe_duration_cast_n<limits>(count, [first](const std::size_t i){ return details::raw_value(first[i]); },
+		                                             [out](const std::size_t i, const To v){ out[i] = typename ToDuration::rep(v); });
+	}
+}
+
+namespace std {
+	namespace chrono {
+		/// safe_integral is not a floating point type: the durations are converted implicitly only without loss of precision
+		template <typename T>
+		struct treat_as_floating_point<safe_integral<T>> : std::false_type {};
+
+		/// The limits of the durations with a safe_integral rep are those of T
+		template <typename T>
+		struct duration_values<safe_integral<T>> {
+			static constexpr safe_integral<T> zero() noexcept { return safe_integral<T>(T{0}); }
+			static constexpr safe_integral<T> min() noexcept { return safe_integral<T>(std::numeric_limits<T>::lowest()); }
+			static constexpr safe_integral<T> max() noexcept { return safe_integral<T>(std::numeric_limits<T>::max()); }
+		};
+	}
+
+	/// The common type of safe_integral<T> and safe_integral<U>, or of safe_integral<T> and an integral type U, is
+	/// safe_integral of the common type of T and U (for example for the ratio conversions of std::chrono::duration_cast)
+	template <typename T, typename U>
+	struct common_type<safe_integral<T>, safe_integral<U>> : safeintegralop::details::safe_common_type<T, U> {};
+
+	template <typename T, typename U>
+	struct common_type<safe_integral<T>, U> : safeintegralop::details::safe_common_type<T, U> {};
+
+	template <typename T, typename U>
+	struct common_type<U, safe_integral<T>> : safeintegralop::details::safe_common_type<T, U> {};
+}
+
+#endif // SAFEINTEGRAL_SAFECHRONO_HPP
@@ -0,0 +1,288 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFECOLUMN_HPP
+#define SAFEINTEGRAL_SAFECOLUMN_HPP
+
+#include "safeintegral.hpp"
+#include "safeblock.hpp"
+#include "saferange.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// stores v - base for the count values starting at first, as W
+		template <typename W, typename T>
+		void encode_offsets(const T* first, const std::size_t count, const T base, unsigned char* out) noexcept {
+			using U = typename std::make_unsigned<T>::type;
+			for(std::size_t i = 0; i != count; ++i){
+				const W w = W(U(U(first[i]) - U(base)));
+				std::memcpy(out + i * sizeof(W), &w, sizeof(W));
+			}
+		}
+
+		template <typename W, typename T>
+		void decode_offsets(const unsigned char* in, const std::size_t count, const T base, T* out) noexcept {
+			using U = typename std::make_unsigned<T>::type;
+			for(std::size_t i = 0; i != count; ++i){
+				W w;
+				std::memcpy(&w, in + i * sizeof(W), sizeof(W));
+				out[i] = from_unsigned<T>(U(U(base) + U(w)));
+			}
+		}
+
+		// number of bytes of the narrowest unsigned type that can represent range: 0, 1, 2, 4 or 8
+		inline unsigned char offset_width(const std::uint64_t range) noexcept {
+			return (range == 0) ? 0 : (range <= 0xFFu) ? 1 : (range <= 0xFFFFu) ? 2 : (range <= 0xFFFFFFFFu) ? 4 : 8;
+		}
+
+		inline std::uint64_t max_offset(const unsigned char width) noexcept {
+			return (width == 8) ? ~std::uint64_t{0} : (std::uint64_t{1} << (8 * width)) - 1;
+		}
+	} // end details
+}
+
+/// This class is a column of integrals, stored in blocks with the frame-of-reference encoding: every block stores its
+/// minimum (the base), and the difference of every value from the base with the narrowest unsigned type (0, 1, 2, 4 or 8
+/// bytes per value). A column of counters of type std::int64_t with similar values needs thus 1/4 or 1/8 of the memory.
+/// The values are read as safe_integral<T>. Writing a value that does not fit in the encoding of its block (smaller than
+/// the base, or too far from it) re-encodes the whole block.
+///
+/// Example Usage:
+/// @code
+/// 	safe_column<std::int64_t> counters(raw.data(), raw.size());
+/// 	counters[i] += 1; // throws on overflow, re-encodes the block if needed
+/// 	safe_integral<std::int64_t> total = counters[0].get() + counters[1];
+/// @endcode
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+class safe_column {
+	public:
+		using value_type = safe_integral<T>;
+		using size_type = std::size_t;
+		/// number of values of every block, but the last
+		static const size_type block_size = 1024;
+
+	private:
+		using U = typename std::make_unsigned<T>::type;
+		struct block {
+			T base;
+			unsigned char width;
+			std::vector<unsigned char> data;
+		};
+		std::vector<block> blocks;
+		size_type count;
+
+		size_type block_count(const size_type b) const noexcept {
+			return (count - b * block_size < block_size) ? count - b * block_size : block_size;
+		}
+
+		// the values are read with the width of the block, at most sizeof(T)
+		static void decode_block(const block& b, const size_type first, const size_type n, T* out) noexcept {
+			switch(b.width){
+				case 0: for(size_type i = 0; i != n; ++i){ out[i] = b.base; } break;
+				case 1: safeintegralop::details::decode_offsets<std::uint8_t>(b.data.data() + first, n, b.base, out); break;
+				case 2: safeintegralop::details::decode_offsets<std::uint16_t>(b.data.data() + 2 * first, n, b.base, out); break;
+				case 4: safeintegralop::details::decode_offsets<std::uint32_t>(b.data.data() + 4 * first, n, b.base, out); break;
+				default: safeintegralop::details::decode_offsets<std::uint64_t>(b.data.data() + 8 * first, n, b.base, out); break;
+			}
+		}
+
+		static void encode_block(block& b, const T* values, const size_type n) {
+			const safe_interval<T> r = safeintegralop::details::minmax_interval<T>(values, n);
+			b.base = r.min();
+			b.width = safeintegralop::details::offset_width(U(U(r.max()) - U(r.min())));
+			std::vector<unsigned char>(n * b.width).swap(b.data);
+			switch(b.width){
+				case 0: break;
+				case 1: safeintegralop::details::encode_offsets<std::uint8_t>(values, n, b.base, b.data.data()); break;
+				case 2: safeintegralop::details::encode_offsets<std::uint16_t>(values, n, b.base, b.data.data()); break;
+				case 4: safeintegralop::details::encode_offsets<std::uint32_t>(values, n, b.base, b.data.data()); break;
+				default: safeintegralop::details::encode_offsets<std::uint64_t>(values, n, b.base, b.data.data()); break;
+			}
+		}
+
+		// true if v can be written in the block without changing its encoding
+		static bool fits(const block& b, const T v) noexcept {
+			return !(v < b.base) && U(U(v) - U(b.base)) <= safeintegralop::details::max_offset(b.width);
+		}
+
+		static void write(block& b, const size_type i, const T v) noexcept {
+			const U off = U(U(v) - U(b.base));
+			switch(b.width){
+				case 0: break;
+				case 1: { const std::uint8_t w = std::uint8_t(off); std::memcpy(b.data.data() + i, &w, 1); break; }
+				case 2: { const std::uint16_t w = std::uint16_t(off); std::memcpy(b.data.data() + 2 * i, &w, 2); break; }
+				case 4: { const std::uint32_t w = std::uint32_t(off); std::memcpy(b.data.data() + 4 * i, &w, 4); break; }
+				default: { const std::uint64_t w = std::uint64_t(off); std::memcpy(b.data.data() + 8 * i, &w, 8); break; }
+			}
+		}
+
+	public:
+		class reference {
+			private:
+				safe_column* c;
+				size_type i;
+				friend class safe_column;
+				constexpr reference(safe_column* c_, const size_type i_) noexcept : c(c_), i(i_) {}
+			public:
+				reference(const reference&) noexcept = default;
+
+				/// Returns the value of the element
+				T getvalue() const noexcept { return c->get(i).getvalue(); }
+				value_type get() const noexcept { return c->get(i); }
+				operator value_type() const noexcept { return c->get(i); }
+
+				reference& operator=(const value_type rhs) { c->set(i, rhs); return *this; }
+				// assigns the value, not the reference
+				reference& operator=(const reference& rhs) { return *this = rhs.get(); }
+
+				reference& operator+=(const value_type rhs) { return *this = get() + rhs; }
+				reference& operator-=(const value_type rhs) { return *this = get() - rhs; }
+				reference& operator*=(const value_type rhs) { return *this = get() * rhs; }
+				reference& operator/=(const value_type rhs) { return *this = get() / rhs; }
+				reference& operator%=(const value_type rhs) { return *this = get() % rhs; }
+				reference& operator++() { return *this = get() + value_type(1); }
+				reference& operator--() { return *this = get() - value_type(1); }
+
+				friend bool operator==(const reference lhs, const value_type rhs) noexcept { return lhs.get() == rhs; }
+				friend bool operator!=(const reference lhs, const value_type rhs) noexcept { return lhs.get() != rhs; }
+				friend bool operator<(const reference lhs, const value_type rhs) noexcept { return lhs.get() < rhs; }
+				friend bool operator>(const reference lhs, const value_type rhs) noexcept { return lhs.get() > rhs; }
+				friend bool operator<=(const reference lhs, const value_type rhs) noexcept { return lhs.get() <= rhs; }
+				friend bool operator>=(const reference lhs, const value_type rhs) noexcept { return lhs.get() >= rhs; }
+		};
+
+		safe_column() noexcept : count(0) {}
+		/// Constructor
+		/// Encodes the count values starting at first
+		safe_column(const T* first, const size_type count_) : count(0) { append(first, count_); }
+
+		constexpr size_type size() const noexcept { return count; }
+		constexpr bool empty() const noexcept { return count == 0; }
+
+		/// Returns the number of bytes used by the encoded values (without the bookkeeping of every block)
+		size_type encoded_bytes() const noexcept {
+			size_type res = 0;
+			for(const auto& b : blocks){
+				res += b.data.size();
+			}
+			return res;
+		}
+
+		/// Returns the number of bytes used for every value of the block that contains the element i (0 if all values of the block are equal)
+		unsigned width(const size_type i) const noexcept { return blocks[i / block_size].width; }
+
+		value_type get(const size_type i) const noexcept {
+			T v;
+			decode_block(blocks[i / block_size], i % block_size, 1, &v);
+			return value_type(v);
+		}
+
+		/// Writes v, if it does not fit in the encoding of its block the block is re-encoded
+		void set(const size_type i, const value_type v) {
+			block& b = blocks[i / block_size];
+			if(fits(b, v.getvalue())){
+				write(b, i % block_size, v.getvalue());
+				return;
+			}
+			const size_type n = block_count(i / block_size);
+			std::vector<T> values(n);
+			decode_block(b, 0, n, values.data());
+			values[i % block_size] = v.getvalue();
+			encode_block(b, values.data(), n);
+		}
+
+		value_type operator[](const size_type i) const noexcept { return get(i); }
+		reference operator[](const size_type i) noexcept { return reference(this, i); }
+
+		/// Same as operator[], but throws if i is not a valid index
+		value_type at(const size_type i) const {
+			if(i >= count){
+				throw std::out_of_range("safe_column index out of range");
+			}
+			return get(i);
+		}
+		reference at(const size_type i) {
+			if(i >= count){
+				throw std::out_of_range("safe_column index out of range");
+			}
+			return reference(this, i);
+		}
+
+		/// Writes the n values starting at the element first to out
+		/// If the range is not valid, an exception is thrown
+		void decode(const size_type first, const size_type n, T* out) const {
+			if(first > count || n > count - first){
+				throw std::out_of_range("safe_column decode out of range");
+			}
+			for(size_type i = first; i != first + n;){
+				const size_type b = i / block_size;
+				const size_type m = (first + n - i < block_count(b) - i % block_size) ? first + n - i : block_count(b) - i % block_size;
+				decode_block(blocks[b], i % block_size, m, out + (i - first));
+				i += m;
+			}
+		}
+
+		/// Appends the n values starting at first, the last block is filled before creating new blocks
+		void append(const T* first, size_type n) {
+			if(n != 0 && count % block_size != 0){
+				// the last block is not full, it is re-encoded with the new values
+				block& b = blocks.back();
+				const size_type old = count % block_size;
+				const size_type m = (n < block_size - old) ? n : block_size - old;
+				std::vector<T> values(old + m);
+				decode_block(b, 0, old, values.data());
+				std::memcpy(values.data() + old, first, m * sizeof(T));
+				encode_block(b, values.data(), old + m);
+				count += m;
+				first += m;
+				n -= m;
+			}
+			for(; n != 0;){
+				const size_type m = (n < block_size) ? n : block_size;
+				blocks.emplace_back();
+				encode_block(blocks.back(), first, m);
+				count += m;
+				first += m;
+				n -= m;
+			}
+		}
+
+		void push_back(const value_type v) {
+			if(count % block_size != 0 && fits(blocks.back(), v.getvalue())){
+				block& b = blocks.back();
+				b.data.resize(b.data.size() + b.width);
+				write(b, count % block_size, v.getvalue());
+				++count;
+				if(count % block_size == 0){
+					b.data.shrink_to_fit();
+				}
+				return;
+			}
+			const T raw = v.getvalue();
+			append(&raw, 1);
+		}
+};
+
+#endif // SAFEINTEGRAL_SAFECOLUMN_HPP
@@ -0,0 +1,287 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEDIVIDER_HPP
+#define SAFEINTEGRAL_SAFEDIVIDER_HPP
+
+#include "safeintegral.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+#if defined(__SIZEOF_INT128__)
+		__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+		// high half of the product a*b
+		inline std::uint64_t mulhi(const std::uint64_t a, const std::uint64_t b, std::true_type) noexcept {
+#if defined(__SIZEOF_INT128__)
+			return static_cast<std::uint64_t>((uint128_t(a) * b) >> 64);
+#else
+			const std::uint64_t a_lo = a & 0xffffffffu, a_hi = a >> 32;
+			const std::uint64_t b_lo = b & 0xffffffffu, b_hi = b >> 32;
+			const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+			const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffu) + lo_hi;
+			return (cross >> 32) + (hi_lo >> 32) + hi_hi;
+#endif
+		}
+
+		template <typename U>
+		inline U mulhi(const U a, const U b, std::false_type) noexcept {
+			return static_cast<U>((std::uint64_t(a) * b) >> std::numeric_limits<U>::digits);
+		}
+
+		template <typename U>
+		inline U mulhi(const U a, const U b) noexcept {
+			static_assert(std::numeric_limits<U>::digits <= 64, "unsupported type");
+			return static_cast<U>(mulhi(a, b, std::integral_constant<bool, (std::numeric_limits<U>::digits > 32)>{}));
+		}
+
+		// floor(2^(digits(U)+l) / d) and the remainder, for d > 2^l (the quotient fits in U)
+		inline std::uint64_t div_wide(const unsigned l, const std::uint64_t d, std::uint64_t& rem, std::true_type) noexcept {
+#if defined(__SIZEOF_INT128__)
+			const uint128_t n = uint128_t(1) << (64 + l);
+			rem = static_cast<std::uint64_t>(n % d);
+			return static_cast<std::uint64_t>(n / d);
+#else
+			// long division of (2^l, 0) by d, one bit at a time. Executed only once for every divider
+			std::uint64_t hi = std::uint64_t(1) << l, q = 0;
+			for(int i = 0; i != 64; ++i){
+				const bool carry = (hi >> 63) != 0;
+				hi <<= 1;
+				q <<= 1;
+				if(carry || hi >= d){
+					hi -= d;
+					q |= 1;
+				}
+			}
+			rem = hi;
+			return q;
+#endif
+		}
+
+		template <typename U>
+		inline U div_wide(const unsigned l, const U d, U& rem, std::false_type) noexcept {
+			const std::uint64_t n = std::uint64_t(1) << (std::numeric_limits<U>::digits + l);
+			rem = static_cast<U>(n % d);
+			return static_cast<U>(n / d);
+		}
+
+		template <typename U>
+		inline U div_wide(const unsigned l, const U d, U& rem) noexcept {
+			static_assert(std::numeric_limits<U>::digits <= 64, "unsupported type");
+			using Tw = typename std::conditional<(std::numeric_limits<U>::digits > 32), std::uint64_t, U>::type;
+			Tw r = 0;
+			const U q = static_cast<U>(div_wide(l, Tw(d), r, std::integral_constant<bool, (std::numeric_limits<U>::digits > 32)>{}));
+			rem = static_cast<U>(r);
+			return q;
+		}
+
+		template <typename U>
+		inline unsigned floor_log2(U v) noexcept {
+			unsigned l = 0;
+			while(v >>= 1){
+				++l;
+			}
+			return l;
+		}
+	} // end details
+}
+
+/// This class divides many values by the same (runtime) divisor, without using a division instruction.
+/// The divisor is validated once, when constructing the object, and a "magic number" is precomputed, every division is
+/// then a multiplication (high half) and some shifts, like a division by a compile-time constant.
+/// Like safe_integral, an exception is thrown if the operation is not valid (division by 0, min/-1).
+///
+/// Example Usage:
+/// @code
+/// 	const auto by_width = safe_divider<int>(width);
+/// 	for(auto& v : values){
+/// 		v = v / by_width;
+/// 	}
+/// @endcode
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+class safe_divider {
+	private:
+		using U = typename std::make_unsigned<T>::type;
+		enum class algo : unsigned char { shift, mulhi, mulhi_add };
+
+		U d;                  // |divisor|
+		U magic = 0;
+		unsigned char shift = 0;
+		algo a = algo::shift;
+		bool negative = false; // divisor < 0
+
+		// |n| / |d|
+		template <algo A>
+		U divide_magnitude(const U n) const noexcept {
+			return
+			    (A == algo::shift) ? U(n >> shift) :
+			    (A == algo::mulhi) ? U(safeintegralop::details::mulhi(magic, n) >> shift) :
+			    U((U(U(n - safeintegralop::details::mulhi(magic, n)) >> 1) + safeintegralop::details::mulhi(magic, n)) >> shift);
+		}
+
+		static T apply_sign(const U m, const bool neg) noexcept {
+			// -T(m-1)-1 avoids overflow if m == |min|
+			return (neg && m != U{0}) ? T(-T(m-1)-1) : T(m);
+		}
+
+		// min/-1 is the only division that can fail
+		bool may_fail() const noexcept {
+			return std::is_signed<T>::value && negative && d == U{1};
+		}
+
+		bool is_safe(const T n) const noexcept {
+			return !may_fail() || n != std::numeric_limits<T>::min();
+		}
+
+		// quotient (or remainder if Rem), n is a valid dividend
+		template <algo A, bool Rem>
+		T divide_unchecked(const T n) const noexcept {
+			return Rem ?
+			    apply_sign(U(safeintegralop::details::safe_abs(n) - U(divide_magnitude<A>(safeintegralop::details::safe_abs(n)) * d)), n < T{0}) :
+			    apply_sign(divide_magnitude<A>(safeintegralop::details::safe_abs(n)), (n < T{0}) != negative);
+		}
+
+		template <bool Rem>
+		T divide_unchecked(const T n) const noexcept {
+			return
+			    (a == algo::shift) ? divide_unchecked<algo::shift, Rem>(n) :
+			    (a == algo::mulhi) ? divide_unchecked<algo::mulhi, Rem>(n) :
+			    divide_unchecked<algo::mulhi_add, Rem>(n);
+		}
+
+		static T value(const T v) noexcept {
+			return v;
+		}
+
+		static T value(const safe_integral<T> v) noexcept {
+			return v.getvalue();
+		}
+
+		// the loop does not contain any check or branch, and can be vectorized
+		template <algo A, bool Rem, typename In, typename Out>
+		void transform_unchecked(const In* first, const std::size_t count, Out* out) const noexcept {
+			for(std::size_t i = 0; i != count; ++i){
+				out[i] = divide_unchecked<A, Rem>(value(first[i]));
+			}
+		}
+
+		// returns the number of divided values, the failing value (if any) is searched before dividing
+		template <bool Rem, typename In, typename Out>
+		std::size_t transform(const In* first, const std::size_t count, Out* out) const noexcept {
+			const In min = std::numeric_limits<T>::min();
+			const std::size_t valid = may_fail() ? std::size_t(std::find(first, first + count, min) - first) : count;
+			switch(a){
+				case algo::shift:     transform_unchecked<algo::shift, Rem>(first, valid, out); break;
+				case algo::mulhi:     transform_unchecked<algo::mulhi, Rem>(first, valid, out); break;
+				case algo::mulhi_add: transform_unchecked<algo::mulhi_add, Rem>(first, valid, out); break;
+				default: break;
+			}
+			return valid;
+		}
+
+	public:
+		/// Constructor
+		/// Validates the divisor and calculates the magic number
+		/// If the divisor is 0, an exception is thrown
+		explicit safe_divider(const T divisor) : d(safeintegralop::details::safe_abs(divisor)), negative(divisor < T{0}) {
+			if(divisor == T{0}){
+				throw std::out_of_range("division by 0 with safe_divider");
+			}
+			const unsigned l = safeintegralop::details::floor_log2(d);
+			if((d & U(d - 1)) == U{0}){
+				shift = static_cast<unsigned char>(l);
+				return;
+			}
+			// Granlund-Montgomery: magic = ceil(2^(digits+l) / d), if it does not fit in U the "add" variant is used
+			U rem = 0;
+			U m = safeintegralop::details::div_wide(l, d, rem);
+			const U e = U(d - rem);
+			if(e < (U(1) << l)){
+				a = algo::mulhi;
+			} else {
+				m = U(m + m);
+				const U twice_rem = U(rem + rem);
+				if(twice_rem >= d || twice_rem < rem){
+					++m;
+				}
+				a = algo::mulhi_add;
+			}
+			magic = U(m + 1);
+			shift = static_cast<unsigned char>(l);
+		}
+
+		/// Returns the divisor
+		T divisor() const noexcept {
+			return apply_sign(d, negative);
+		}
+
+		/// Operator /
+		/// If the operation is not safe (min/-1), an exception is thrown
+		friend safe_integral<T> operator/(const safe_integral<T> lhs, const safe_divider& rhs) {
+			return rhs.is_safe(lhs.getvalue()) ? safe_integral<T>(rhs.template divide_unchecked<false>(lhs.getvalue())) :
+			    throw std::out_of_range("overflow with operator/");
+		}
+
+		/// Operator %
+		/// If the operation is not safe (min%-1), an exception is thrown
+		friend safe_integral<T> operator%(const safe_integral<T> lhs, const safe_divider& rhs) {
+			return rhs.is_safe(lhs.getvalue()) ? safe_integral<T>(rhs.template divide_unchecked<true>(lhs.getvalue())) :
+			    throw std::out_of_range("overflow with operator%");
+		}
+
+		/// Divides the count values starting at first, and saves the quotients starting at out (may be equal to first)
+		/// Returns the index of the first value that cannot be divided (its quotient, and the following, are not written),
+		/// or count if all values have been divided
+		std::size_t quotients(const T* first, const std::size_t count, T* out) const noexcept {
+			return transform<false>(first, count, out);
+		}
+
+		/// Like quotients, but saves the remainders
+		std::size_t remainders(const T* first, const std::size_t count, T* out) const noexcept {
+			return transform<true>(first, count, out);
+		}
+
+		/// Like quotients, but an exception is thrown if a value cannot be divided, after all preceding values have been divided
+		void quotients(const safe_integral<T>* first, const std::size_t count, safe_integral<T>* out) const {
+			if(transform<false>(first, count, out) != count){
+				throw std::out_of_range("overflow with operator/");
+			}
+		}
+
+		/// Like remainders, but an exception is thrown if a value cannot be divided, after all preceding values have been divided
+		void remainders(const safe_integral<T>* first, const std::size_t count, safe_integral<T>* out) const {
+			if(transform<true>(first, count, out) != count){
+				throw std::out_of_range("overflow with operator%");
+			}
+		}
+};
+
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+safe_divider<T> make_safe_divider(const T d) {
+	return safe_divider<T>(d);
+}
+
+#endif // SAFEINTEGRAL_SAFEDIVIDER_HPP
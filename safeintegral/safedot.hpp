@@ -0,0 +1,329 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEDOT_HPP
+#define SAFEINTEGRAL_SAFEDOT_HPP
+
+#include "safeintegral.hpp"
+#include "safeblock.hpp"
+#include "safescan.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// every value of T can be converted to R
+		template <typename R, typename T>
+		constexpr bool is_widening() noexcept {
+			return in_range<R>(std::numeric_limits<T>::min()) && in_range<R>(std::numeric_limits<T>::max());
+		}
+
+		// all products of a value in a and a value in b
+		template <typename R, typename T>
+		safe_interval<R> terms_interval(const safe_interval<T> a, const safe_interval<T> b) noexcept {
+			return safe_interval<R>(R(a.min()), R(a.max())) * safe_interval<R>(R(b.min()), R(b.max()));
+		}
+
+		// true if no partial sum of count products, in any order, added to sum, can overflow
+		template <typename R, typename T>
+		bool is_safe_dot_block(const R sum, const safe_interval<T> a, const safe_interval<T> b, const std::size_t count) {
+			const auto terms = terms_interval<R>(a, b);
+			return terms.is_valid() && in_range<R>(count) && partial_sums_interval(sum, terms, count).is_valid();
+		}
+
+		// sum += a[i*stride_a] * b[i*stride_b], with a check for every product and sum, like safe_add(sum, safe_mult(a, b))
+		// On return, sum is the sum of the products before the returned index
+		template <typename R, typename T>
+		std::size_t checked_dot(const T* a, const std::size_t stride_a, const T* b, const std::size_t stride_b, const std::size_t count, R& sum) noexcept {
+			R s = sum;
+			for(std::size_t i = 0; i != count; ++i){
+				const R x = R(a[i * stride_a]);
+				const R y = R(b[i * stride_b]);
+				if(!is_safe_mult(x, y) || !is_safe_add(s, R(x * y))){
+					sum = s;
+					return i;
+				}
+				s = R(s + R(x * y));
+			}
+			sum = s;
+			return count;
+		}
+
+		// the following functions do not check for overflow, the values need to be validated with is_safe_dot_block
+		template <typename R, typename T>
+		void unchecked_dot(const T* a, const T* b, const std::size_t count, R& sum) noexcept {
+			R s = sum;
+			for(std::size_t i = 0; i != count; ++i){
+				s = R(s + R(a[i]) * R(b[i]));
+			}
+			sum = s;
+		}
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+		// vpdpwssd: the products of 2 pairs of 16-bit values are added to a 32-bit value, 32 products for every instruction
+		inline void unchecked_dot(const std::int16_t* a, const std::int16_t* b, const std::size_t count, std::int32_t& sum) noexcept {
+			__m512i acc = _mm512_setzero_si512();
+			std::size_t i = 0;
+			for(; count - i >= 32; i += 32){
+				acc = _mm512_dpwssd_epi32(acc, _mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+			}
+			const __mmask32 rest = static_cast<__mmask32>((std::uint64_t(1) << (count - i)) - 1);
+			acc = _mm512_dpwssd_epi32(acc, _mm512_maskz_loadu_epi16(rest, a + i), _mm512_maskz_loadu_epi16(rest, b + i));
+			// two's complement sum, converted without implementation-defined conversions
+			sum = from_unsigned<std::int32_t>(static_cast<std::uint32_t>(sum) + static_cast<std::uint32_t>(_mm512_reduce_add_epi32(acc)));
+		}
+#elif defined(__SSE2__)
+		// pmaddwd: the products of 2 pairs of 16-bit values are added to a 32-bit value, 8 products for every instruction
+		inline void unchecked_dot(const std::int16_t* a, const std::int16_t* b, const std::size_t count, std::int32_t& sum) noexcept {
+			__m128i acc = _mm_setzero_si128();
+			std::size_t i = 0;
+			for(; count - i >= 8; i += 8){
+				const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+				acc = _mm_add_epi32(acc, _mm_madd_epi16(x, y));
+			}
+			acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+			acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+			// two's complement sum, converted without implementation-defined conversions
+			std::uint32_t s = static_cast<std::uint32_t>(sum) + static_cast<std::uint32_t>(_mm_cvtsi128_si32(acc));
+			for(; i != count; ++i){
+				s += static_cast<std::uint32_t>(std::int32_t(a[i]) * std::int32_t(b[i]));
+			}
+			sum = from_unsigned<std::int32_t>(s);
+		}
+#endif
+
+		// blocks of b that fit in the L2 cache, and of a row of c that fit in the L1 cache
+		constexpr std::size_t gemm_block_n() noexcept {
+			return 256;
+		}
+		constexpr std::size_t gemm_block_k() noexcept {
+			return 128;
+		}
+
+		// c = a * b, a is m x k, b is k x n, c is m x n, all row-major
+		template <typename R, typename T>
+		void unchecked_gemm(const T* a, const T* b, R* c, const std::size_t m, const std::size_t n, const std::size_t k) noexcept {
+			std::fill(c, c + m * n, R{0});
+			for(std::size_t jb = 0; jb < n; jb += gemm_block_n()){
+				const std::size_t je = std::min(n, jb + gemm_block_n());
+				for(std::size_t kb = 0; kb < k; kb += gemm_block_k()){
+					const std::size_t ke = std::min(k, kb + gemm_block_k());
+					for(std::size_t i = 0; i != m; ++i){
+						R* ci = c + i * n;
+						for(std::size_t kk = kb; kk != ke; ++kk){
+							const R x = R(a[i * k + kk]);
+							const T* bk = b + kk * n;
+							// vectorized by the compiler
+							for(std::size_t j = jb; j != je; ++j){
+								ci[j] = R(ci[j] + x * R(bk[j]));
+							}
+						}
+					}
+				}
+			}
+		}
+
+#if defined(__SSE2__)
+		// two rows of b are interleaved in registers, so that pmaddwd multiplies them with two consecutive values of a row of a
+		inline void unchecked_gemm(const std::int16_t* a, const std::int16_t* b, std::int32_t* c, const std::size_t m, const std::size_t n, const std::size_t k) noexcept {
+			std::fill(c, c + m * n, 0);
+			for(std::size_t jb = 0; jb < n; jb += gemm_block_n()){
+				const std::size_t je = std::min(n, jb + gemm_block_n());
+				for(std::size_t kb = 0; kb < k; kb += gemm_block_k()){
+					const std::size_t ke = std::min(k, kb + gemm_block_k());
+					for(std::size_t i = 0; i != m; ++i){
+						std::int32_t* ci = c + i * n;
+						std::size_t kk = kb;
+						for(; ke - kk >= 2; kk += 2){
+							const __m128i x = _mm_unpacklo_epi16(_mm_set1_epi16(a[i * k + kk]), _mm_set1_epi16(a[i * k + kk + 1]));
+							const std::int16_t* b0 = b + kk * n;
+							const std::int16_t* b1 = b0 + n;
+							std::size_t j = jb;
+							for(; je - j >= 8; j += 8){
+								const __m128i y0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b0 + j));
+								const __m128i y1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b1 + j));
+								__m128i* c0 = reinterpret_cast<__m128i*>(ci + j);
+								__m128i* c1 = reinterpret_cast<__m128i*>(ci + j + 4);
+								_mm_storeu_si128(c0, _mm_add_epi32(_mm_loadu_si128(c0), _mm_madd_epi16(_mm_unpacklo_epi16(y0, y1), x)));
+								_mm_storeu_si128(c1, _mm_add_epi32(_mm_loadu_si128(c1), _mm_madd_epi16(_mm_unpackhi_epi16(y0, y1), x)));
+							}
+							for(; j < je; ++j){
+								ci[j] += std::int32_t(a[i * k + kk]) * b0[j] + std::int32_t(a[i * k + kk + 1]) * b1[j];
+							}
+						}
+						for(; kk != ke; ++kk){
+							const std::int32_t x = a[i * k + kk];
+							const std::int16_t* bk = b + kk * n;
+							for(std::size_t j = jb; j != je; ++j){
+								ci[j] += x * bk[j];
+							}
+						}
+					}
+				}
+			}
+		}
+#endif
+
+		template <typename R, typename T>
+		std::size_t safe_dot(const T* a, const T* b, const std::size_t count, R& sum) noexcept {
+			R s = sum;
+			for(std::size_t bl = 0; bl < count; bl += transform_block_size()){
+				const std::size_t n = std::min(count - bl, transform_block_size());
+				if(is_safe_dot_block(s, minmax_interval<T>(a + bl, n), minmax_interval<T>(b + bl, n), n)){
+					unchecked_dot(a + bl, b + bl, n, s);
+					continue;
+				}
+				const std::size_t i = checked_dot(a + bl, 1, b + bl, 1, n, s);
+				if(i != n){
+					sum = s;
+					return bl + i;
+				}
+			}
+			sum = s;
+			return count;
+		}
+
+		template <typename R, typename T>
+		std::size_t safe_gemm(const T* a, const T* b, const std::size_t m, const std::size_t n, const std::size_t k, R* c, bool* overflow) {
+			if(m == 0 || n == 0 || k == 0){
+				std::fill(c, c + m * n, R{0});
+				if(overflow != nullptr){
+					std::fill(overflow, overflow + m * n, false);
+				}
+				return 0;
+			}
+			const auto values_b = minmax_interval<T>(b, k * n);
+			std::size_t overflows = 0;
+			// consecutive rows of a that cannot overflow are multiplied together, the other rows element by element
+			std::size_t first_row = 0;
+			for(std::size_t i = 0; i != m + 1; ++i){
+				if(i != m && is_safe_dot_block(R{0}, minmax_interval<T>(a + i * k, k), values_b, k)){
+					continue;
+				}
+				unchecked_gemm(a + first_row * k, b, c + first_row * n, i - first_row, n, k);
+				if(overflow != nullptr){
+					std::fill(overflow + first_row * n, overflow + i * n, false);
+				}
+				first_row = i + 1;
+				for(std::size_t j = 0; i != m && j != n; ++j){
+					R sum = R{0};
+					const bool failed = checked_dot(a + i * k, 1, b + j, n, k, sum) != k;
+					c[i * n + j] = sum;
+					overflows += failed;
+					if(overflow != nullptr){
+						overflow[i * n + j] = failed;
+					}
+				}
+			}
+			return overflows;
+		}
+	} // end details
+
+	/// sum += a[0] * b[0] + ... + a[count-1] * b[count-1], calculated in R
+	/// The values are processed in blocks, like safe_transform. If no partial sum of a block can overflow, the block is
+	/// calculated without any check and with SIMD instructions (pmaddwd or vpdpwssd for 16-bit values and a 32-bit sum),
+	/// otherwise every product and sum is checked, with the same results of safe_add(sum, safe_mult(R(a[i]), R(b[i]))).
+	/// Returns the index of the first product for which the sum overflows (sum is the sum of the preceding products), or count
+	///
+	/// Example Usage:
+	/// @code
+	/// 	std::int32_t sum = 0;
+	/// 	if(safeintegralop::safe_dot(features.data(), weights.data(), features.size(), sum) != features.size()){
+	/// 		// overflow
+	/// 	}
+	/// @endcode
+	template <typename R, typename T>
+	std::size_t safe_dot(const T* a, const T* b, const std::size_t count, R& sum) noexcept {
+		static_assert(details::is_widening<R, T>(), "T cannot be converted to R");
+		return details::safe_dot(a, b, count, sum);
+	}
+
+	/// Like safe_dot with raw values, but an exception is thrown if the sum overflows
+	/// Example Usage:
+	/// @code
+	/// 	const safe_integral<std::int64_t> sum = safeintegralop::safe_dot<std::int64_t>(a.data(), b.data(), a.size());
+	/// @endcode
+	template <typename R, typename T>
+	safe_integral<R> safe_dot(const safe_integral<T>* a, const safe_integral<T>* b, const std::size_t count) {
+		static_assert(details::is_widening<R, T>(), "T cannot be converted to R");
+		R sum = R{0};
+		// the values are copied block by block with getvalue, instead of indexing the storage of different objects through a T*
+		T raw_a[details::transform_block_size()];
+		T raw_b[details::transform_block_size()];
+		for(std::size_t bl = 0; bl < count; bl += details::transform_block_size()){
+			const std::size_t n = std::min(count - bl, details::transform_block_size());
+			for(std::size_t i = 0; i != n; ++i){
+				raw_a[i] = a[bl + i].getvalue();
+				raw_b[i] = b[bl + i].getvalue();
+			}
+			if(details::safe_dot(raw_a, raw_b, n, sum) != n){
+				throw std::out_of_range("overflow with safe_dot");
+			}
+		}
+		return sum;
+	}
+
+	/// c = a * b, calculated in R, where a is a m x k matrix, b is a k x n matrix, and c is a m x n matrix, all row-major
+	/// Rows of a for which no partial sum can overflow are multiplied in cache-sized blocks, without any check and with SIMD
+	/// instructions, the elements of other rows are calculated with the same results of safe_dot.
+	/// Returns the number of elements of c that overflow. If overflow is not null, overflow[i * n + j] is set to true if
+	/// c[i * n + j] overflows, and c[i * n + j] is the sum of the products before the overflowing one
+	///
+	/// Example Usage:
+	/// @code
+	/// 	if(safeintegralop::safe_gemm(a.data(), b.data(), m, n, k, c.data()) != 0){
+	/// 		// overflow
+	/// 	}
+	/// @endcode
+	template <typename R, typename T>
+	std::size_t safe_gemm(const T* a, const T* b, const std::size_t m, const std::size_t n, const std::size_t k, R* c, bool* overflow = nullptr) {
+		static_assert(details::is_widening<R, T>(), "T cannot be converted to R");
+		return details::safe_gemm(a, b, m, n, k, c, overflow);
+	}
+
+	/// Like safe_gemm with raw values, but an exception is thrown if an element of c overflows
+	template <typename R, typename T>
+	void safe_gemm(const safe_integral<T>* a, const safe_integral<T>* b, const std::size_t m, const std::size_t n, const std::size_t k, safe_integral<R>* c) {
+		static_assert(details::is_widening<R, T>(), "T cannot be converted to R");
+		// copied with getvalue, like safe_dot, the copies are negligible compared to the m * n * k products
+		std::vector<T> raw_a(m * k);
+		std::vector<T> raw_b(k * n);
+		std::vector<R> raw_c(m * n);
+		std::transform(a, a + m * k, raw_a.begin(), [](const safe_integral<T> v){ return v.getvalue(); });
+		std::transform(b, b + k * n, raw_b.begin(), [](const safe_integral<T> v){ return v.getvalue(); });
+		if(details::safe_gemm(raw_a.data(), raw_b.data(), m, n, k, raw_c.data(), static_cast<bool*>(nullptr)) != 0){
+			throw std::out_of_range("overflow with safe_gemm");
+		}
+		std::copy(raw_c.begin(), raw_c.end(), c);
+	}
+}
+
+#endif // SAFEINTEGRAL_SAFEDOT_HPP
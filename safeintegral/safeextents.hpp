@@ -0,0 +1,205 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEEXTENTS_HPP
+#define SAFEINTEGRAL_SAFEEXTENTS_HPP
+
+#include "safeintegral.hpp"
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		template <typename... I>
+		struct all_integral : std::true_type {};
+
+		template <typename I, typename... Is>
+		struct all_integral<I, Is...> : std::integral_constant<bool, std::is_integral<I>::value && all_integral<Is...>::value> {};
+	} // end details
+}
+
+/// Layouts of safe_extents, like the layouts of std::mdspan
+/// Row-major, the last index is contiguous
+struct safe_layout_right {};
+/// Column-major, the first index is contiguous
+struct safe_layout_left {};
+/// Any stride, for example the rows of an image with padding
+struct safe_layout_stride {};
+
+/// This class describes the extents of a multi-dimensional array (an image, a tensor...), and the strides of every
+/// dimension, like the mappings of std::mdspan (safe_layout_right, safe_layout_left and safe_layout_stride).
+/// The product of all extents, and the size of the required storage, are calculated once with safe_integral<T>: if they
+/// overflow, or an extent or stride is negative, the constructor throws an exception. After that, all indexes computed for
+/// indices inside the extents are representable by T, and index() computes them without any check (with the contiguous
+/// index of safe_layout_right and safe_layout_left known at compile time, so that the loops over it can be vectorized).
+///
+/// Example Usage:
+/// @code
+/// 	const safe_extents<std::size_t, 2> e(height, width); // throws if height * width overflows
+/// 	std::vector<float> image(e.size());
+/// 	for(std::size_t r = 1; r + 1 < e.extent(0); ++r){
+/// 		for(std::size_t c = 1; c + 1 < e.extent(1); ++c){
+/// 			out[e.index(r, c)] = image[e.index(r - 1, c)] + image[e.index(r + 1, c)]; // unchecked
+/// 		}
+/// 	}
+/// @endcode
+template <typename T, std::size_t Rank, typename Layout = safe_layout_right>
+class safe_extents {
+		static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "T needs to be an integral type");
+		static_assert(Rank >= 1, "Rank needs to be at least 1");
+	public:
+		using index_type = T;
+		using layout_type = Layout;
+
+	private:
+		std::array<T, Rank> extents_;
+		std::array<T, Rank> strides_;
+		T size_;
+		T span_;
+
+		template <typename I>
+		static T checked_extent(const I e) {
+			if(!safeintegralop::in_range<T>(e) || safeintegralop::cmp_less(e, 0)){
+				throw std::out_of_range("safe_extents extent out of range");
+			}
+			return T(e);
+		}
+
+		// the product of all extents, and 1 + the sum of (extent - 1) * stride (or 0 if one extent is 0)
+		void validate() {
+			safe_integral<T> size = T{1};
+			safe_integral<T> span = T{0};
+			bool empty = false;
+			for(std::size_t r = 0; r != Rank; ++r){
+				if(safeintegralop::cmp_less(strides_[r], 0)){
+					throw std::out_of_range("safe_extents stride out of range");
+				}
+				size *= extents_[r];
+				if(extents_[r] == T{0}){
+					empty = true;
+				} else {
+					span += safe_integral<T>(T(extents_[r] - T{1})) * safe_integral<T>(strides_[r]);
+				}
+			}
+			size_ = size.getvalue();
+			span_ = empty ? T{0} : (span + safe_integral<T>(T{1})).getvalue();
+		}
+
+		template <typename I>
+		bool contains_index(const I i, const std::size_t r) const noexcept {
+			return !safeintegralop::cmp_less(i, 0) && safeintegralop::cmp_less(i, extents_[r]);
+		}
+
+	public:
+		/// Constructor
+		/// The extents of the Rank dimensions, the strides are those of the layout
+		template <typename... I, class = typename std::enable_if<sizeof...(I) == Rank && safeintegralop::details::all_integral<I...>::value &&
+		                                                         !std::is_same<Layout, safe_layout_stride>::value>::type>
+		explicit safe_extents(const I... e) : extents_{{checked_extent(e)...}} {
+			safe_integral<T> stride = T{1};
+			for(std::size_t k = 0; k != Rank; ++k){
+				const std::size_t r = std::is_same<Layout, safe_layout_right>::value ? Rank - 1 - k : k;
+				strides_[r] = stride.getvalue();
+				stride *= extents_[r];
+			}
+			validate();
+		}
+
+		/// Constructor
+		/// The extents and the strides of the Rank dimensions, only for safe_layout_stride
+		template <typename L = Layout, class = typename std::enable_if<std::is_same<L, safe_layout_stride>::value>::type>
+		safe_extents(const std::array<T, Rank>& extents, const std::array<T, Rank>& strides) {
+			for(std::size_t r = 0; r != Rank; ++r){
+				extents_[r] = checked_extent(extents[r]);
+				strides_[r] = strides[r];
+			}
+			validate();
+		}
+
+		/// The extents and strides of a mapping of std::mdspan (or any type with the same interface: extents().extent(r),
+		/// and stride(r)), for example std::layout_right::mapping<std::dextents<std::size_t, 2>>, only for safe_layout_stride
+		template <typename Mapping>
+		static safe_extents from_mapping(const Mapping& m) {
+			static_assert(std::is_same<Layout, safe_layout_stride>::value, "from_mapping needs safe_layout_stride");
+			std::array<T, Rank> extents;
+			std::array<T, Rank> strides;
+			for(std::size_t r = 0; r != Rank; ++r){
+				extents[r] = checked_extent(m.extents().extent(r));
+				strides[r] = checked_extent(m.stride(r));
+			}
+			return safe_extents(extents, strides);
+		}
+
+		static constexpr std::size_t rank() noexcept { return Rank; }
+		T extent(const std::size_t r) const noexcept { return extents_[r]; }
+		T stride(const std::size_t r) const noexcept { return strides_[r]; }
+		/// Returns the number of elements, the product of all extents
+		T size() const noexcept { return size_; }
+		/// Returns the number of elements of the storage needed for all indexes: 1 + the greatest index
+		T required_span_size() const noexcept { return span_; }
+
+		/// Returns the number of bytes of the storage for elements of element_size bytes
+		/// If the value is not representable by std::size_t, an exception is thrown
+		std::size_t required_bytes(const std::size_t element_size) const {
+			if(!safeintegralop::in_range<std::size_t>(span_)){
+				throw std::out_of_range("safe_extents required_bytes out of range");
+			}
+			return (safe_integral<std::size_t>(std::size_t(span_)) * safe_integral<std::size_t>(element_size)).getvalue();
+		}
+
+		/// true if all indices are inside the extents
+		template <typename... I>
+		bool contains(const I... i) const noexcept {
+			static_assert(sizeof...(I) == Rank, "one index for every dimension is needed");
+			std::size_t r = 0;
+			const bool inside[] = {contains_index(i, r++)...};
+			for(const bool b : inside){
+				if(!b){
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// Returns the linear index of the element at the indices i, not checked: the indices need to be inside the extents
+		template <typename... I>
+		T index(const I... i) const noexcept {
+			static_assert(sizeof...(I) == Rank, "one index for every dimension is needed");
+			const T idx[] = {T(i)...};
+			T res = T{0};
+			for(std::size_t r = 0; r != Rank; ++r){
+				const bool contiguous = (std::is_same<Layout, safe_layout_right>::value && r == Rank - 1) || (std::is_same<Layout, safe_layout_left>::value && r == 0);
+				res = T(res + (contiguous ? idx[r] : T(idx[r] * strides_[r])));
+			}
+			return res;
+		}
+
+		/// Same as index, but throws if the indices are not inside the extents
+		template <typename... I>
+		T at(const I... i) const {
+			if(!contains(i...)){
+				throw std::out_of_range("safe_extents index out of range");
+			}
+			return index(i...);
+		}
+};
+
+#endif // SAFEINTEGRAL_SAFEEXTENTS_HPP
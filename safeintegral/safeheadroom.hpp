@@ -0,0 +1,364 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEHEADROOM_HPP
+#define SAFEINTEGRAL_SAFEHEADROOM_HPP
+
+#include "safeintegralop_cmp.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// the integral types are grouped by size and signedness: int8_t, uint8_t, int16_t, ..., uint64_t
+		constexpr std::size_t headroom_kinds() noexcept {
+			return 8;
+		}
+		// bit width of a magnitude, from 0 to 64
+		constexpr std::size_t headroom_buckets() noexcept {
+			return 65;
+		}
+
+		template <typename T>
+		constexpr std::size_t headroom_kind() noexcept {
+			return (sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 2 : sizeof(T) == 4 ? 4 : 6) + (std::is_signed<T>::value ? 0 : 1);
+		}
+
+		inline const char* headroom_type_name(const std::size_t kind) noexcept {
+			static const char* const names[headroom_kinds()] = {"int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t"};
+			return names[kind];
+		}
+
+		inline std::uint64_t headroom_max(const std::size_t kind) noexcept {
+			return std::numeric_limits<std::uint64_t>::max() >> (64 - (8u << (kind / 2)) + ((kind % 2 == 0) ? 1 : 0));
+		}
+
+		// magnitude of min, 0 for unsigned types
+		inline std::uint64_t headroom_min_magnitude(const std::size_t kind) noexcept {
+			return (kind % 2 == 0) ? headroom_max(kind) + 1 : 0;
+		}
+
+		inline std::size_t headroom_bucket(const std::uint64_t m) noexcept {
+#if defined(__GNUC__)
+			return (m == 0) ? 0 : std::size_t(64 - __builtin_clzll(m));
+#else
+			std::size_t n = 0;
+			for(std::uint64_t v = m; v != 0; v >>= 1){
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		// statistics of one type in one site
+		// every counter is written only by its thread, the atomics permit to read them while the thread is running
+		struct headroom_counters {
+			std::atomic<std::uint64_t> bits[2][headroom_buckets()]; // [negative][bit width of the magnitude]
+			std::atomic<std::uint64_t> max_magnitude[2];
+		};
+
+		inline void headroom_store(std::atomic<std::uint64_t>& c, const std::uint64_t v) noexcept {
+			c.store(v, std::memory_order_relaxed);
+		}
+
+		inline std::uint64_t headroom_load(const std::atomic<std::uint64_t>& c) noexcept {
+			return c.load(std::memory_order_relaxed);
+		}
+
+		// dst += src, one element for every site and type
+		inline void headroom_merge(std::vector<std::unique_ptr<headroom_counters>>& dst, const std::vector<std::unique_ptr<headroom_counters>>& src) {
+			dst.resize(dst.size() < src.size() ? src.size() : dst.size());
+			for(std::size_t i = 0; i != src.size(); ++i){
+				if(!src[i]){
+					continue;
+				}
+				if(!dst[i]){
+					dst[i].reset(new headroom_counters());
+				}
+				for(std::size_t n = 0; n != 2; ++n){
+					for(std::size_t b = 0; b != headroom_buckets(); ++b){
+						headroom_store(dst[i]->bits[n][b], headroom_load(dst[i]->bits[n][b]) + headroom_load(src[i]->bits[n][b]));
+					}
+					if(headroom_load(src[i]->max_magnitude[n]) > headroom_load(dst[i]->max_magnitude[n])){
+						headroom_store(dst[i]->max_magnitude[n], headroom_load(src[i]->max_magnitude[n]));
+					}
+				}
+			}
+		}
+
+		struct headroom_thread;
+
+		struct headroom_registry {
+			std::mutex m;
+			std::vector<headroom_thread*> threads;
+			// statistics of the threads that have already exited
+			std::vector<std::unique_ptr<headroom_counters>> retired;
+			// names of the sites, 0 is the site of the results outside of any safe_headroom_scope
+			std::vector<std::string> sites = std::vector<std::string>(1);
+
+			static headroom_registry& get() {
+				static headroom_registry r;
+				return r;
+			}
+		};
+
+		// statistics of one thread, merged in the registry when the thread exits
+		struct headroom_thread {
+			// one element for every site and type: site * headroom_kinds() + kind
+			std::vector<std::unique_ptr<headroom_counters>> counters;
+
+			headroom_thread() {
+				headroom_registry& r = headroom_registry::get();
+				std::lock_guard<std::mutex> lock(r.m);
+				r.threads.push_back(this);
+			}
+			headroom_thread(const headroom_thread&) = delete;
+			headroom_thread& operator=(const headroom_thread&) = delete;
+			~headroom_thread() {
+				headroom_registry& r = headroom_registry::get();
+				std::lock_guard<std::mutex> lock(r.m);
+				headroom_merge(r.retired, counters);
+				for(std::size_t i = 0; i != r.threads.size(); ++i){
+					if(r.threads[i] == this){
+						r.threads.erase(r.threads.begin() + std::ptrdiff_t(i));
+						break;
+					}
+				}
+			}
+		};
+
+		inline std::size_t& current_headroom_site() noexcept {
+			static thread_local std::size_t site = 0;
+			return site;
+		}
+
+		inline headroom_counters& headroom_counters_of(const std::size_t kind) {
+			static thread_local headroom_thread t;
+			const std::size_t i = current_headroom_site() * headroom_kinds() + kind;
+			if(i >= t.counters.size() || !t.counters[i]){
+				// the registry reads the vector while merging
+				std::lock_guard<std::mutex> lock(headroom_registry::get().m);
+				t.counters.resize(i < t.counters.size() ? t.counters.size() : i + 1);
+				t.counters[i].reset(new headroom_counters());
+			}
+			return *t.counters[i];
+		}
+	} // end details
+
+	/// Records a result in the headroom statistics of its type, and of the current site (see safe_headroom_scope)
+	/// If the macro SAFE_INTEGRAL_PROFILE_HEADROOM is defined (in every translation unit), safe_integral calls it for the
+	/// result of every operation that can overflow.
+	/// Only the thread that records a value writes its statistics, they are merged by headroom_report.
+	template <typename T>
+	void record_headroom(const T v) {
+		static_assert(std::is_integral<T>::value && sizeof(T) <= 8, "T needs to be an integral type of at most 64 bits");
+		const bool negative = v < T{0};
+		const std::uint64_t m = details::safe_abs(v);
+		details::headroom_counters& c = details::headroom_counters_of(details::headroom_kind<T>());
+		details::headroom_store(c.bits[negative][details::headroom_bucket(m)], details::headroom_load(c.bits[negative][details::headroom_bucket(m)]) + 1);
+		if(m > details::headroom_load(c.max_magnitude[negative])){
+			details::headroom_store(c.max_magnitude[negative], m);
+		}
+	}
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// true if evaluated at compile time. Without support of the compiler it is always false: every result is recorded,
+		// and the operations of safe_integral cannot be used in constant expressions while profiling
+#if defined(__cpp_lib_is_constant_evaluated)
+		constexpr bool is_constant_evaluated() noexcept {
+			return std::is_constant_evaluated();
+		}
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+		constexpr bool is_constant_evaluated() noexcept {
+			return __builtin_is_constant_evaluated();
+		}
+#else
+		constexpr bool is_constant_evaluated() noexcept {
+			return false;
+		}
+#endif
+#else
+		constexpr bool is_constant_evaluated() noexcept {
+			return false;
+		}
+#endif
+
+		// records v, unless it is calculated at compile time
+		template <typename T>
+		constexpr T headroom_result(const T v) {
+			return is_constant_evaluated() ? v : (record_headroom(v), v);
+		}
+	} // end details
+
+	/// Statistics of the results of one type in one site
+	struct headroom_entry {
+		/// the name of the site, empty for the results outside of any safe_headroom_scope
+		std::string site;
+		/// the type of the results, for example "int64_t"
+		const char* type;
+		std::uint64_t count;
+		/// the greatest result (0 if all results are negative)
+		std::uint64_t max_positive;
+		/// the magnitude of the least result (0 if no result is negative)
+		std::uint64_t max_negative;
+		/// max(type) - max_positive, the smallest distance to an overflow
+		std::uint64_t positive_headroom;
+		/// |min(type)| - max_negative, 0 for unsigned types
+		std::uint64_t negative_headroom;
+		/// number of results for every bit width of their magnitude
+		std::uint64_t positive_bits[details::headroom_buckets()];
+		std::uint64_t negative_bits[details::headroom_buckets()];
+		/// the narrowest type that can represent all results, signed only if the type is signed
+		const char* recommended;
+	};
+
+	/// Merges the statistics of all threads, one entry for every site and type with at least one result
+	inline std::vector<headroom_entry> headroom_report() {
+		details::headroom_registry& r = details::headroom_registry::get();
+		std::vector<std::unique_ptr<details::headroom_counters>> all;
+		std::vector<std::string> sites;
+		{
+			std::lock_guard<std::mutex> lock(r.m);
+			details::headroom_merge(all, r.retired);
+			for(const auto t : r.threads){
+				details::headroom_merge(all, t->counters);
+			}
+			sites = r.sites;
+		}
+		std::vector<headroom_entry> report;
+		for(std::size_t i = 0; i != all.size(); ++i){
+			if(!all[i]){
+				continue;
+			}
+			const std::size_t kind = i % details::headroom_kinds();
+			headroom_entry e{};
+			e.site = sites[i / details::headroom_kinds()];
+			e.type = details::headroom_type_name(kind);
+			for(std::size_t b = 0; b != details::headroom_buckets(); ++b){
+				e.positive_bits[b] = details::headroom_load(all[i]->bits[0][b]);
+				e.negative_bits[b] = details::headroom_load(all[i]->bits[1][b]);
+				e.count += e.positive_bits[b] + e.negative_bits[b];
+			}
+			if(e.count == 0){
+				continue;
+			}
+			e.max_positive = details::headroom_load(all[i]->max_magnitude[0]);
+			e.max_negative = details::headroom_load(all[i]->max_magnitude[1]);
+			e.positive_headroom = details::headroom_max(kind) - e.max_positive;
+			e.negative_headroom = details::headroom_min_magnitude(kind) - e.max_negative;
+			const bool is_signed = (kind % 2 == 0);
+			std::size_t k = is_signed ? 0 : 1;
+			while(k + 2 < details::headroom_kinds() && (details::headroom_max(k) < e.max_positive || details::headroom_min_magnitude(k) < e.max_negative)){
+				k += 2;
+			}
+			e.recommended = details::headroom_type_name(k);
+			report.push_back(e);
+		}
+		return report;
+	}
+
+	/// Writes the report, one line for every site and type, separated by tabs
+	/// Example Usage:
+	/// @code
+	/// 	safeintegralop::print_headroom_report(std::cerr);
+	/// @endcode
+	inline void print_headroom_report(std::ostream& os) {
+		os << "site\ttype\tresults\tmax\tmin\tpositive headroom\tnegative headroom\trecommended\n";
+		for(const auto& e : headroom_report()){
+			os << (e.site.empty() ? "-" : e.site) << '\t' << e.type << '\t' << e.count << '\t' << e.max_positive << '\t'
+			   << (e.max_negative == 0 ? "" : "-") << e.max_negative << '\t' << e.positive_headroom << '\t' << e.negative_headroom << '\t'
+			   << e.recommended << '\n';
+		}
+	}
+
+	/// Clears the statistics of all threads
+	inline void reset_headroom() {
+		details::headroom_registry& r = details::headroom_registry::get();
+		std::lock_guard<std::mutex> lock(r.m);
+		r.retired.clear();
+		for(const auto t : r.threads){
+			for(const auto& c : t->counters){
+				if(!c){
+					continue;
+				}
+				for(std::size_t n = 0; n != 2; ++n){
+					for(auto& b : c->bits[n]){
+						details::headroom_store(b, 0);
+					}
+					details::headroom_store(c->max_magnitude[n], 0);
+				}
+			}
+		}
+	}
+}
+
+/// A named site of the headroom statistics, for example a column of a table
+/// The results recorded inside a safe_headroom_scope of the site are reported separately. Sites with the same name are
+/// the same site.
+///
+/// Example Usage:
+/// @code
+/// 	static const safe_headroom_site quantity("orders.quantity");
+/// 	safe_headroom_scope scope(quantity);
+/// 	total += order.quantity;
+/// @endcode
+class safe_headroom_site {
+	private:
+		std::size_t index;
+	public:
+		explicit safe_headroom_site(const std::string& name) {
+			safeintegralop::details::headroom_registry& r = safeintegralop::details::headroom_registry::get();
+			std::lock_guard<std::mutex> lock(r.m);
+			index = 0;
+			while(index != r.sites.size() && r.sites[index] != name){
+				++index;
+			}
+			if(index == r.sites.size()){
+				r.sites.push_back(name);
+			}
+		}
+		std::size_t id() const noexcept { return index; }
+};
+
+/// Records the results of the current thread in a site, until the end of the scope
+class safe_headroom_scope {
+	private:
+		std::size_t previous;
+	public:
+		explicit safe_headroom_scope(const safe_headroom_site& site) noexcept : previous(safeintegralop::details::current_headroom_site()) {
+			safeintegralop::details::current_headroom_site() = site.id();
+		}
+		safe_headroom_scope(const safe_headroom_scope&) = delete;
+		safe_headroom_scope& operator=(const safe_headroom_scope&) = delete;
+		~safe_headroom_scope() {
+			safeintegralop::details::current_headroom_site() = previous;
+		}
+};
+
+#endif // SAFEINTEGRAL_SAFEHEADROOM_HPP
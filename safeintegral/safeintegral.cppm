@@ -0,0 +1,87 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// C++20 module interface unit, exports the same entities as the headers.
+// Usage:
+//  import safeintegral;
+module;
+
+// standard headers used by the library belong to the global module fragment,
+// their include guards keep them from being attached to the module below
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <ratio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if (defined(__AVX512VNNI__) && defined(__AVX512BW__)) || defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if  __cplusplus > 201402L
+#include <optional>
+#endif
+
+export module safeintegral;
+
+export {
+#include "safeintegral.hpp"
+#include "safeintegralop.hpp"
+#include "safedivider.hpp"
+#include "saferange.hpp"
+#include "safeblock.hpp"
+#include "safeintegralop_cmp_span.hpp"
+#include "safebuffer.hpp"
+#include "safespan.hpp"
+#include "safescan.hpp"
+#include "safedot.hpp"
+// GCC 12 crashes (internal compiler error) on a thread_local variable with a non-trivial destructor in a module interface
+#if !defined(__GNUC__) || defined(__clang__) || __GNUC__ > 12
+#include "safeheadroom.hpp"
+#endif
+#include "safecolumn.hpp"
+#include "safepacked.hpp"
+#include "safevarint.hpp"
+#include "safereader.hpp"
+#include "safeextents.hpp"
+#include "safechrono.hpp"
+#include "safeaccumulator.hpp"
+}
@@ -23,6 +23,27 @@
 #include <type_traits>
 #include <stdexcept>
 
+// If SAFE_INTEGRAL_PROFILE_HEADROOM is defined, the result of every operation that can overflow is recorded in the
+// headroom statistics (see safeheadroom.hpp). It needs to be defined in every translation unit of the program.
+#if defined( SAFE_INTEGRAL_PROFILE_HEADROOM )
+#include "safeheadroom.hpp"
+#define SAFE_INTEGRAL_HEADROOM(T, v) safeintegralop::details::headroom_result<T>(v)
+#define SAFE_INTEGRAL_RECORD_HEADROOM(v) safeintegralop::record_headroom(v)
+#else
+#define SAFE_INTEGRAL_HEADROOM(T, v) (v)
+#define SAFE_INTEGRAL_RECORD_HEADROOM(v) static_cast<void>(0)
+#endif
+
+    /// Tag for the constructor of safe_integral that does not initialize the value
+    struct safe_uninitialized_t {
+		explicit safe_uninitialized_t() = default;
+    };
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+    inline constexpr safe_uninitialized_t safe_uninitialized{}; // external linkage, like std::nullopt
+#else
+    constexpr safe_uninitialized_t safe_uninitialized{};
+#endif
+
     /// This class rappresents an integral ot type T, that has no undefined behaviour. If an unsupported operation should
     // occur (like division by 0), or an overflow, an exception is throw.
     template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
@@ -54,6 +75,15 @@
 #else
 		constexpr safe_integral() noexcept : m(T{0}){}
 #endif
+		/// Constructor
+		/// The value is not initialized, and needs to be assigned before being read.
+		/// Unlike DONT_INIT_DEFAULT_CONSTRUCTOR_SAFEINTEGRAL, it affects only the objects created with this constructor
+		/// Example Usage:
+		/// @code
+		/// 	safe_integral<int> i(safe_uninitialized);
+		/// @endcode
+		explicit safe_integral(safe_uninitialized_t) noexcept {}
+
 		//template<typename U>
 		//safe_integral(U) = delete; // we do not want implicit conversion --> but we need them for generic algorithms ...
 
@@ -66,6 +96,17 @@
 		/// @endcode
 		constexpr safe_integral(T i) noexcept : m(i) { }
 
+		/// Constructor
+		/// Converts a safe_integral of another integral type U, if the value cannot be represented by T an exception is thrown
+		/// This constructor is explicit, like the conversions between integral types with static_cast
+		/// Example Usage:
+		/// @code
+		/// 	auto i = static_cast<safe_integral<int>>(safe_integral<long>(5));
+		/// @endcode
+		template<typename U, class = typename std::enable_if<!std::is_same<U, T>::value>::type>
+		constexpr explicit safe_integral(const safe_integral<U> other) :
+		    m(safeintegralop::in_range<T>(other.getvalue()) ? static_cast<T>(other.getvalue()) : throw std::out_of_range("overflow with conversion")) { }
+
 		/// Copy constructor
 		/// Example Usage:
 		/// @code
@@ -98,6 +139,7 @@
 				throw std::out_of_range("overflow with operator+=");
 			}
 			this->m += rhs.m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -117,6 +159,7 @@
 				throw std::out_of_range("overflow with operator-=");
 			}
 			this->m -= rhs.m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -136,6 +179,7 @@
 				throw std::out_of_range("overflow with operator*=");
 			}
 			this->m *= rhs.m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -155,6 +199,7 @@
 				throw std::out_of_range("overflow with operator/=");
 			}
 			this->m /= rhs.m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -174,6 +219,7 @@
 				throw std::out_of_range("overflow with operator%=");
 			}
 			this->m %= rhs.m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -185,7 +231,8 @@
 			if (!safeintegralop::is_safe_leftshift(this->m, rhs.m)) {
 				throw std::out_of_range("overflow with operator<<=");
 			}
-			this->m %= rhs.m;
+			this->m <<= rhs.m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -206,6 +253,7 @@
 				throw std::out_of_range("overflow with operator++()");
 			}
 			++this->m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -229,6 +277,7 @@
 				throw std::out_of_range("overflow with operator--()");
 			}
 			--this->m;
+			SAFE_INTEGRAL_RECORD_HEADROOM(this->m);
 			return *this;
 		}
 
@@ -266,7 +315,7 @@
 		/// @endcode
 		constexpr safe_integral operator-() const {
 			return
-			    safeintegralop::is_safe_diff(0, this->m) ? safe_integral(-this->m) :
+			    safeintegralop::is_safe_diff(T{0}, this->m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, -this->m)) :
 			    throw std::out_of_range("overflow with unary operator-");
 		}
 
@@ -280,7 +329,7 @@
 		/// @endcode
 		constexpr friend safe_integral operator+(safe_integral lhs, const safe_integral &rhs) {
 			return
-			    safeintegralop::is_safe_add(lhs.m, rhs.m) ? safe_integral(lhs.m + rhs.m) :
+			    safeintegralop::is_safe_add(lhs.m, rhs.m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m + rhs.m)) :
 			    throw std::out_of_range("overflow with operator+");
 		}
 
@@ -294,7 +343,7 @@
 		/// @endcode
 		constexpr friend safe_integral operator-(safe_integral lhs, const safe_integral &rhs) {
 			return
-			    safeintegralop::is_safe_diff(lhs.m, rhs.m) ? safe_integral(lhs.m - rhs.m) :
+			    safeintegralop::is_safe_diff(lhs.m, rhs.m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m - rhs.m)) :
 			    throw std::out_of_range("overflow with operator-");
 		}
 
@@ -308,7 +357,7 @@
 		/// @endcode
 		constexpr friend safe_integral operator/(safe_integral lhs, const safe_integral &rhs) {
 			return
-			    safeintegralop::is_safe_div(lhs.m, rhs.m) ? safe_integral(lhs.m / rhs.m) :
+			    safeintegralop::is_safe_div(lhs.m, rhs.m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m / rhs.m)) :
 			    throw std::out_of_range("overflow with operator/");
 		}
 
@@ -321,7 +370,7 @@
 		///		assert(i == safe_integral<int>(25));
 		/// @endcode
 		constexpr friend safe_integral operator*(safe_integral lhs, const safe_integral &rhs) {
-			return safeintegralop::is_safe_mult(lhs.m, rhs.m) ? safe_integral(lhs.m * rhs.m) :
+			return safeintegralop::is_safe_mult(lhs.m, rhs.m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m * rhs.m)) :
 			         throw std::out_of_range("overflow with operator*");
 		}
 
@@ -334,7 +383,7 @@
 		///		assert(i == safe_integral<int>(0));
 		/// @endcode
 		constexpr friend safe_integral operator%(safe_integral lhs, const safe_integral &rhs) {
-			return safeintegralop::is_safe_mod(lhs.m, rhs.m) ? safe_integral(lhs.m % rhs.m) :
+			return safeintegralop::is_safe_mod(lhs.m, rhs.m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m % rhs.m)) :
 			         throw std::out_of_range("overflow with operator%");
 		}
 
@@ -356,7 +405,7 @@
 
 		constexpr friend safe_integral operator<<(safe_integral lhs, const safe_integral &rhs) {
 			return
-			    safeintegralop::is_safe_leftshift(lhs.m, rhs.m) ? safe_integral(lhs.m << rhs.m) :
+			    safeintegralop::is_safe_leftshift(lhs.m, rhs.m) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m << rhs.m)) :
 			    throw std::out_of_range("overflow with operator<<");
 		}
 
@@ -366,6 +415,54 @@
 			    throw std::out_of_range("overflow with operator>>");
 		}
 
+		/// Operator / with a compile-time constant divisor
+		/// The divisor is validated at compile time, only a division by -1 needs a runtime check
+		///
+		/// Example Usage:
+		/// @code
+		/// 	auto i = safe_integral<int>(5000) / std::integral_constant<int, 1000>{};
+		///		assert(i == safe_integral<int>(5));
+		/// @endcode
+		template<typename U, U V>
+		constexpr friend safe_integral operator/(safe_integral lhs, const std::integral_constant<U, V>) {
+			static_assert(safeintegralop::in_range<T>(V), "the divisor cannot be represented by T");
+			static_assert(V != U{0}, "division by 0");
+			return
+			    safeintegralop::is_safe_div(lhs.m, std::integral_constant<T, T(V)>{}) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m / T(V))) :
+			    throw std::out_of_range("overflow with operator/");
+		}
+
+		/// Operator % with a compile-time constant divisor
+		/// The divisor is validated at compile time, only a division by -1 needs a runtime check
+		template<typename U, U V>
+		constexpr friend safe_integral operator%(safe_integral lhs, const std::integral_constant<U, V>) {
+			static_assert(safeintegralop::in_range<T>(V), "the divisor cannot be represented by T");
+			static_assert(V != U{0}, "division by 0");
+			return
+			    safeintegralop::is_safe_mod(lhs.m, std::integral_constant<T, T(V)>{}) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m % T(V))) :
+			    throw std::out_of_range("overflow with operator%");
+		}
+
+		/// Operator << with a compile-time constant shift count
+		/// The shift count is validated at compile time, the value is checked with a single comparison
+		template<typename U, U V>
+		constexpr friend safe_integral operator<<(safe_integral lhs, const std::integral_constant<U, V>) {
+			static_assert(!safeintegralop::cmp_less(V, 0) && safeintegralop::cmp_less(V, std::numeric_limits<T>::digits), "invalid shift count");
+			return
+			    safeintegralop::is_safe_leftshift(lhs.m, std::integral_constant<T, T(V)>{}) ? safe_integral(SAFE_INTEGRAL_HEADROOM(T, lhs.m << V)) :
+			    throw std::out_of_range("overflow with operator<<");
+		}
+
+		/// Operator >> with a compile-time constant shift count
+		/// The shift count is validated at compile time
+		template<typename U, U V>
+		constexpr friend safe_integral operator>>(safe_integral lhs, const std::integral_constant<U, V>) {
+			static_assert(!safeintegralop::cmp_less(V, 0) && safeintegralop::cmp_less(V, std::numeric_limits<T>::digits + (std::is_signed<T>::value ? 1 : 0)), "invalid shift count");
+			return
+			    safeintegralop::is_safe_rightshift(lhs.m, std::integral_constant<T, T(V)>{}) ? safe_integral(lhs.m >> V) :
+			    throw std::out_of_range("overflow with operator>>");
+		}
+
 		constexpr friend bool operator<(const safe_integral &lhs, const safe_integral &rhs) noexcept {
 			return (lhs.m < rhs.m);
 		}
@@ -401,12 +498,16 @@
 		return safe_integral<T>(i);
 	}
 
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	/// Compile-time constant operand for the operators /, %, << and >>
+	/// Example Usage:
+	/// @code
+	/// 	auto i = safe_integral<long>(3600) / safe_constant<60>;
+	/// @endcode
+	template<auto V>
+	constexpr std::integral_constant<decltype(V), V> safe_constant{};
+#endif
 
-	inline void compile_self_test(){
-		auto one = safe_integral<int>(1);
-		auto two = safe_integral<int>(2);
-		static_assert( noexcept(std::swap(one, two)) , "throwing swap" );
-	}
 
 	using safe_short     = safe_integral<short>;
 	using safe_int       = safe_integral<int>;
@@ -421,5 +522,8 @@
 	static_assert(sizeof(safe_short)     == sizeof(short),              "size are not the same");
 	static_assert(sizeof(safe_int)       == sizeof(int),                "size are not the same");
 	static_assert(sizeof(safe_ulonglong) == sizeof(unsigned long long), "size are not the same");
+	// copying or relocating arrays of safe_integral can be done with memcpy/memmove
+	static_assert(std::is_trivially_copyable<safe_int>::value, "not trivially copyable");
+	static_assert(std::is_trivially_destructible<safe_int>::value, "not trivially destructible");
 
 #endif //SAFEMATH_SAFEMATH_H
@@ -17,9 +17,7 @@
 #ifndef SAFEOPERATIONS_H
 #define SAFEOPERATIONS_H
 
-#if  __cplusplus > 201402L // compiling with c++17 or greater
 #include "safeintegralop2.hpp"
-#endif
 
 #include "errors.hpp"
 #include "safeintegralop_cmp.hpp"
@@ -100,7 +98,7 @@ namespace safeintegralop {
 		template <typename T>
 		constexpr bool is_safe_mod_signed(const T a, const T b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T);
-			return (b == T{-1}) ? (a != std::numeric_limits<T>::min()) :  (b != T{0});
+			return (b == static_cast<T>(-1)) ? (a != std::numeric_limits<T>::min()) :  (b != T{0});
 		}
 
 		template <typename T>
@@ -117,9 +115,11 @@ namespace safeintegralop {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T);
 			return
 			    (a==T{0} || b== T{0} || b==T{1} || a == T{1}) ? true :
-			    (b==T{-1}) ? a != std::numeric_limits<T>::min() : // a/-1 == a*-1 --> overflow if a == minvalue
-			    (b>T{-1} && b<T{1}) ? true :
-			    ( (a <= std::numeric_limits<T>::max() / b) && (a >= std::numeric_limits<T>::min() / b)); // |b| >1, espansione
+			    (b==static_cast<T>(-1)) ? a != std::numeric_limits<T>::min() : // a/-1 == a*-1 --> overflow if a == minvalue
+			    (b>static_cast<T>(-1) && b<T{1}) ? true :
+			    // |b| >1, espansione: |a|*|b| must not exceed |max| (positive result) or |min| (negative result)
+			    (safe_abs(a) <= typename std::make_unsigned<T>::type(
+			        safe_abs(std::numeric_limits<T>::max()) + typename std::make_unsigned<T>::type((a < T{0}) != (b < T{0}))) / safe_abs(b));
 		}
 
 		template <typename T>
@@ -138,8 +138,8 @@ namespace safeintegralop {
 			return
 			    (a == T{0} || b == T{1}) ? true :
 			    (b == T{0}) ? false :
-			    (b == T{-1}) ? (a != std::numeric_limits<T>::min()) :
-			    (b>T{1} || b<T{-1}) ? true :
+			    (b == static_cast<T>(-1)) ? (a != std::numeric_limits<T>::min()) :
+			    (b>T{1} || b<static_cast<T>(-1)) ? true :
 			    ( (a < std::numeric_limits<T>::max() * b) && (a > std::numeric_limits<T>::min() * b));
 		}
 
@@ -227,6 +227,47 @@ namespace safeintegralop {
 		return std::is_unsigned<T>::value ? details::is_safe_rightshift_unsigned(a,b) : details::is_safe_rightshift_signed(a,b);
 	}
 
+	/// Overloads for a compile-time constant second operand, for example a divisor or a shift count
+	/// The checks that depend only on the constant are resolved at compile time, i.e. dividing by a constant different from
+	/// 0 and -1 does not need any runtime check
+	/// Usage:
+	///  if(is_safe_div(i, std::integral_constant<int, 1000>{})){
+	///   ...
+	///  }
+	template <typename T, T V>
+	constexpr bool is_safe_div(const T a, const std::integral_constant<T, V>) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T);
+		return
+		    (V == T{0}) ? false :
+		    (std::is_signed<T>::value && V == static_cast<T>(-1)) ? (a != std::numeric_limits<T>::min()) :
+		    true;
+	}
+
+	template <typename T, T V>
+	constexpr bool is_safe_mod(const T a, const std::integral_constant<T, V> b) noexcept {
+		return is_safe_div(a, b);
+	}
+
+	/// The value range is checked with a single (unsigned) comparison, since the shift count is known
+	template <typename T, T V>
+	constexpr bool is_safe_leftshift(const T a, const std::integral_constant<T, V>) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T);
+		using Tu = typename std::make_unsigned<T>::type;
+		return
+		    (cmp_less(V, 0) || !cmp_less(V, std::numeric_limits<T>::digits)) ? false :
+		    // a < 0 is a big unsigned value
+		    (static_cast<Tu>(a) <= static_cast<Tu>(std::numeric_limits<T>::max() >> V));
+	}
+
+	/// Contrary to the overload with a runtime shift count, shifting by the width of T or more is not safe
+	template <typename T, T V>
+	constexpr bool is_safe_rightshift(const T a, const std::integral_constant<T, V>) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T);
+		return
+		    (cmp_less(V, 0) || !cmp_less(V, std::numeric_limits<T>::digits + (std::is_signed<T>::value ? 1 : 0))) ? false :
+		    (std::is_unsigned<T>::value || a >= T{0});
+	}
+
 }
 
 #endif // SAFEOPERATIONS_H
@@ -23,33 +23,57 @@
 
 #include <limits>
 #include <type_traits>
+#include <cstddef>
 #include <cstdint>
 
+#if  __cplusplus > 201402L // compiling with c++17 or greater
 #include <optional>
+#endif
+
+// Every operation returns a safe_result<T0>, that holds the result and a flag, and is available since c++11 (or since
+// c++14 and c++17 for the operations implemented with loops and tables). With c++17, every operation has also an overload
+// that returns std::optional<T0> (for example safe_add<T0>(a, b) for safe_add_result<T0>(a, b)), with the same implementation.
 
 namespace safeintegralop {
 
+	/// The result of an operation of T0, that may not be representable
+	/// Contrary to std::optional, it is available since c++11, and is trivially copyable (it can be returned in registers)
+	/// Usage:
+	///  const auto res = safe_add_result<int>(i, j);
+	///  if(res){
+	///  	use(res.value);
+	///  }
+	template <typename T0>
+	struct safe_result {
+		T0 value;
+		bool ok;
+
+		/// No value
+		constexpr safe_result() noexcept : value(), ok(false) {}
+		constexpr safe_result(const T0 v) noexcept : value(v), ok(true) {}
+
+		constexpr explicit operator bool() const noexcept {
+			return ok;
+		}
+		constexpr T0 value_or(const T0 v) const noexcept {
+			return ok ? value : v;
+		}
+	};
+
 
 	// All functions in the namespace "details" are for private use
 	namespace details{
-		template <typename T0>
-		constexpr auto safe_abs(const T0 v) -> typename std::make_unsigned<T0>::type {
-			SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T0);
-			using T0_u = typename std::make_unsigned<T0>::type;
-			return v>=T0{0} ? static_cast<T0_u>(v) : static_cast<T0_u>(-(v+1))+1;
-		}
-
 		// safe_add -----------------------------
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_add_uu(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_add_uu(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 			using T0_s = typename std::make_unsigned<T0>::type;
 			using Tu = typename std::common_type<typename std::make_unsigned<T0>::type, T1, T2>::type;
-			return (Tu(a) <= std::numeric_limits<Tu>::max() - Tu(b)) && (Tu(a) + Tu(b) <= T0_s{std::numeric_limits<T0>::max()}) ? T0(Tu(a)+Tu(b)) : std::optional<T0>{};
+			return (Tu(a) <= std::numeric_limits<Tu>::max() - Tu(b)) && (Tu(a) + Tu(b) <= T0_s{std::numeric_limits<T0>::max()}) ? T0(Tu(a)+Tu(b)) : safe_result<T0>{};
 		}
 
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_add_ss(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_add_ss(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 			using Ts = typename std::common_type<typename std::make_signed<T0>::type, T1, T2>::type;
 			using Tu = typename std::common_type<typename std::make_unsigned<T0>::type, typename std::make_unsigned<T1>::type, typename std::make_unsigned<T2>::type>::type;
@@ -58,13 +82,13 @@ namespace safeintegralop {
 			return
 			  b >= T2{0} ?
 			    ( a > T1{0} ? safe_add_uu<T0>(Tu(a),Tu(b)) :
-			                  ((Ts(a) <= std::numeric_limits<Ts>::max() - Ts(b)) && safeintegralop::in_range<T0>(Ts(a) + Ts(b))) ? T0(Ts(a) + Ts(b)) : std::optional<T0>{}
+			                  ((Ts(a) <= std::numeric_limits<Ts>::max() - Ts(b)) && safeintegralop::in_range<T0>(Ts(a) + Ts(b))) ? T0(Ts(a) + Ts(b)) : safe_result<T0>{}
 			    ) :
-			    (Ts(a) >= std::numeric_limits<Ts>::min() - Ts(b) && safeintegralop::in_range<T0>(Ts(a) + Ts(b)) ? T0(Ts(a) + Ts(b)) : std::optional<T0>{} );
+			    (Ts(a) >= std::numeric_limits<Ts>::min() - Ts(b) && safeintegralop::in_range<T0>(Ts(a) + Ts(b)) ? T0(Ts(a) + Ts(b)) : safe_result<T0>{} );
 	}
 
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_add_su(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_add_su(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 			using T1_u = typename std::make_unsigned<T1>::type;
 			using Ts = typename std::common_type<typename std::make_signed<T0>::type, T1, typename std::make_signed<T2>::type>::type;
@@ -73,7 +97,7 @@ namespace safeintegralop {
 			  a>=T1{0} ? safe_add_uu<T0>(T1_u(a),b) :
 			  safeintegralop::in_range<Ts>(b) ? safe_add_ss<T0>(a, Ts(b)) :
 			  // b > max(T1) (-> b>=|min(T1)|) => b-|a| is alway ok in T2, doing a+1 to avoid possible overflow for -a, safe since a <=-1
-			  (safeintegralop::in_range<T0>(b - (T2(-(a+1))+1)) ? T0(b - (T2(-(a+1))+1)) : std::optional<T0>{});
+			  (safeintegralop::in_range<T0>(b - (T2(-(a+1))+1)) ? T0(b - (T2(-(a+1))+1)) : safe_result<T0>{});
 		}
 
 	} // end details
@@ -81,9 +105,9 @@ namespace safeintegralop {
 	/// Usage:
 	///  size_t i == ...
 	///  short j = ...
-	///  auto res = safe_add<int>(i,j); // performs i+j without causing overflows and saves the result in an int. If the result cannot be represented, it returns an empty std::optional<int>
+	///  auto res = safe_add_result<int>(i,j); // performs i+j without causing overflows and saves the result in an int. If the result cannot be represented, it returns a safe_result<int> without value
 	template <typename T0,  typename T1, typename T2>
-	constexpr std::optional<T0> safe_add(const T1 a, const T2 b) noexcept {
+	constexpr safe_result<T0> safe_add_result(const T1 a, const T2 b) noexcept {
 		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 		return
 		  (std::is_signed<T1>::value && std::is_signed<T2>::value) ? details::safe_add_ss<T0>(a,b) :
@@ -95,46 +119,46 @@ namespace safeintegralop {
 	namespace details{
 		// safe_diff -----------------------------
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_diff_ss(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_diff_ss(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
-			return b > T2{0} ? safe_add<T0>(a,-b) : safe_add<T0>(a, safe_abs(b));
+			return b > T2{0} ? safe_add_result<T0>(a,-b) : safe_add_result<T0>(a, safe_abs(b));
 		}
 
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_diff_uu(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_diff_uu(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 			using Tu = typename std::common_type<typename std::make_unsigned<T0>::type, T1, T2>::type;
 			return
-			  Tu(a)>=Tu(b) ? (safeintegralop::in_range<T0>(Tu(a) - Tu(b)) ? T0(Tu(a)-Tu(b)) : std::optional<T0>{} ) :
+			  Tu(a)>=Tu(b) ? (safeintegralop::in_range<T0>(Tu(a) - Tu(b)) ? T0(Tu(a)-Tu(b)) : safe_result<T0>{} ) :
 			  // with a=0, b = |min| or similar combinations will overflow, since b>a, b-1 is safe
-			  (safeintegralop::cmp_less_eq(Tu(b) - Tu(a), safe_abs(std::numeric_limits<T0>::min())) ? -T0(Tu(b-1) - Tu(a))-1 : std::optional<T0>{});
+			  (safeintegralop::cmp_less_eq(Tu(b) - Tu(a), safe_abs(std::numeric_limits<T0>::min())) ? -T0(Tu(b-1) - Tu(a))-1 : safe_result<T0>{});
 		}
 
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_diff_su(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_diff_su(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 			using T1_u = typename std::make_unsigned<T1>::type;
 			using Tu = typename std::common_type<typename std::make_unsigned<T0>::type, typename std::make_unsigned<T1>::type, T2>::type;
 			return
 			  a >= T1{0} ? safe_diff_uu<T0>(T1_u(a),b) :
-			  // a-b == -(b+(-a))
-			  (safe_add<Tu>(Tu(b), safe_abs(a)).has_value() && safeintegralop::cmp_less_eq(Tu(b) + safe_abs(a), safe_abs(std::numeric_limits<T0>::min()))) ? -T0(Tu(b) + safe_abs(a)) : std::optional<T0>{};
+			  // a-b == -(b+(-a)), since a<0 b+(-a)>=1 and -(b+(-a)-1)-1 does not overflow if the result is min
+			  (safe_add_result<Tu>(Tu(b), safe_abs(a)).ok && safeintegralop::cmp_less_eq(Tu(b) + safe_abs(a), safe_abs(std::numeric_limits<T0>::min()))) ? -T0(Tu(b) + safe_abs(a) - 1)-1 : safe_result<T0>{};
 		}
 
 		template <typename T0,  typename T1, typename T2>
-		constexpr std::optional<T0> safe_diff_us(const T1 a, const T2 b) noexcept {
+		constexpr safe_result<T0> safe_diff_us(const T1 a, const T2 b) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 			using T2_u = typename std::make_unsigned<T2>::type;
-			return b >= T2{0} ? safe_diff_uu<T0>(a,T2_u(b)) : safe_add<T0>(a, safe_abs(b));
+			return b >= T2{0} ? safe_diff_uu<T0>(a,T2_u(b)) : safe_add_result<T0>(a, safe_abs(b));
 		}
 	} // end details
 
 	/// Usage:
 	///  int i == ...
 	///  size_t j = ...
-	///  auto res = safe_diff<short>(i,j); // performs i-j without causing overflows and saves the result in an short. If the result cannot be represented, it returns an empty std::optional<short>
+	///  auto res = safe_diff_result<short>(i,j); // performs i-j without causing overflows and saves the result in an short. If the result cannot be represented, it returns a safe_result<short> without value
 	template <typename T0,  typename T1, typename T2>
-	constexpr std::optional<T0> safe_diff(const T1 a, const T2 b) noexcept {
+	constexpr safe_result<T0> safe_diff_result(const T1 a, const T2 b) noexcept {
 		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 		return
 		  (std::is_signed<T1>::value && std::is_signed<T2>::value) ? details::safe_diff_ss<T0>(a,b) :
@@ -142,207 +166,791 @@ namespace safeintegralop {
 		  std::is_signed<T1>::value ? details::safe_diff_su<T0>(a, b) : details::safe_diff_us<T0>(a,b);
 	}
 
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// returns -m as T0, where m is the magnitude (an unsigned value) of a negative result
+		template <typename T0,  typename Tu>
+		constexpr safe_result<T0> safe_negate_magnitude(const Tu m) noexcept {
+			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,Tu);
+			return
+			  (m == Tu{0}) ? T0{0} :
+			  // if -m == min it will overflow, T0(m-1) is safe since m > 0
+			  (safeintegralop::cmp_less_eq(m, safe_abs(std::numeric_limits<T0>::min())) ? -T0(m-1)-1 : safe_result<T0>{});
+		}
+
+		// returns -m as T0, m needs to be at most |min| (-m == min does not overflow, as the halves are negated separately)
+		template <typename T0,  typename Tu>
+		constexpr T0 negate_magnitude(const Tu m) noexcept {
+			return T0(-T0(m / 2) - T0(m - m / 2));
+		}
+
+		// returns m or -m as T0, depending on negative
+		template <typename T0,  typename Tu>
+		constexpr safe_result<T0> safe_apply_sign(const Tu m, const bool negative) noexcept {
+			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,Tu);
+			return negative ? safe_negate_magnitude<T0>(m) : (safeintegralop::in_range<T0>(m) ? T0(m) : safe_result<T0>{});
+		}
+
+		// unsigned type big enough for the magnitude of a T0 and a T1, at least an unsigned int (avoids integral promotion to int)
+		template <typename T0,  typename T1>
+		using magnitude_type = typename std::common_type<unsigned int, typename std::make_unsigned<T0>::type, typename std::make_unsigned<T1>::type>::type;
+	} // end details
+
 	/// Usage:
 	///  int i == ...
 	///  size_t j = ...
-	///  auto res = safe_mult<short>(i,j); // performs i*j without causing overflows and saves the result in an short. If the result cannot be represented, it returns an empty std::optional<short>
+	///  auto res = safe_mult_result<short>(i,j); // performs i*j without causing overflows and saves the result in an short. If the result cannot be represented, it returns a safe_result<short> without value
 	template <typename T0,  typename T1, typename T2>
-	constexpr std::optional<T0> safe_mult(const T1 a, const T2 b) noexcept {
+	constexpr safe_result<T0> safe_mult_result(const T1 a, const T2 b) noexcept {
 		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 		using T0_s = typename std::make_unsigned<T0>::type;
 		return
 		  (b == T2{0}) ? T0{0} : // leaving the test "a == 0" out seems to generate less assembly, do not know if it is more efficient
 		  // max >= ab > 0 <-> |max| >= |a||b| > 0
-		  ((a > T1{0}) == (b > T2{0})) ?  (T0_s(std::numeric_limits<T0>::max()) / details::safe_abs(b) >= details::safe_abs(a) ? T0(details::safe_abs(a) * details::safe_abs(b)) : std::optional<T0>{} ) :
+		  ((a > T1{0}) == (b > T2{0})) ?  (T0_s(std::numeric_limits<T0>::max()) / details::safe_abs(b) >= details::safe_abs(a) ? T0(T0_s(details::safe_abs(a)) * T0_s(details::safe_abs(b))) : safe_result<T0>{} ) :
 		  // min <= ab < 0 <-> |min| >= |a||b| >0
-		  (details::safe_abs(std::numeric_limits<T0>::min()) / details::safe_abs(b) >= details::safe_abs(a) ? -T0(details::safe_abs(a) * details::safe_abs(b)) : std::optional<T0>{} );
+		  (details::safe_abs(std::numeric_limits<T0>::min()) / details::safe_abs(b) >= details::safe_abs(a) ? details::negate_magnitude<T0>(T0_s(T0_s(details::safe_abs(a)) * T0_s(details::safe_abs(b)))) : safe_result<T0>{} );
 	}
 
 	/// Usage:
 	///  int i == ...
 	///  size_t j = ...
-	///  auto res = safe_div<short>(i,j); // performs i/j without causing overflows and saves the result in an short. If the result cannot be represented, it returns an empty std::optional<short>
+	///  auto res = safe_div_result<short>(i,j); // performs i/j without causing overflows and saves the result in an short. If the result cannot be represented, it returns a safe_result<short> without value
 	template <typename T0,  typename T1, typename T2>
-	constexpr std::optional<T0> safe_div(const T1 a, const T2 b) noexcept {
+	constexpr safe_result<T0> safe_div_result(const T1 a, const T2 b) noexcept {
 		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
 		using T0_s = typename std::make_unsigned<T0>::type;
 		return
-		  (b == T2{0}) ? std::optional<T0>{} :
-		  ((a > T1{0}) == (b > T2{0})) ? (details::safe_abs(a)/details::safe_abs(b) <= T0_s{std::numeric_limits<T0>::max()} ? T0(details::safe_abs(a)/details::safe_abs(b)) : std::optional<T0>{}):
+		  (b == T2{0}) ? safe_result<T0>{} :
+		  ((a > T1{0}) == (b > T2{0})) ? (details::safe_abs(a)/details::safe_abs(b) <= T0_s{std::numeric_limits<T0>::max()} ? T0(details::safe_abs(a)/details::safe_abs(b)) : safe_result<T0>{}):
 		  details::safe_abs(a)/details::safe_abs(b) == 0 ? T0{0} :
 		  // if a/b == min it will overflow, T(|a/b|-1) is safe since |a/b| > 0
-		  (details::safe_abs(a)/details::safe_abs(b) <= details::safe_abs(std::numeric_limits<T0>::min()) ? -T0(details::safe_abs(a)/details::safe_abs(b)-1)+1 : std::optional<T0>{});
-	}
-
-	namespace ct {
-		// constants for testing
-		constexpr std::uint64_t max64u = std::numeric_limits<std::uint64_t>::max();
-		constexpr std::uint64_t min64u = std::numeric_limits<std::uint64_t>::min();
-		constexpr std::uint32_t max32u = std::numeric_limits<std::uint32_t>::max();
-		constexpr std::uint32_t max32u_1 = std::numeric_limits<std::uint32_t>::max()-1;
-		constexpr std::uint32_t min32u = std::numeric_limits<std::uint32_t>::min();
-		constexpr std::uint16_t max16u = std::numeric_limits<std::uint16_t>::max();
-		constexpr std::uint16_t min16u = std::numeric_limits<std::uint16_t>::min();
-		constexpr std::uint8_t max08u = std::numeric_limits<std::uint8_t>::max();
-		constexpr std::uint8_t max08u_1 = std::numeric_limits<std::uint8_t>::max()-1;
-		constexpr std::uint8_t min08u = std::numeric_limits<std::uint8_t>::min();
-
-		constexpr std::int64_t max64s = std::numeric_limits<std::int64_t>::max();
-		constexpr std::int64_t min64s = std::numeric_limits<std::int64_t>::min();
-		constexpr std::int32_t max32s = std::numeric_limits<std::int32_t>::max();
-		constexpr std::int32_t min32s = std::numeric_limits<std::int32_t>::min();
-		constexpr std::int32_t max32s_1 = std::numeric_limits<std::int32_t>::max()-1;
-		constexpr std::int16_t max16s = std::numeric_limits<std::int16_t>::max();
-		constexpr std::int16_t max16s_1 = std::numeric_limits<std::int16_t>::max()-1;
-		constexpr std::int16_t min16s = std::numeric_limits<std::int16_t>::min();
-		constexpr std::int8_t max08s = std::numeric_limits<std::int8_t>::max();
-		constexpr std::int8_t max08s_1 = std::numeric_limits<std::int8_t>::max()-1;
-		constexpr std::int8_t min08s = std::numeric_limits<std::int8_t>::min();
-		constexpr std::int8_t min08s_1 = std::numeric_limits<std::int8_t>::min()+1;
-
-		// safe_add -------
-		static_assert(safe_add<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 2, "dumb test");
-		static_assert(!safe_add<std::uint32_t>(max32u, std::uint32_t(1)), "overflow");
-		static_assert(safe_add<std::uint32_t>(max08u_1, std::uint32_t(1)) == max08u, "exact max");
-		static_assert(safe_add<std::uint64_t>(max32u, max32u)==2*std::uint64_t(max32u), "in range after overflow: max32u+max32u < max64u");
-		static_assert(!safe_add<std::uint32_t>(max32u, max32u), "!in range after overflow: max32u+max32u > max32u");
-
-		static_assert(safe_add<std::int32_t>(1, 1) == 2, "dumb test");
-		static_assert(!safe_add<std::int32_t>(max32s, 1), "overflow");
-		static_assert(safe_add<std::int32_t>(max32s_1, 1) == max32s, "exact max");
-		static_assert(safe_add<std::int32_t>(std::int64_t(max32s)+1, -2) == std::int64_t(max32s)-1, "in range after overflow: (max32s+1)+ (-2) < max32u");
-		static_assert(!safe_add<std::int32_t>(std::int64_t(max32s)+2, -1), "!in range after overflow: (max32s+2) + (-1) > max32s");
-
-		static_assert(safe_add<std::uint32_t>(1, 1) == 2, "dumb test");
-		static_assert(!safe_add<std::uint32_t>(max64s, 1), "overflow");
-		static_assert(safe_add<std::uint32_t>(2*std::int64_t(max32u), -std::int64_t(max32u)) == max32u, "exact max");
-		static_assert(safe_add<std::uint32_t>(std::int64_t(max32u)+1, -2) == std::int64_t(max32u)-1, "in range after overflow");
-		static_assert(safe_add<std::uint32_t>(-1, +2) == 1, "in range after overflow");
-		static_assert(safe_add<std::uint32_t>(max32s, std::int32_t(1)) == std::uint32_t(max32s)+1, "in range after overflow");
-
-		static_assert(safe_add<std::uint32_t>(1, 1u) == 2, "dumb test");
-		static_assert(!safe_add<std::uint32_t>(max64s, 1u), "overflow");
-		static_assert(safe_add<std::uint32_t>(2*std::uint64_t(max32s), -std::int64_t(max32s)) == max32s, "exact max");
-		static_assert(safe_add<std::uint32_t>(std::uint64_t(max32s)+1, -2) == max32s_1, "in range after overflow");
-		static_assert(safe_add<std::uint32_t>(-1, 2u) == 1, "in range after overflow");
-		static_assert(safe_add<std::uint32_t>(min32s, std::uint64_t(std::uint64_t(max32s)+1)) == 0, "");
-
-		// safe_diff
-		static_assert(safe_diff<std::uint32_t>(std::int32_t(1), std::int32_t(1)) == 0, "dumb test");
-		static_assert(safe_diff<std::uint32_t>(std::int32_t(2), std::int32_t(1)) == 1, "dumb test");
-		static_assert(!safe_diff<std::uint32_t>(std::int32_t(0), std::int32_t(1)), "overflow");
-		static_assert(safe_diff<std::int32_t>(std::int32_t(0), std::int32_t(1)) == -1, "dumb test");
-
-		static_assert(!safe_diff<std::int32_t>(std::int32_t(0), min32s), "overflow: 0 - min08s == 128 > max08s");
-		static_assert(safe_diff<std::uint32_t>(std::int32_t(0), min32s) == details::safe_abs(min32s), "in range after overflow: 0 - min08s == 128 < max08u");
-
-
-		static_assert(safe_diff<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 0, "dumb");
-		static_assert(safe_diff<std::uint32_t>(std::uint32_t(2), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_diff<std::uint32_t>(std::uint32_t(0), std::uint32_t(1)), "overflow: 0 - 1 = -1 < 0");
-		static_assert(safe_diff<std::int32_t>(std::uint32_t(0), std::uint32_t(1)) == -1, "no overflow");
-		static_assert(safe_diff<std::int32_t>(std::uint32_t(1), std::uint32_t(2)) == -1, "no overflow");
-
-
-		static_assert(safe_diff<std::uint32_t>(std::int32_t(2), std::uint32_t(1)) == 1, "dumb test");
-		static_assert(safe_diff<std::int32_t>(std::int32_t(2), std::uint32_t(1)) == 1, "dumb test");
-		static_assert(!safe_diff<std::uint32_t>(std::int32_t(0), std::uint32_t(1)), "overflow");
-		static_assert(safe_diff<std::int32_t>(std::int32_t(0), std::uint32_t(1)) == -1, "dumb test");
-
-		static_assert(!safe_diff<std::uint32_t>(std::int32_t(-2), std::uint32_t(1)), "dumb test");
-		static_assert(safe_diff<std::int32_t>(std::int32_t(-1), std::uint32_t(1)) == -2, "dumb test");
-		static_assert(!safe_diff<std::int32_t>(max64s, 0), "dumb test");
-
-		static_assert(safe_diff<std::uint32_t>(std::uint32_t(1), std::int32_t(1)) == 0, "dumb test");
-		static_assert(!safe_diff<std::uint32_t>(std::uint32_t(1), std::int32_t(2)), "dumb test");
-		static_assert(safe_diff<std::uint32_t>(std::uint32_t(1), std::int32_t(-1)) == 2, "dumb test");
-		static_assert(safe_diff<std::uint32_t>(std::uint32_t(2), std::int32_t(-1)) == 3, "dumb test");
-		static_assert(safe_diff<std::int32_t>(std::uint32_t(1), std::int32_t(-1)) == 2, "dumb test");
-		static_assert(safe_diff<std::int32_t>(std::uint32_t(2), std::int32_t(-1)) == 3, "dumb test");
-		static_assert(!safe_diff<std::int32_t>(max32u, std::int32_t(-1)), "dumb test");
-		static_assert(safe_diff<std::uint32_t>(max32u_1, std::int32_t(-1)) == max32u, "dumb test");
-		static_assert(!safe_diff<std::int32_t>(max64u, 0), "dumb test");
-
-		// safe_mult
-		static_assert(safe_mult<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(safe_mult<std::uint32_t>(max32u, std::uint32_t(0)) == 0, "dumb");
-		static_assert(safe_mult<std::uint32_t>(max32u, std::uint32_t(1)) == max32u, "dumb");
-		static_assert(!safe_mult<std::uint32_t>(max32u, std::uint32_t(2)), "dumb");
-
-		static_assert(safe_mult<std::int32_t>(std::int32_t(1), std::int32_t(1)) == 1, "dumb");
-		static_assert(safe_mult<std::int32_t>(max64s, std::int32_t(0)) == 0, "dumb");
-		static_assert(safe_mult<std::int32_t>(max32s, std::int32_t(1)) == max32s, "dumb");
-		static_assert(!safe_mult<std::int32_t>(max32s, std::int32_t(2)), "dumb");
-
-		static_assert(safe_mult<std::int32_t>(std::int32_t(-1), std::int32_t(1)) == -1, "dumb");
-		static_assert(safe_mult<std::int32_t>(max64s, std::int32_t(0)) == 0, "dumb");
-		static_assert(!safe_mult<std::int32_t>(min32s, std::int32_t(-1)), "dumb");
-		static_assert(safe_mult<std::int32_t>(max32s, std::int32_t(-1)) == -max32s, "dumb");
-		static_assert(!safe_mult<std::int32_t>(max32s, std::int32_t(-2)), "dumb");
-
-		static_assert(!safe_mult<std::uint32_t>(std::int32_t(-1), std::int32_t(1)), "dumb");
-		static_assert(safe_mult<std::uint32_t>(max64s, std::int32_t(0)) == 0, "dumb");
-		static_assert(safe_mult<std::uint32_t>(min32s, std::int32_t(-1)) == details::safe_abs(min32s), "dumb");
-		static_assert(safe_mult<std::uint32_t>(min32s, std::int32_t(0)) == 0, "dumb");
-		static_assert(!safe_mult<std::uint32_t>(max32s, std::int32_t(-1)), "dumb");
-		static_assert(safe_mult<std::uint32_t>(max32s, std::int32_t(2)) == 2*std::uint32_t(max32s), "dumb");
-
-		static_assert(safe_mult<std::int32_t>(std::int32_t(-1), std::uint32_t(1)) == -1, "dumb");
-		static_assert(safe_mult<std::int32_t>(max64s, std::int32_t(0)) == 0, "dumb");
-		static_assert(!safe_mult<std::int32_t>(std::int32_t(-1), max64s), "dumb");
-		static_assert(safe_mult<std::int32_t>(std::int32_t(-1), max32s) == -max32s, "dumb");
-		static_assert(!safe_mult<std::int32_t>(std::uint32_t(-2), max32s), "dumb");
-
-		static_assert(!safe_mult<std::uint32_t>(std::int32_t(-1), std::uint32_t(1)), "dumb");
-		static_assert(safe_mult<std::uint32_t>(max32s, std::uint32_t(0)) == 0, "dumb");
-		static_assert(safe_mult<std::uint32_t>(min32s, std::uint32_t(0)) == 0, "dumb");
-		static_assert(!safe_mult<std::uint32_t>(std::int32_t(-1), max32s), "dumb");
-		static_assert(safe_mult<std::uint32_t>(max32s, std::uint32_t(2)) == 2*std::uint32_t(max32s), "dumb");
-
-
-		// safe_div
-		static_assert(safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
-		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(1))==max32u, "dumb");
-		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(2))==max32u/2, "dumb");
-		static_assert(!safe_div<std::uint32_t>(max64u, std::uint32_t(2)), "dumb");
-		static_assert(safe_div<std::uint32_t>(max64u, max64u)==1, "dumb");
-
-		static_assert(safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
-		static_assert(safe_div<std::int32_t>(std::uint32_t(max32s), std::uint32_t(1)) == max32s, "dumb");
-		static_assert(safe_div<std::int32_t>(std::uint32_t(max32s), std::uint32_t(2)) == max32s/2, "dumb");
-		static_assert(!safe_div<std::int32_t>(max64u, std::uint32_t(2)), "dumb");
-		static_assert(safe_div<std::int32_t>(max64u, max64u)==1, "dumb");
-
-		static_assert(safe_div<std::int32_t>(std::int32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_div<std::int32_t>(std::int32_t(1), std::uint32_t(0)), "dumb");
-		static_assert(safe_div<std::int32_t>(max32s, std::uint32_t(1)) == max32s, "dumb");
-		static_assert(safe_div<std::int32_t>(max32s, std::uint32_t(2)) == max32s/2, "dumb");
-		static_assert(!safe_div<std::int32_t>(max64u, std::uint32_t(2)), "dumb");
-		static_assert(safe_div<std::int32_t>(max64s, std::uint64_t(max64s)) == 1, "dumb");
-
-		static_assert(safe_div<std::uint32_t>(std::int32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_div<std::uint32_t>(std::int32_t(1), std::uint32_t(0)), "dumb");
-		static_assert(safe_div<std::uint32_t>(max32s, std::uint32_t(1)) == max32s, "dumb");
-		static_assert(safe_div<std::uint32_t>(max32s, std::uint32_t(2)) == max32s/2, "dumb");
-		static_assert(!safe_div<std::uint32_t>(max64u, std::uint32_t(2)), "dumb");
-		static_assert(safe_div<std::uint32_t>(max64s, std::uint64_t(max64s)) == 1, "dumb");
-
-		static_assert(safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
-		static_assert(!safe_div<std::int32_t>(max32u, std::uint32_t(1)), "dumb");
-		static_assert(safe_div<std::int32_t>(max32u, std::uint32_t(2)) == max32u/2, "dumb");
-		static_assert(!safe_div<std::int32_t>(max64u, std::uint32_t(2)), "dumb");
-		static_assert(safe_div<std::int32_t>(max64u, std::uint64_t(max64s)) == max64u/std::uint64_t(max64s), "dumb");
-
-		static_assert(safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
-		static_assert(!safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
-		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(1)) == max32u, "dumb");
-		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(2)) == max32u/2, "dumb");
-		static_assert(!safe_div<std::uint32_t>(max64u, std::uint32_t(2)), "dumb");
-		static_assert(safe_div<std::uint32_t>(max64u, std::uint64_t(max64s)) == max64u/std::uint64_t(max64s), "dumb");
+		  (details::safe_abs(a)/details::safe_abs(b) <= details::safe_abs(std::numeric_limits<T0>::min()) ? -T0(details::safe_abs(a)/details::safe_abs(b)-1)-1 : safe_result<T0>{});
+	}
+
+
+	/// Usage:
+	///  int i == ...
+	///  size_t j = ...
+	///  auto res = safe_mod_result<short>(i,j); // performs i%j without causing overflows and saves the result in an short. If the result cannot be represented, or j == 0, it returns a safe_result<short> without value
+	/// The result has the same sign as i, like the builtin operator%. Contrary to the builtin operator, min%-1 is valid (== 0)
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_mod_result(const T1 a, const T2 b) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T1, T2>;
+		return
+		  (b == T2{0}) ? safe_result<T0>{} :
+		  // |a%b| < |b| and |a%b| <= |a|
+		  details::safe_apply_sign<T0>(Tu(Tu(details::safe_abs(a)) % Tu(details::safe_abs(b))), a < T1{0});
+	}
+
+	/// Usage:
+	///  int i == ...
+	///  size_t j = ...
+	///  auto res = safe_neg_result<unsigned int>(i); // performs -i without causing overflows and saves the result in an unsigned int. If the result cannot be represented, it returns a safe_result<unsigned int> without value
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_neg_result(const T1 a) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		return details::safe_apply_sign<T0>(details::safe_abs(a), a > T1{0});
+	}
+
+	/// Usage:
+	///  int i == ...
+	///  auto res = safe_abs_result<unsigned int>(i); // calculates |i| without causing overflows and saves the result in an unsigned int. If the result cannot be represented, it returns a safe_result<unsigned int> without value
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_abs_result(const T1 a) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		return safeintegralop::in_range<T0>(details::safe_abs(a)) ? T0(details::safe_abs(a)) : safe_result<T0>{};
+	}
+
+	/// Usage:
+	///  size_t i == ...
+	///  auto res = safe_cast_result<DWORD>(i); // converts i to a DWORD. If the value cannot be represented, it returns a safe_result<DWORD> without value
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_cast_result(const T1 a) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		return safeintegralop::in_range<T0>(a) ? T0(a) : safe_result<T0>{};
+	}
+
+	/// Usage:
+	///  int i == ...
+	///  int j = ...
+	///  auto res = safe_shl_result<long>(i,j); // calculates i*2^j without causing overflows and saves the result in a long. If the result cannot be represented, or j < 0, it returns a safe_result<long> without value
+	/// Contrary to the builtin operator<<, negative values of i are valid
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_shl_result(const T1 a, const T2 b) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T0, T1>;
+		return
+		  safeintegralop::cmp_less(b, 0) ? safe_result<T0>{} :
+		  !safeintegralop::cmp_less(b, std::numeric_limits<Tu>::digits) ? (a == T1{0} ? T0{0} : safe_result<T0>{}) :
+		  (Tu(details::safe_abs(a)) <= (std::numeric_limits<Tu>::max() >> b)) ? details::safe_apply_sign<T0>(Tu(Tu(details::safe_abs(a)) << b), a < T1{0}) :
+		  safe_result<T0>{};
+	}
+
+	/// Usage:
+	///  int i == ...
+	///  int j = ...
+	///  auto res = safe_shr_result<short>(i,j); // calculates floor(i/2^j) and saves the result in a short. If the result cannot be represented, or j < 0, it returns a safe_result<short> without value
+	/// Contrary to the builtin operator>>, negative values of i are valid (rounded towards negative infinity, like an arithmetic shift)
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_shr_result(const T1 a, const T2 b) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T0, T1>;
+		return
+		  safeintegralop::cmp_less(b, 0) ? safe_result<T0>{} :
+		  !safeintegralop::cmp_less(b, std::numeric_limits<Tu>::digits) ? (a < T1{0} ? details::safe_negate_magnitude<T0>(Tu{1}) : T0{0}) :
+		  (a >= T1{0}) ? details::safe_apply_sign<T0>(Tu(Tu(details::safe_abs(a)) >> b), false) :
+		  // floor(a/2^b) == -ceil(|a|/2^b) == -(((|a|-1) >> b) + 1), |a|-1 is safe since a < 0
+		  details::safe_negate_magnitude<T0>(Tu((Tu(details::safe_abs(a)) - 1) >> b) + 1);
+	}
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// applies the sign to a magnitude that is known to be representable by T0
+		template <typename T0,  typename Tu>
+		constexpr T0 apply_sign_unchecked(const Tu m, const bool negative) noexcept {
+			return (negative && m != Tu{0}) ? T0(-T0(m-1)-1) : T0(m);
+		}
+
+		// a/V is monotonic in a, if it can be represented for the extremes of T1, it can be represented for every a
+		template <typename T0,  typename T1, typename T2, T2 V>
+		constexpr bool is_always_safe_div() noexcept {
+			return safe_div_result<T0>(std::numeric_limits<T1>::min(), V).ok && safe_div_result<T0>(std::numeric_limits<T1>::max(), V).ok;
+		}
+
+		// |a%V| <= min(|a|, |V|-1), and has the same sign of a
+		template <typename T0,  typename T1, typename T2, T2 V>
+		constexpr bool is_always_safe_mod() noexcept {
+			return
+			  (cmp_less_eq(safe_abs(V)-1, std::numeric_limits<T0>::max()) || cmp_less_eq(std::numeric_limits<T1>::max(), std::numeric_limits<T0>::max())) &&
+			  (cmp_less_eq(safe_abs(V)-1, safe_abs(std::numeric_limits<T0>::min())) || cmp_less_eq(safe_abs(std::numeric_limits<T1>::min()), safe_abs(std::numeric_limits<T0>::min())));
+		}
+
+		template <typename T0,  typename T1, typename T2, T2 V>
+		constexpr safe_result<T0> safe_div_constant(const T1 a, std::true_type) noexcept {
+			return apply_sign_unchecked<T0>(safe_abs(a) / safe_abs(V), (a < T1{0}) != (V < T2{0}));
+		}
+
+		template <typename T0,  typename T1, typename T2, T2 V>
+		constexpr safe_result<T0> safe_div_constant(const T1 a, std::false_type) noexcept {
+			return safe_div_result<T0>(a, V);
+		}
+
+		template <typename T0,  typename T1, typename T2, T2 V>
+		constexpr safe_result<T0> safe_mod_constant(const T1 a, std::true_type) noexcept {
+			return apply_sign_unchecked<T0>(safe_abs(a) % safe_abs(V), a < T1{0});
+		}
+
+		template <typename T0,  typename T1, typename T2, T2 V>
+		constexpr safe_result<T0> safe_mod_constant(const T1 a, std::false_type) noexcept {
+			return safe_mod_result<T0>(a, V);
+		}
+	} // end details
+
+	/// Overload for a compile-time constant divisor
+	/// If the result can be represented by T0 for every value of T1, no check is performed at runtime, and the compiler
+	/// can replace the division with a multiplication
+	/// Usage:
+	///  int i == ...
+	///  auto res = safe_div_result<short>(i, std::integral_constant<int, 1000>{}); // always contains a value, no runtime check
+	template <typename T0,  typename T1, typename T2, T2 V>
+	constexpr safe_result<T0> safe_div_result(const T1 a, const std::integral_constant<T2, V>) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		static_assert(V != T2{0}, "division by 0");
+		return details::safe_div_constant<T0, T1, T2, V>(a, std::integral_constant<bool, details::is_always_safe_div<T0, T1, T2, V>()>{});
+	}
+
+	/// Overload for a compile-time constant divisor
+	/// If the result can be represented by T0 for every value of T1, no check is performed at runtime
+	/// Usage:
+	///  long long i == ...
+	///  auto res = safe_mod_result<short>(i, std::integral_constant<int, 60>{}); // always contains a value, no runtime check
+	template <typename T0,  typename T1, typename T2, T2 V>
+	constexpr safe_result<T0> safe_mod_result(const T1 a, const std::integral_constant<T2, V>) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		static_assert(V != T2{0}, "division by 0");
+		return details::safe_mod_constant<T0, T1, T2, V>(a, std::integral_constant<bool, details::is_always_safe_mod<T0, T1, T2, V>()>{});
+	}
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater, the tables are computed with loops and inline variables
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// base^exp with square-and-multiply, without any check
+		template <typename Tu>
+		constexpr Tu pow_unchecked(Tu base, unsigned long long exp) noexcept {
+			Tu res{1};
+			for(; exp != 0; exp >>= 1){
+				res = (exp & 1u) ? Tu(res * base) : res;
+				base = (exp > 1) ? Tu(base * base) : base;
+			}
+			return res;
+		}
+
+		// exponent known at compile time, unrolled by the compiler
+		template <unsigned long long E, typename Tu>
+		constexpr Tu pow_unrolled(const Tu base) noexcept {
+			if constexpr(E == 0){
+				return Tu{1};
+			} else if constexpr(E == 1){
+				return base;
+			} else {
+				return Tu(pow_unrolled<E / 2>(Tu(base * base)) * ((E % 2 == 1) ? base : Tu{1}));
+			}
+		}
+
+		// largest m such that m^exp <= limit, binary search with a check for every multiplication (only used at compile time)
+		template <typename Tu>
+		constexpr Tu max_base(const Tu limit, const unsigned exp) noexcept {
+			Tu lo = (limit == Tu{0}) ? Tu{0} : Tu{1};
+			Tu hi = limit;
+			while(lo < hi){
+				const Tu mid = Tu(lo + (hi - lo) / 2 + 1);
+				Tu p{1};
+				bool fits = true;
+				for(unsigned i = 0; i != exp && fits; ++i){
+					fits = (p <= limit / mid);
+					p = fits ? Tu(p * mid) : p;
+				}
+				lo = fits ? mid : lo;
+				hi = fits ? hi : Tu(mid - 1);
+			}
+			return lo;
+		}
+
+		// largest magnitude of the base for every exponent, for a positive and a negative result
+		// for exponents greater than digits, only 0 and 1 can be represented
+		template <typename T0>
+		struct pow_table {
+			using Tu = magnitude_type<T0, T0>;
+			static constexpr unsigned size = std::numeric_limits<T0>::digits + 1;
+			struct values {
+				Tu positive[size];
+				Tu negative[size];
+			};
+			static constexpr values make() noexcept {
+				values v{};
+				for(unsigned exp = 1; exp != size; ++exp){
+					v.positive[exp] = max_base(Tu(std::numeric_limits<T0>::max()), exp);
+					v.negative[exp] = max_base(Tu(safe_abs(std::numeric_limits<T0>::min())), exp);
+				}
+				return v;
+			}
+			static constexpr values table = make();
+		};
+
+		template <typename T0,  typename Tu, typename T2>
+		constexpr safe_result<T0> safe_pow_magnitude(const Tu m, const T2 exp, const bool negative) noexcept {
+			return
+			  (m <= Tu{1}) ? safe_apply_sign<T0>(m, negative) :
+			  !cmp_less(exp, pow_table<T0>::size) ? safe_result<T0>{} :
+			  // a single comparison decides if the result can be represented
+			  (m <= (negative ? pow_table<T0>::table.negative[exp] : pow_table<T0>::table.positive[exp])) ?
+			    apply_sign_unchecked<T0>(pow_unchecked(m, static_cast<unsigned long long>(exp)), negative) :
+			    safe_result<T0>{};
+		}
+	} // end details
+
+	/// Usage:
+	///  int i == ...
+	///  int j = ...
+	///  auto res = safe_pow_result<long>(i,j); // calculates i^j without causing overflows and saves the result in a long. If the result cannot be represented, or j < 0, it returns a safe_result<long> without value
+	/// The largest base for every exponent is calculated at compile time, so that the result is checked with a single
+	/// comparison, and then calculated with square-and-multiply. 0^0 == 1
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_pow_result(const T1 base, const T2 exp) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T0, T1>;
+		return
+		  cmp_less(exp, 0) ? safe_result<T0>{} :
+		  (exp == T2{0}) ? T0{1} :
+		  details::safe_pow_magnitude<T0>(Tu(details::safe_abs(base)), exp, base < T1{0} && (exp % 2 == 1));
+	}
+
+	/// Overload for a compile-time constant exponent
+	/// The multiplications are unrolled, and if the result can be represented by T0 for every value of T1, no check is
+	/// performed at runtime
+	/// Usage:
+	///  short i == ...
+	///  auto res = safe_pow_result<long long>(i, std::integral_constant<int, 3>{}); // always contains a value, no runtime check
+	template <typename T0,  typename T1, typename T2, T2 E>
+	constexpr safe_result<T0> safe_pow_result(const T1 base, const std::integral_constant<T2, E>) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		static_assert(!cmp_less(E, 0), "negative exponent");
+		using Tu = details::magnitude_type<T0, T1>;
+		using table = details::pow_table<T0>;
+		constexpr bool big = !cmp_less(E, table::size);
+		constexpr auto limit_positive = big ? Tu{1} : Tu(table::table.positive[big ? 0 : E]);
+		constexpr auto limit_negative = big ? Tu{1} : Tu(table::table.negative[big ? 0 : E]);
+		// the extremes of T1 have the biggest magnitudes
+		constexpr bool always_safe = cmp_less_eq(details::safe_abs(std::numeric_limits<T1>::max()), limit_positive) &&
+		    cmp_less_eq(details::safe_abs(std::numeric_limits<T1>::min()), (E % 2 == 1) ? limit_negative : limit_positive);
+		const Tu m = Tu(details::safe_abs(base));
+		const bool negative = base < T1{0} && (E % 2 == 1);
+		return
+		  (E == T2{0}) ? T0{1} :
+		  (m <= Tu{1}) ? details::safe_apply_sign<T0>(m, negative) :
+		  (always_safe || m <= (negative ? limit_negative : limit_positive)) ?
+		    details::apply_sign_unchecked<T0>(details::pow_unrolled<(big ? 1 : static_cast<unsigned long long>(E))>(m), negative) :
+		    safe_result<T0>{};
+	}
+
+#endif
+
+#if  __cplusplus >= 201402L // compiling with c++14 or greater, implemented with loops
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// number of trailing zero bits, x != 0
+		template <typename Tu>
+		constexpr int countr_zero(const Tu x) noexcept {
+#if defined(__GNUC__)
+			return __builtin_ctzll(x);
+#else
+			int n = 0;
+			for(Tu v = x; (v & 1u) == 0; v = Tu(v >> 1)){
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		// number of bits needed for representing x
+		template <typename Tu>
+		constexpr int bit_width(const Tu x) noexcept {
+#if defined(__GNUC__)
+			return (x == Tu{0}) ? 0 : std::numeric_limits<unsigned long long>::digits - __builtin_clzll(x);
+#else
+			int n = 0;
+			for(Tu v = x; v != 0; v = Tu(v >> 1)){
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		// binary gcd: the common powers of two are removed once, then only subtractions and shifts, no division
+		template <typename Tu>
+		constexpr Tu gcd_magnitude(Tu a, Tu b) noexcept {
+			if(a == Tu{0} || b == Tu{0}){
+				return Tu(a | b);
+			}
+			const int k = countr_zero(Tu(a | b));
+			a = Tu(a >> countr_zero(a));
+			do {
+				b = Tu(b >> countr_zero(b));
+				if(a > b){
+					const Tu t = a;
+					a = b;
+					b = t;
+				}
+				b = Tu(b - a);
+			} while(b != Tu{0});
+			return Tu(a << k);
+		}
+
+		// the value between x and y, rounded towards x
+		template <typename Tu>
+		constexpr Tu midpoint_magnitude(const Tu x, const Tu y) noexcept {
+			return (x <= y) ? Tu(x + (y - x) / 2) : Tu(x - (x - y) / 2);
+		}
+
+		// floor(sqrt(x)) with Newton's method, starting from a power of two not smaller than the result
+		// the iterations decrease monotonically until the result is reached
+		template <typename Tu>
+		constexpr Tu isqrt_magnitude(const Tu x) noexcept {
+			if(x < Tu{2}){
+				return x;
+			}
+			Tu r = Tu(Tu{1} << ((bit_width(x) + 1) / 2));
+			for(Tu next = Tu((r + x / r) / 2); next < r; next = Tu((r + x / r) / 2)){
+				r = next;
+			}
+			return r;
+		}
+	} // end details
+
+	/// Usage:
+	///  int i == ...
+	///  size_t j = ...
+	///  auto res = safe_gcd_result<int>(i,j); // calculates the greatest common divisor of i and j, and saves the result in an int. If the result cannot be represented, it returns a safe_result<int> without value
+	/// The result is never negative, gcd(0, 0) == 0. Only gcd(min, min) and gcd(min, 0) do not fit in the signed type of min
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_gcd_result(const T1 a, const T2 b) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T1, T2>;
+		return details::safe_apply_sign<T0>(details::gcd_magnitude(Tu(details::safe_abs(a)), Tu(details::safe_abs(b))), false);
+	}
+
+	/// Usage:
+	///  int i == ...
+	///  size_t j = ...
+	///  auto res = safe_lcm_result<long>(i,j); // calculates the least common multiple of i and j without causing overflows (contrary to std::lcm) and saves the result in a long. If the result cannot be represented, it returns a safe_result<long> without value
+	/// The result is never negative, lcm(i, 0) == 0
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_lcm_result(const T1 a, const T2 b) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T1, T2>;
+		const Tu ma = Tu(details::safe_abs(a));
+		const Tu mb = Tu(details::safe_abs(b));
+		return
+		  (ma == Tu{0} || mb == Tu{0}) ? T0{0} :
+		  // |a|/gcd is exact, only the multiplication can overflow
+		  safe_mult_result<T0>(Tu(ma / details::gcd_magnitude(ma, mb)), mb);
+	}
+
+	/// Usage:
+	///  int i == ...
+	///  unsigned int j = ...
+	///  auto res = safe_midpoint_result<int>(i,j); // calculates (i+j)/2 without causing overflows and saves the result in an int. If the result cannot be represented, it returns a safe_result<int> without value
+	/// Like std::midpoint, if i+j is odd the result is rounded towards i. The result is always between i and j, so it
+	/// can be represented by T0 if i and j can.
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_midpoint_result(const T1 a, const T2 b) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using Tu = details::magnitude_type<T1, T2>;
+		const Tu ma = Tu(details::safe_abs(a));
+		const Tu mb = Tu(details::safe_abs(b));
+		return
+		  ((a < T1{0}) == (b < T2{0})) ? details::safe_apply_sign<T0>(details::midpoint_magnitude(ma, mb), a < T1{0}) :
+		  // different signs: the result has the sign of the greater magnitude, and is half the difference of the
+		  // magnitudes, rounded towards a (away from zero if a has the greater magnitude)
+		  (ma > mb) ? details::safe_apply_sign<T0>(Tu((ma - mb) / 2 + (ma - mb) % 2), a < T1{0}) :
+		  details::safe_apply_sign<T0>(Tu((mb - ma) / 2), b < T2{0});
+	}
+
+	/// Usage:
+	///  long long i == ...
+	///  auto res = safe_isqrt_result<int>(i); // calculates floor(sqrt(i)) and saves the result in an int. If the result cannot be represented, or i < 0, it returns a safe_result<int> without value
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_isqrt_result(const T1 a) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		using Tu = details::magnitude_type<T1, T1>;
+		return (a < T1{0}) ? safe_result<T0>{} : details::safe_apply_sign<T0>(details::isqrt_magnitude(Tu(a)), false);
+	}
+
+	/// Greatest common divisor of the count values starting at first, 0 if count == 0
+	/// Stops as soon as the result is 1.
+	/// Usage:
+	///  auto res = safe_gcd_reduce_result<int>(v.data(), v.size()); // if the result cannot be represented, it returns a safe_result<int> without value
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_gcd_reduce_result(const T1* first, const std::size_t count) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		using Tu = details::magnitude_type<T1, T1>;
+		Tu res{0};
+		for(std::size_t i = 0; i != count && res != Tu{1}; ++i){
+			res = details::gcd_magnitude(res, Tu(details::safe_abs(first[i])));
+		}
+		return details::safe_apply_sign<T0>(res, false);
+	}
+
+	/// Least common multiple of the count values starting at first, 1 if count == 0
+	/// Stops as soon as the result is 0, or cannot be represented by T0.
+	/// Usage:
+	///  auto res = safe_lcm_reduce_result<long long>(periods.data(), periods.size()); // if the result cannot be represented, it returns a safe_result<long long> without value
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_lcm_reduce_result(const T1* first, const std::size_t count) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		safe_result<T0> res = T0{1};
+		for(std::size_t i = 0; i != count && res.ok && res.value != T0{0}; ++i){
+			res = safe_lcm_result<T0>(res.value, first[i]);
+		}
+		return res;
+	}
+
+#endif
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// n! for every n such that n! <= max(T0)
+		template <typename T0>
+		struct factorial_table {
+			using Tu = magnitude_type<T0, T0>;
+			static constexpr unsigned capacity = std::numeric_limits<T0>::digits + 1;
+			struct values {
+				Tu value[capacity];
+				unsigned size;
+			};
+			static constexpr values make() noexcept {
+				values v{};
+				v.value[0] = Tu{1};
+				v.size = 1;
+				while(v.size != capacity && v.value[v.size - 1] <= Tu(std::numeric_limits<T0>::max()) / v.size){
+					v.value[v.size] = Tu(v.value[v.size - 1] * v.size);
+					++v.size;
+				}
+				return v;
+			}
+			static constexpr values table = make();
+		};
+
+		// C(n, k) with the multiplicative formula, n >= 2k
+		// Every step calculates C(n-k+i, i) = C(n-k+i-1, i-1) * (n-k+i) / i, the division is made exact before the
+		// multiplication by reducing both operands with their gcd, so that no intermediate value is greater than C(n, k).
+		template <typename Tu>
+		constexpr Tu binomial_unchecked(const Tu n, const Tu k) noexcept {
+			Tu res{1};
+			for(Tu i{1}; i <= k; ++i){
+				const Tu g = gcd_magnitude(res, i);
+				res = Tu(Tu(res / g) * Tu(Tu(n - k + i) / Tu(i / g)));
+			}
+			return res;
+		}
+
+		// true if C(n, k) <= limit, n >= 2k (only used at compile time)
+		template <typename Tu>
+		constexpr bool binomial_fits(const Tu n, const Tu k, const Tu limit) noexcept {
+			Tu res{1};
+			for(Tu i{1}; i <= k; ++i){
+				const Tu g = gcd_magnitude(res, i);
+				const Tu a = Tu(res / g);
+				const Tu b = Tu(Tu(n - k + i) / Tu(i / g));
+				if(a > limit / b){
+					return false;
+				}
+				res = Tu(a * b);
+			}
+			return true;
+		}
+
+		// Pascal's triangle (only the first half of every row), for all rows whose values are <= max(T0), and for every k the
+		// greatest n such that C(n, k) <= max(T0), for rejecting greater values without calculating anything
+		template <typename T0>
+		struct binomial_table {
+			using Tu = magnitude_type<T0, T0>;
+			// C(n, n/2) >= 2^n/(n+1), there are less than digits+8 rows for all integral types
+			static constexpr unsigned row_capacity = std::numeric_limits<T0>::digits + 8;
+			static constexpr unsigned pascal_capacity = row_capacity + ((row_capacity - 1) * (row_capacity - 1)) / 4;
+			// C(2k, k) >= 2^k
+			static constexpr unsigned k_capacity = std::numeric_limits<T0>::digits + 1;
+			struct values {
+				Tu pascal[pascal_capacity];
+				unsigned row_offset[row_capacity + 1];
+				unsigned rows;
+				Tu max_n[k_capacity];
+				unsigned k_size;
+			};
+			static constexpr Tu get(const values& v, const unsigned n, const unsigned k) noexcept {
+				return v.pascal[v.row_offset[n] + ((k <= n / 2) ? k : n - k)];
+			}
+			static constexpr values make() noexcept {
+				constexpr Tu limit = Tu(std::numeric_limits<T0>::max());
+				values v{};
+				bool fits = true;
+				for(unsigned n = 0; n != row_capacity && fits; ++n){
+					v.row_offset[n + 1] = v.row_offset[n] + n / 2 + 1;
+					for(unsigned k = 0; k <= n / 2 && fits; ++k){
+						const Tu a = (k == 0) ? Tu{0} : get(v, n - 1, k - 1);
+						const Tu b = (k == n) ? Tu{0} : get(v, n - 1, k);
+						fits = (n == 0) || (a <= limit - b);
+						v.pascal[v.row_offset[n] + k] = (n == 0) ? Tu{1} : Tu(a + b);
+					}
+					v.rows = fits ? n + 1 : n;
+				}
+				v.max_n[0] = std::numeric_limits<Tu>::max();
+				v.k_size = 1;
+				while(v.k_size != k_capacity && binomial_fits(Tu(2 * v.k_size), Tu(v.k_size), limit)){
+					const Tu k = Tu(v.k_size);
+					Tu lo = Tu(2 * k);
+					Tu hi = limit;
+					while(lo < hi){
+						const Tu mid = Tu(lo + (hi - lo) / 2 + 1);
+						const bool mid_fits = binomial_fits(mid, k, limit);
+						lo = mid_fits ? mid : lo;
+						hi = mid_fits ? hi : Tu(mid - 1);
+					}
+					v.max_n[v.k_size] = lo;
+					++v.k_size;
+				}
+				return v;
+			}
+			static constexpr values table = make();
+		};
+	} // end details
+
+	/// Usage:
+	///  int i == ...
+	///  auto res = safe_factorial_result<long long>(i); // calculates i! and saves the result in a long long. If the result cannot be represented, or i < 0, it returns a safe_result<long long> without value
+	/// All factorials that can be represented by T0 are calculated at compile time, the result is a table lookup
+	template <typename T0,  typename T1>
+	constexpr safe_result<T0> safe_factorial_result(const T1 n) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T0,T1);
+		using table = details::factorial_table<T0>;
+		return (n >= T1{0} && cmp_less(n, table::table.size)) ? T0(table::table.value[n]) : safe_result<T0>{};
+	}
+
+	/// Usage:
+	///  int n == ...
+	///  int k == ...
+	///  auto res = safe_binomial_result<long long>(n, k); // calculates n choose k and saves the result in a long long. If the result cannot be represented, or n < 0, it returns a safe_result<long long> without value
+	/// C(n, k) == 0 if k < 0 or k > n.
+	/// The first rows of Pascal's triangle, and for every k the greatest n such that C(n, k) can be represented, are
+	/// calculated at compile time. Small values are looked up in the triangle, greater values are either rejected with a
+	/// single comparison, or calculated with the multiplicative formula, without overflows of the intermediate values.
+	template <typename T0,  typename T1, typename T2>
+	constexpr safe_result<T0> safe_binomial_result(const T1 n, const T2 k) noexcept {
+		SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE3(T0,T1,T2);
+		using table = details::binomial_table<T0>;
+		using Tu = typename table::Tu;
+		using Tn = details::magnitude_type<T1, T2>;
+		// C(n, k) == C(n, n - k)
+		const Tn kr = (n < T1{0} || k < T2{0} || cmp_less(n, k)) ? Tn{0} : ((Tn(k) <= Tn(n) / 2) ? Tn(k) : Tn(Tn(n) - Tn(k)));
+		return
+		  (n < T1{0}) ? safe_result<T0>{} :
+		  (k < T2{0} || cmp_less(n, k)) ? T0{0} :
+		  (kr == Tn{0}) ? T0{1} :
+		  cmp_less(n, table::table.rows) ? T0(table::table.pascal[table::table.row_offset[n] + kr]) :
+		  !cmp_less(kr, table::table.k_size) || cmp_less(table::table.max_n[kr], n) ? safe_result<T0>{} :
+		  T0(details::binomial_unchecked(Tu(n), Tu(kr)));
+	}
+#endif
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		template <typename T0>
+		constexpr std::optional<T0> to_optional(const safe_result<T0> res) noexcept {
+			if(!res.ok){
+				return std::nullopt;
+			}
+			return res.value;
+		}
+	} // end details
+
+	// The same operations, returning std::optional<T0>
+
+	/// Same as safe_add_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_add(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_add_result<T0>(a, b));
+	}
+
+	/// Same as safe_diff_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_diff(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_diff_result<T0>(a, b));
+	}
+
+	/// Same as safe_mult_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_mult(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_mult_result<T0>(a, b));
+	}
+
+	/// Same as safe_div_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_div(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_div_result<T0>(a, b));
+	}
+
+	/// Same as safe_mod_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_mod(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_mod_result<T0>(a, b));
+	}
+
+	/// Same as safe_div_result with a compile-time constant divisor, but returns std::optional<T0>
+	template <typename T0,  typename T1, typename T2, T2 V>
+	constexpr std::optional<T0> safe_div(const T1 a, const std::integral_constant<T2, V> c) noexcept {
+		return details::to_optional(safe_div_result<T0>(a, c));
+	}
+
+	/// Same as safe_mod_result with a compile-time constant divisor, but returns std::optional<T0>
+	template <typename T0,  typename T1, typename T2, T2 V>
+	constexpr std::optional<T0> safe_mod(const T1 a, const std::integral_constant<T2, V> c) noexcept {
+		return details::to_optional(safe_mod_result<T0>(a, c));
+	}
+
+	/// Same as safe_neg_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_neg(const T1 a) noexcept {
+		return details::to_optional(safe_neg_result<T0>(a));
+	}
+
+	/// Same as safe_abs_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_abs(const T1 a) noexcept {
+		return details::to_optional(safe_abs_result<T0>(a));
+	}
+
+	/// Same as safe_cast_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_cast(const T1 a) noexcept {
+		return details::to_optional(safe_cast_result<T0>(a));
+	}
+
+	/// Same as safe_shl_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_shl(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_shl_result<T0>(a, b));
+	}
+
+	/// Same as safe_shr_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_shr(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_shr_result<T0>(a, b));
+	}
+
+	/// Same as safe_pow_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_pow(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_pow_result<T0>(a, b));
+	}
+
+	/// Same as safe_pow_result with a compile-time constant exponent, but returns std::optional<T0>
+	template <typename T0,  typename T1, typename T2, T2 E>
+	constexpr std::optional<T0> safe_pow(const T1 a, const std::integral_constant<T2, E> c) noexcept {
+		return details::to_optional(safe_pow_result<T0>(a, c));
+	}
+
+	/// Same as safe_gcd_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_gcd(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_gcd_result<T0>(a, b));
+	}
+
+	/// Same as safe_lcm_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_lcm(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_lcm_result<T0>(a, b));
+	}
+
+	/// Same as safe_midpoint_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_midpoint(const T1 a, const T2 b) noexcept {
+		return details::to_optional(safe_midpoint_result<T0>(a, b));
+	}
+
+	/// Same as safe_isqrt_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_isqrt(const T1 a) noexcept {
+		return details::to_optional(safe_isqrt_result<T0>(a));
+	}
+
+	/// Same as safe_gcd_reduce_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_gcd_reduce(const T1* first, const std::size_t count) noexcept {
+		return details::to_optional(safe_gcd_reduce_result<T0>(first, count));
+	}
+
+	/// Same as safe_lcm_reduce_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_lcm_reduce(const T1* first, const std::size_t count) noexcept {
+		return details::to_optional(safe_lcm_reduce_result<T0>(first, count));
+	}
+
+	/// Same as safe_factorial_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1>
+	constexpr std::optional<T0> safe_factorial(const T1 n) noexcept {
+		return details::to_optional(safe_factorial_result<T0>(n));
+	}
+
+	/// Same as safe_binomial_result, but returns an empty std::optional<T0> if the result cannot be represented
+	template <typename T0,  typename T1, typename T2>
+	constexpr std::optional<T0> safe_binomial(const T1 n, const T2 k) noexcept {
+		return details::to_optional(safe_binomial_result<T0>(n, k));
 	}
+#endif
 }
 
 
@@ -27,6 +27,13 @@ namespace safeintegralop {
 
 	// All functions in the namespace "details" are for private use, you should use all the function outside of this namespace
 	namespace details{
+		// |v| as unsigned value, never overflows
+		template <typename T0>
+		constexpr auto safe_abs(const T0 v) -> typename std::make_unsigned<T0>::type {
+			SAFE_INTEGRAL_OP_ASSERT_INTEGRAL_NOT_BOOL_CHAR_TYPE(T0);
+			using T0_u = typename std::make_unsigned<T0>::type;
+			return v>=T0{0} ? static_cast<T0_u>(v) : static_cast<T0_u>(-(v+1))+1;
+		}
 
 		// could use the same implementation of in_range_signed_signed, but compiler may generate warning that t is always bigger than 0
 		template <typename R, typename T>
@@ -49,14 +56,14 @@ namespace safeintegralop {
 		constexpr bool in_range_signed_unsigned(const T t) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T,R);
 			return (t < T{ 0 }) ? false :
-			    (std::numeric_limits<T>::digits / 2 <= std::numeric_limits<R>::digits) ? true :
+			    (std::numeric_limits<T>::digits <= std::numeric_limits<R>::digits) ? true :
 			    (t <= static_cast<T>(std::numeric_limits<R>::max()));
 		}
 
 		template <typename R, typename T>
 		constexpr bool in_range_unsigned_signed(const T t) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T,R);
-			return (std::numeric_limits<T>::digits >= std::numeric_limits<R>::digits / 2) ? (t <= static_cast<T>(std::numeric_limits<R>::max())) : true;
+			return (std::numeric_limits<T>::digits > std::numeric_limits<R>::digits) ? (t <= static_cast<T>(std::numeric_limits<R>::max())) : true;
 		}
 
 		template <typename R, typename T>
@@ -79,7 +86,7 @@ namespace safeintegralop {
 		template <typename T, typename U>
 		constexpr bool cmp_equal_signed_unsigned(const T t, const U u) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T,U);
-			return (t<T{ 0 }) ? false : (std::numeric_limits<T>::digits / 2>std::numeric_limits<U>::digits) ? (t == static_cast<T>(u)) : (static_cast<U>(t) == u);
+			return (t<T{ 0 }) ? false : (std::numeric_limits<T>::digits >= std::numeric_limits<U>::digits) ? (t == static_cast<T>(u)) : (static_cast<U>(t) == u);
 		}
 
 		// equivalent of operator< for different integral types
@@ -92,13 +99,13 @@ namespace safeintegralop {
 		template <typename T, typename U>
 		constexpr bool cmp_less_signed_unsigned(const T t, const U u) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T,U);
-			return (t<T{ 0 }) ? true : (std::numeric_limits<T>::digits / 2>std::numeric_limits<U>::digits) ? (t < static_cast<T>(u)) : (static_cast<U>(t) < u);
+			return (t<T{ 0 }) ? true : (std::numeric_limits<T>::digits >= std::numeric_limits<U>::digits) ? (t < static_cast<T>(u)) : (static_cast<U>(t) < u);
 		}
 
 		template <typename T, typename U>
 		constexpr bool cmp_less_unsigned_signed(const T t, const U u) noexcept {
 			SAFE_INTEGRAL_OP_ASSERT_INTEGRALS_NOT_BOOL_CHAR_TYPE(T,U);
-			return (u<U{ 0 }) ? false : (std::numeric_limits<U>::digits / 2>std::numeric_limits<T>::digits) ? (static_cast<U>(t) < u) : (t < static_cast<T>(u));
+			return (u<U{ 0 }) ? false : (std::numeric_limits<U>::digits >= std::numeric_limits<T>::digits) ? (static_cast<U>(t) < u) : (t < static_cast<T>(u));
 		}
     } // end details
 
@@ -157,79 +164,6 @@ namespace safeintegralop {
 		return cmp_less(u,t);
 	}
 
-
-
-	namespace ct {
-
-		// Compile tests for in_range
-		static_assert(in_range<short>(1),   "in range");
-		static_assert(in_range<short>(1u),  "in range");
-		static_assert(in_range<short>(1ul), "in range");
-		static_assert(in_range<short>(-1l), "in range");
-
-
-		static_assert(!in_range<int16_t>(std::numeric_limits<uint16_t>::max()), "in range");
-		static_assert(in_range<int16_t>(std::numeric_limits<uint8_t>::max()), "in range");
-		static_assert(!in_range<uint8_t>(-1), "in range, negative value, unsigned range");
-		static_assert(in_range<int8_t>(-1), "in range, negative value, unsigned range");
-		static_assert(in_range<uint8_t>(std::numeric_limits<uint16_t>::min()), "in range");
-		static_assert(in_range<int8_t>(std::numeric_limits<uint16_t>::min()), "in range");
-		static_assert(!in_range<uint8_t>(std::numeric_limits<int16_t>::min()), "in range");
-		static_assert(!in_range<int8_t>(std::numeric_limits<int16_t>::min()), "in range");
-
-		// Compile tests for cmp_equal
-		static_assert(cmp_equal(1, 1),    "comparison same signed type, same value");
-		static_assert(cmp_equal(1u, 1u),  "comparison same unsigned type, same value (2)");
-		static_assert(cmp_equal(1ul, 1u), "comparison unsigned types, same value");
-		static_assert(cmp_equal(1u, 1ul), "comparison unsigned types, same value (2)");
-		static_assert(cmp_equal(1l, 1),   "comparison signed types, same value");
-		static_assert(cmp_equal(1, 1l),   "comparison signed types, same value (2)");
-		static_assert(cmp_equal(1ul, 1),  "comparison signed/unsigned types, same value");
-		static_assert(cmp_equal(1, 1ul),  "comparison signed/unsigned types, same value (2)");
-
-
-		static_assert(!cmp_equal(1, 2),    "comparison same signed type, different values");
-		static_assert(!cmp_equal(1, -1),   "comparison same signed type, different values (2)");
-		static_assert(!cmp_equal(1u, 2u),  "comparison same unsigned type, different values");
-		static_assert(!cmp_equal(1ul, 2u), "comparison unsigned types, different values");
-		static_assert(!cmp_equal(2u, 1ul), "comparison unsigned types, different values (2)");
-		static_assert(!cmp_equal(1l, 2),   "comparison signed types, different values");
-		static_assert(!cmp_equal(2, 1l),   "comparison signed types, different values (2)");
-		static_assert(!cmp_equal(2ul, 1),  "comparison signed/unsigned types, different values");
-		static_assert(!cmp_equal(1, 2ul),  "comparison signed/unsigned types, different values (2)");
-
-		static_assert(!cmp_equal(std::numeric_limits<uint8_t>::max(), std::numeric_limits<int8_t>::max()),
-		    "comparison unsigned/signed type");
-		static_assert(!cmp_equal(std::numeric_limits<uint8_t>::max(), -1),
-		    "comparison unsigned/signed type");
-
-
-		// Compile tests for cmp_less
-		static_assert(!cmp_less(1, 1),    "comparison same signed type, same value");
-		static_assert(!cmp_less(1u, 1u),  "comparison same unsigned type, same value (2)");
-		static_assert(!cmp_less(1ul, 1u), "comparison unsigned types, same value");
-		static_assert(!cmp_less(1u, 1ul), "comparison unsigned types, same value (2)");
-		static_assert(!cmp_less(1l, 1),   "comparison signed types, same value");
-		static_assert(!cmp_less(1, 1l),   "comparison signed types, same value (2)");
-		static_assert(!cmp_less(1ul, 1),  "comparison signed/unsigned types, same value");
-		static_assert(!cmp_less(1, 1ul),  "comparison signed/unsigned types, same value (2)");
-
-		static_assert(cmp_less(1, 2),    "comparison same signed type, different values");
-		static_assert(!cmp_less(1, -1),  "comparison same signed type, different values (2)");
-		static_assert(cmp_less(1u, 2u),  "comparison same unsigned type, different values");
-		static_assert(cmp_less(1ul, 2u) ,"comparison unsigned types, different values");
-		static_assert(!cmp_less(2u, 1ul),"comparison unsigned types, different values (2)");
-		static_assert(cmp_less(1l, 2),   "comparison signed types, different values");
-		static_assert(!cmp_less(2, 1l),  "comparison signed types, different values (2)");
-		static_assert(cmp_less(1ul, 2),  "comparison signed/unsigned types, different values");
-		static_assert(!cmp_less(2, 1ul), "comparison signed/unsigned types, different values (2)");
-
-		static_assert(!cmp_less(std::numeric_limits<uint8_t>::max(), std::numeric_limits<int8_t>::max()),
-		    "comparison unsigned/signed type");
-		static_assert(!cmp_less(std::numeric_limits<uint8_t>::max(), -1),
-		    "comparison unsigned/signed type");
-	}
-
 }
 
 #endif // SAFEOPERATIONS_H
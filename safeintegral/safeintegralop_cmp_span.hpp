@@ -0,0 +1,312 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEOPERATIONS_CMP_SPAN_H
+#define SAFEOPERATIONS_CMP_SPAN_H
+
+#include "safeintegralop_cmp.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Comparison of many values of type T with a single value of type U, with the same semantic of cmp_equal, cmp_less,
+// cmp_less_eq, cmp_great and in_range.
+// Every comparison is first converted, once, to the interval [lo, hi] of the values of T that satisfy it. The kernels only
+// compare values of type T, without any branch, and can be vectorized by the compiler, independently of the signedness of
+// T and U.
+// Every comparison has three variants:
+//  * *_mask: sets bit i%64 of mask[i/64] if the comparison holds for first[i] (the unused bits of the last word are 0)
+//  * *_count: returns how many values satisfy the comparison
+//  * *_select: writes the indexes of the values that satisfy the comparison in selection, and returns how many they are
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use, you should use all the function outside of this namespace
+	namespace details{
+		// the values of T in [lo, hi], or no value
+		template <typename T>
+		struct value_range {
+			T lo;
+			T hi;
+			bool empty;
+		};
+
+		template <typename T>
+		constexpr value_range<T> make_value_range(const T lo, const T hi) noexcept {
+			return value_range<T>{lo, hi, false};
+		}
+
+		template <typename T>
+		constexpr value_range<T> empty_value_range() noexcept {
+			return value_range<T>{T{0}, T{0}, true};
+		}
+
+		// t == u
+		template <typename T, typename U>
+		constexpr value_range<T> equal_range(const U u) noexcept {
+			return in_range<T>(u) ? make_value_range(T(u), T(u)) : empty_value_range<T>();
+		}
+
+		// t < u
+		template <typename T, typename U>
+		constexpr value_range<T> less_range(const U u) noexcept {
+			return
+			    cmp_less_eq(u, std::numeric_limits<T>::min()) ? empty_value_range<T>() :
+			    cmp_great(u, std::numeric_limits<T>::max()) ? make_value_range(std::numeric_limits<T>::min(), std::numeric_limits<T>::max()) :
+			    make_value_range(std::numeric_limits<T>::min(), T(T(u) - 1));
+		}
+
+		// t <= u
+		template <typename T, typename U>
+		constexpr value_range<T> less_eq_range(const U u) noexcept {
+			return
+			    cmp_less(u, std::numeric_limits<T>::min()) ? empty_value_range<T>() :
+			    !cmp_less(u, std::numeric_limits<T>::max()) ? make_value_range(std::numeric_limits<T>::min(), std::numeric_limits<T>::max()) :
+			    make_value_range(std::numeric_limits<T>::min(), T(u));
+		}
+
+		// t > u
+		template <typename T, typename U>
+		constexpr value_range<T> great_range(const U u) noexcept {
+			return
+			    !cmp_less(u, std::numeric_limits<T>::max()) ? empty_value_range<T>() :
+			    cmp_less(u, std::numeric_limits<T>::min()) ? make_value_range(std::numeric_limits<T>::min(), std::numeric_limits<T>::max()) :
+			    make_value_range(T(T(u) + 1), std::numeric_limits<T>::max());
+		}
+
+		// in_range<R>(t), the intersection is never empty since both types contain 0
+		template <typename T, typename R>
+		constexpr value_range<T> in_range_range() noexcept {
+			return make_value_range(
+			    cmp_less(std::numeric_limits<T>::min(), std::numeric_limits<R>::min()) ? T(std::numeric_limits<R>::min()) : std::numeric_limits<T>::min(),
+			    cmp_less(std::numeric_limits<R>::max(), std::numeric_limits<T>::max()) ? T(std::numeric_limits<R>::max()) : std::numeric_limits<T>::max());
+		}
+
+		// lo <= t <= hi, without branches
+		template <typename T>
+		constexpr bool contains(const value_range<T> r, const T t) noexcept {
+			return !(t < r.lo) & !(r.hi < t);
+		}
+
+		template <typename T>
+		void range_mask(const T* first, const std::size_t count, const value_range<T> r, std::uint64_t* mask) noexcept {
+			const std::size_t words = (count + 63) / 64;
+			if(r.empty){
+				for(std::size_t w = 0; w != words; ++w){
+					mask[w] = 0;
+				}
+				return;
+			}
+			const std::size_t full = count / 64;
+			for(std::size_t w = 0; w != full; ++w){
+				std::uint64_t bits = 0;
+				for(std::size_t j = 0; j != 64; ++j){
+					bits |= std::uint64_t(contains(r, first[w * 64 + j])) << j;
+				}
+				mask[w] = bits;
+			}
+			if(full != words){
+				std::uint64_t bits = 0;
+				for(std::size_t j = 0; j != count - full * 64; ++j){
+					bits |= std::uint64_t(contains(r, first[full * 64 + j])) << j;
+				}
+				mask[full] = bits;
+			}
+		}
+
+		template <typename T>
+		std::size_t range_count(const T* first, const std::size_t count, const value_range<T> r) noexcept {
+			if(r.empty){
+				return 0;
+			}
+			std::size_t n = 0;
+			for(std::size_t i = 0; i != count; ++i){
+				n += contains(r, first[i]);
+			}
+			return n;
+		}
+
+		template <typename T, typename I>
+		std::size_t range_select(const T* first, const std::size_t count, const value_range<T> r, I* selection, std::false_type) noexcept {
+			// the index is always written, but the position advances only if the value is selected
+			std::size_t n = 0;
+			for(std::size_t i = 0; i != count; ++i){
+				selection[n] = static_cast<I>(i);
+				n += contains(r, first[i]);
+			}
+			return n;
+		}
+
+#if defined(__AVX512F__)
+		// compilers do not generate compress instructions, the selected indexes of 16 values are written with vpcompressd
+		inline __mmask16 contains16(const std::int32_t* p, const value_range<std::int32_t> r) noexcept {
+			const __m512i v = _mm512_loadu_si512(p);
+			return _mm512_cmpge_epi32_mask(v, _mm512_set1_epi32(r.lo)) & _mm512_cmple_epi32_mask(v, _mm512_set1_epi32(r.hi));
+		}
+
+		inline __mmask16 contains16(const std::uint32_t* p, const value_range<std::uint32_t> r) noexcept {
+			const __m512i v = _mm512_loadu_si512(p);
+			return _mm512_cmpge_epu32_mask(v, _mm512_set1_epi32(int(r.lo))) & _mm512_cmple_epu32_mask(v, _mm512_set1_epi32(int(r.hi)));
+		}
+
+		inline __mmask8 contains8(const std::int64_t* p, const value_range<std::int64_t> r) noexcept {
+			const __m512i v = _mm512_loadu_si512(p);
+			return _mm512_cmpge_epi64_mask(v, _mm512_set1_epi64(r.lo)) & _mm512_cmple_epi64_mask(v, _mm512_set1_epi64(r.hi));
+		}
+
+		inline __mmask8 contains8(const std::uint64_t* p, const value_range<std::uint64_t> r) noexcept {
+			const __m512i v = _mm512_loadu_si512(p);
+			return _mm512_cmpge_epu64_mask(v, _mm512_set1_epi64((long long)(r.lo))) & _mm512_cmple_epu64_mask(v, _mm512_set1_epi64((long long)(r.hi)));
+		}
+
+		template <typename T>
+		__mmask16 contains16(const T* p, const value_range<T> r) noexcept {
+			return __mmask16(unsigned(contains8(p, r)) | (unsigned(contains8(p + 8, r)) << 8));
+		}
+
+		template <typename T, typename I>
+		std::size_t range_select(const T* first, const std::size_t count, const value_range<T> r, I* selection, std::true_type) noexcept {
+			const __m512i step = _mm512_set1_epi32(16);
+			__m512i indexes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+			std::size_t n = 0;
+			std::size_t i = 0;
+			for(; count - i >= 16; i += 16){
+				const __mmask16 m = contains16(first + i, r);
+				// n <= i, the full store never writes after selection[count-1]
+				_mm512_storeu_si512(selection + n, _mm512_maskz_compress_epi32(m, indexes));
+				n += std::size_t(__builtin_popcount(m));
+				indexes = _mm512_add_epi32(indexes, step);
+			}
+			// less than 16 values left
+			const std::size_t rest = (count - i) & 15u;
+			for(std::size_t j = 0; j != rest; ++j){
+				selection[n] = static_cast<I>(i + j);
+				n += contains(r, first[i + j]);
+			}
+			return n;
+		}
+#endif
+
+		template <typename T, typename I>
+		std::size_t range_select(const T* first, const std::size_t count, const value_range<T> r, I* selection) noexcept {
+			static_assert(std::is_integral<I>::value, "the selection vector must contain integral values");
+			if(r.empty){
+				return 0;
+			}
+#if defined(__AVX512F__)
+			using use_avx512 = std::integral_constant<bool, sizeof(I) == 4 &&
+			    (std::is_same<T, std::int32_t>::value || std::is_same<T, std::uint32_t>::value ||
+			     std::is_same<T, std::int64_t>::value || std::is_same<T, std::uint64_t>::value)>;
+#else
+			using use_avx512 = std::false_type;
+#endif
+			return range_select(first, count, r, selection, use_avx512{});
+		}
+	} // end details
+
+	/// Usage:
+	/// std::vector<std::int64_t> column = ...
+	/// std::uint64_t threshold = ...
+	/// std::vector<std::uint32_t> selection(column.size());
+	/// selection.resize(cmp_less_select(column.data(), column.size(), threshold, selection.data()));
+	///  selection contains the indexes i for which cmp_less(column[i], threshold)
+	template <typename T, typename U>
+	void cmp_equal_mask(const T* first, const std::size_t count, const U u, std::uint64_t* mask) noexcept {
+		details::range_mask(first, count, details::equal_range<T>(u), mask);
+	}
+
+	template <typename T, typename U>
+	std::size_t cmp_equal_count(const T* first, const std::size_t count, const U u) noexcept {
+		return details::range_count(first, count, details::equal_range<T>(u));
+	}
+
+	template <typename T, typename U, typename I>
+	std::size_t cmp_equal_select(const T* first, const std::size_t count, const U u, I* selection) noexcept {
+		return details::range_select(first, count, details::equal_range<T>(u), selection);
+	}
+
+	template <typename T, typename U>
+	void cmp_less_mask(const T* first, const std::size_t count, const U u, std::uint64_t* mask) noexcept {
+		details::range_mask(first, count, details::less_range<T>(u), mask);
+	}
+
+	template <typename T, typename U>
+	std::size_t cmp_less_count(const T* first, const std::size_t count, const U u) noexcept {
+		return details::range_count(first, count, details::less_range<T>(u));
+	}
+
+	template <typename T, typename U, typename I>
+	std::size_t cmp_less_select(const T* first, const std::size_t count, const U u, I* selection) noexcept {
+		return details::range_select(first, count, details::less_range<T>(u), selection);
+	}
+
+	template <typename T, typename U>
+	void cmp_less_eq_mask(const T* first, const std::size_t count, const U u, std::uint64_t* mask) noexcept {
+		details::range_mask(first, count, details::less_eq_range<T>(u), mask);
+	}
+
+	template <typename T, typename U>
+	std::size_t cmp_less_eq_count(const T* first, const std::size_t count, const U u) noexcept {
+		return details::range_count(first, count, details::less_eq_range<T>(u));
+	}
+
+	template <typename T, typename U, typename I>
+	std::size_t cmp_less_eq_select(const T* first, const std::size_t count, const U u, I* selection) noexcept {
+		return details::range_select(first, count, details::less_eq_range<T>(u), selection);
+	}
+
+	template <typename T, typename U>
+	void cmp_great_mask(const T* first, const std::size_t count, const U u, std::uint64_t* mask) noexcept {
+		details::range_mask(first, count, details::great_range<T>(u), mask);
+	}
+
+	template <typename T, typename U>
+	std::size_t cmp_great_count(const T* first, const std::size_t count, const U u) noexcept {
+		return details::range_count(first, count, details::great_range<T>(u));
+	}
+
+	template <typename T, typename U, typename I>
+	std::size_t cmp_great_select(const T* first, const std::size_t count, const U u, I* selection) noexcept {
+		return details::range_select(first, count, details::great_range<T>(u), selection);
+	}
+
+	/// Usage:
+	/// std::vector<std::int64_t> column = ...
+	/// const auto n = in_range_count<std::uint32_t>(column.data(), column.size());
+	///  n values of column can be represented by an uint32_t
+	template <typename R, typename T>
+	void in_range_mask(const T* first, const std::size_t count, std::uint64_t* mask) noexcept {
+		details::range_mask(first, count, details::in_range_range<T, R>(), mask);
+	}
+
+	template <typename R, typename T>
+	std::size_t in_range_count(const T* first, const std::size_t count) noexcept {
+		return details::range_count(first, count, details::in_range_range<T, R>());
+	}
+
+	template <typename R, typename T, typename I>
+	std::size_t in_range_select(const T* first, const std::size_t count, I* selection) noexcept {
+		return details::range_select(first, count, details::in_range_range<T, R>(), selection);
+	}
+}
+
+#endif // SAFEOPERATIONS_CMP_SPAN_H
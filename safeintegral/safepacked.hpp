@@ -0,0 +1,273 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEPACKED_HPP
+#define SAFEINTEGRAL_SAFEPACKED_HPP
+
+#include "safeintegral.hpp"
+#include "safeblock.hpp"
+#include "saferange.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// the narrowest integral type with at least Bits bits
+		template <unsigned Bits, bool Signed>
+		struct packed_type {
+			using unsigned_type =
+			    typename std::conditional<Bits <= 8, std::uint8_t,
+			    typename std::conditional<Bits <= 16, std::uint16_t,
+			    typename std::conditional<Bits <= 32, std::uint32_t, std::uint64_t>::type>::type>::type;
+			using type = typename std::conditional<Signed, typename std::make_signed<unsigned_type>::type, unsigned_type>::type;
+		};
+
+		constexpr std::uint64_t low_bits_mask(const unsigned bits) noexcept {
+			return (bits >= 64) ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+		}
+
+		// the low bits of every lane of lane_bits bits
+		constexpr std::uint64_t lane_mask(const unsigned bits, const unsigned lane_bits) noexcept {
+			return (lane_bits >= 64) ? low_bits_mask(bits) : (lane_mask(bits, lane_bits * 2) << lane_bits) | lane_mask(bits, lane_bits * 2);
+		}
+
+		// the bits bits starting at the bit pos, the last word is read only if needed
+		inline std::uint64_t read_bits(const std::uint64_t* words, const std::size_t pos, const unsigned bits) noexcept {
+			const std::size_t w = pos / 64;
+			const unsigned s = unsigned(pos % 64);
+			const std::uint64_t v = (s != 0 && s + bits > 64) ? (words[w] >> s) | (words[w + 1] << (64 - s)) : words[w] >> s;
+			return v & low_bits_mask(bits);
+		}
+
+		inline void write_bits(std::uint64_t* words, const std::size_t pos, const unsigned bits, const std::uint64_t v) noexcept {
+			const std::size_t w = pos / 64;
+			const unsigned s = unsigned(pos % 64);
+			const std::uint64_t mask = low_bits_mask(bits);
+			words[w] = (words[w] & ~(mask << s)) | ((v & mask) << s);
+			if(s != 0 && s + bits > 64){
+				words[w + 1] = (words[w + 1] & ~(mask >> (64 - s))) | ((v & mask) >> (64 - s));
+			}
+		}
+	} // end details
+}
+
+/// This class is an array of integrals of Bits bits (from 1 to 64, signed or unsigned), stored without padding in 64-bit
+/// words, for example 5 bits per value instead of 8, or 20 bits instead of 32.
+/// The values are read as safe_integral of the narrowest integral type with at least Bits bits (raw_type). Storing a
+/// value outside of the range of Bits bits throws an exception, like the arithmetic operations of the elements.
+/// The bulk functions pack and unpack use the BMI2 instructions pext and pdep, if available, for converting many
+/// values at once.
+///
+/// Example Usage:
+/// @code
+/// 	packed_safe_array<12> a(1000); // 1500 bytes instead of 2000
+/// 	a[0] = 4000;
+/// 	a[0] += 100; // throws, 4100 needs 13 bits
+/// 	safe_integral<std::uint16_t> sum = a[0].get() + a[1];
+/// @endcode
+template<unsigned Bits, bool Signed = false>
+class packed_safe_array {
+		static_assert(Bits >= 1 && Bits <= 64, "Bits needs to be between 1 and 64");
+	public:
+		using raw_type = typename safeintegralop::details::packed_type<Bits, Signed>::type;
+		using value_type = safe_integral<raw_type>;
+		using size_type = std::size_t;
+
+		/// The range of Bits bits
+		static constexpr raw_type min() noexcept {
+			return Signed ? raw_type(-raw_type(safeintegralop::details::low_bits_mask(Bits - 1)) - 1) : raw_type{0};
+		}
+		static constexpr raw_type max() noexcept {
+			return raw_type(safeintegralop::details::low_bits_mask(Signed ? Bits - 1 : Bits));
+		}
+		static constexpr bool in_range(const raw_type v) noexcept {
+			return !(v < min()) && !(max() < v);
+		}
+
+	private:
+		using U = typename std::make_unsigned<raw_type>::type;
+		// values converted at once with pext and pdep, one for every lane of a 64-bit word
+		static const unsigned lanes = 8 / sizeof(raw_type);
+
+		std::vector<std::uint64_t> words;
+		size_type count;
+
+		static raw_type sign_extend(const U u) noexcept {
+			return (Signed && Bits < std::numeric_limits<U>::digits) ?
+			    safeintegralop::details::from_unsigned<raw_type>(U((u ^ (U(1) << ((Bits - 1) % std::numeric_limits<U>::digits))) - (U(1) << ((Bits - 1) % std::numeric_limits<U>::digits)))) :
+			    safeintegralop::details::from_unsigned<raw_type>(u);
+		}
+
+		void pack_unchecked(const size_type first, const raw_type* in, const size_type n) noexcept {
+			size_type i = 0;
+#if defined(__BMI2__)
+			if(lanes > 1){
+				for(; n - i >= lanes; i += lanes){
+					std::uint64_t x;
+					std::memcpy(&x, in + i, sizeof(x));
+					safeintegralop::details::write_bits(words.data(), (first + i) * Bits, lanes * Bits,
+					    _pext_u64(x, safeintegralop::details::lane_mask(Bits, 8 * sizeof(raw_type))));
+				}
+			}
+#endif
+			for(; i < n; ++i){
+				safeintegralop::details::write_bits(words.data(), (first + i) * Bits, Bits, std::uint64_t(U(in[i])));
+			}
+		}
+
+		void unpack_unchecked(const size_type first, const size_type n, raw_type* out) const noexcept {
+			size_type i = 0;
+#if defined(__BMI2__)
+			if(lanes > 1){
+				for(; n - i >= lanes; i += lanes){
+					const std::uint64_t x = _pdep_u64(safeintegralop::details::read_bits(words.data(), (first + i) * Bits, lanes * Bits),
+					    safeintegralop::details::lane_mask(Bits, 8 * sizeof(raw_type)));
+					std::memcpy(out + i, &x, sizeof(x));
+				}
+				if(Signed && Bits < std::numeric_limits<U>::digits){
+					for(size_type j = 0; j < i; ++j){
+						out[j] = sign_extend(U(out[j]));
+					}
+				}
+			}
+#endif
+			for(; i < n; ++i){
+				out[i] = sign_extend(U(safeintegralop::details::read_bits(words.data(), (first + i) * Bits, Bits)));
+			}
+		}
+
+	public:
+		class reference {
+			private:
+				packed_safe_array* a;
+				size_type i;
+				friend class packed_safe_array;
+				constexpr reference(packed_safe_array* a_, const size_type i_) noexcept : a(a_), i(i_) {}
+			public:
+				reference(const reference&) noexcept = default;
+
+				/// Returns the value of the element
+				raw_type getvalue() const noexcept { return a->get(i).getvalue(); }
+				value_type get() const noexcept { return a->get(i); }
+				operator value_type() const noexcept { return a->get(i); }
+
+				reference& operator=(const value_type rhs) { a->set(i, rhs); return *this; }
+				// assigns the value, not the reference
+				reference& operator=(const reference& rhs) { return *this = rhs.get(); }
+
+				reference& operator+=(const value_type rhs) { return *this = get() + rhs; }
+				reference& operator-=(const value_type rhs) { return *this = get() - rhs; }
+				reference& operator*=(const value_type rhs) { return *this = get() * rhs; }
+				reference& operator/=(const value_type rhs) { return *this = get() / rhs; }
+				reference& operator%=(const value_type rhs) { return *this = get() % rhs; }
+				reference& operator++() { return *this = get() + value_type(1); }
+				reference& operator--() { return *this = get() - value_type(1); }
+
+				friend bool operator==(const reference lhs, const value_type rhs) noexcept { return lhs.get() == rhs; }
+				friend bool operator!=(const reference lhs, const value_type rhs) noexcept { return lhs.get() != rhs; }
+				friend bool operator<(const reference lhs, const value_type rhs) noexcept { return lhs.get() < rhs; }
+				friend bool operator>(const reference lhs, const value_type rhs) noexcept { return lhs.get() > rhs; }
+				friend bool operator<=(const reference lhs, const value_type rhs) noexcept { return lhs.get() <= rhs; }
+				friend bool operator>=(const reference lhs, const value_type rhs) noexcept { return lhs.get() >= rhs; }
+		};
+
+		packed_safe_array() noexcept : count(0) {}
+		/// Constructor
+		/// count_ values, initialized to 0
+		explicit packed_safe_array(const size_type count_) : words((count_ * Bits + 63) / 64), count(count_) {}
+
+		constexpr size_type size() const noexcept { return count; }
+		constexpr bool empty() const noexcept { return count == 0; }
+		/// Returns the number of bytes used by the values
+		size_type encoded_bytes() const noexcept { return words.size() * sizeof(std::uint64_t); }
+
+		value_type get(const size_type i) const noexcept {
+			return value_type(sign_extend(U(safeintegralop::details::read_bits(words.data(), i * Bits, Bits))));
+		}
+
+		/// Writes v, if it is outside of the range of Bits bits an exception is thrown
+		void set(const size_type i, const value_type v) {
+			if(!in_range(v.getvalue())){
+				throw std::out_of_range("packed_safe_array value out of range");
+			}
+			safeintegralop::details::write_bits(words.data(), i * Bits, Bits, std::uint64_t(U(v.getvalue())));
+		}
+
+		value_type operator[](const size_type i) const noexcept { return get(i); }
+		reference operator[](const size_type i) noexcept { return reference(this, i); }
+
+		/// Same as operator[], but throws if i is not a valid index
+		value_type at(const size_type i) const {
+			if(i >= count){
+				throw std::out_of_range("packed_safe_array index out of range");
+			}
+			return get(i);
+		}
+		reference at(const size_type i) {
+			if(i >= count){
+				throw std::out_of_range("packed_safe_array index out of range");
+			}
+			return reference(this, i);
+		}
+
+		/// Stores the n values starting at in, from the element first
+		/// The values are validated in blocks, with their minimum and maximum.
+		/// Returns the index (in in) of the first value outside of the range of Bits bits (it, and the following values, are
+		/// not stored), or n if all values have been stored
+		size_type pack(const size_type first, const raw_type* in, const size_type n) {
+			if(first > count || n > count - first){
+				throw std::out_of_range("packed_safe_array pack out of range");
+			}
+			for(size_type b = 0; b < n; b += safeintegralop::details::transform_block_size()){
+				const size_type m = (n - b < safeintegralop::details::transform_block_size()) ? n - b : safeintegralop::details::transform_block_size();
+				const safe_interval<raw_type> r = safeintegralop::details::minmax_interval<raw_type>(in + b, m);
+				if(in_range(r.min()) && in_range(r.max())){
+					pack_unchecked(first + b, in + b, m);
+					continue;
+				}
+				size_type i = b;
+				while(in_range(in[i])){
+					++i;
+				}
+				pack_unchecked(first + b, in + b, i - b);
+				return i;
+			}
+			return n;
+		}
+
+		/// Writes the n values starting at the element first to out
+		/// If the range is not valid, an exception is thrown
+		void unpack(const size_type first, const size_type n, raw_type* out) const {
+			if(first > count || n > count - first){
+				throw std::out_of_range("packed_safe_array unpack out of range");
+			}
+			unpack_unchecked(first, n, out);
+		}
+};
+
+#endif // SAFEINTEGRAL_SAFEPACKED_HPP
@@ -0,0 +1,149 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFERANGE_HPP
+#define SAFEINTEGRAL_SAFERANGE_HPP
+
+#include "safeintegral.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// converts the two's complement representation u to T, without implementation-defined conversions
+		template <typename T>
+		constexpr T from_unsigned(const typename std::make_unsigned<T>::type u) noexcept {
+			using U = typename std::make_unsigned<T>::type;
+			return (u <= U(std::numeric_limits<T>::max())) ? T(u) : T(-T(U(~u)) - 1);
+		}
+	} // end details
+}
+
+/// This class represents the arithmetic progression begin, begin+step, begin+2*step, ... up to end (excluded).
+/// All values are validated once, when constructing the range, the iterators do not perform any check.
+/// The iterators support all operations of random access iterators, but return the values and not references, like the
+/// iterators of std::views::iota: their iterator_category is std::input_iterator_tag, and since C++20 their iterator_concept
+/// is std::random_access_iterator_tag. Use it - n instead of std::prev(it) or std::advance(it, -n), which require
+/// bidirectional iterators.
+///
+/// Example Usage:
+/// @code
+/// 	for(auto i : safe_range<int>(a, b, step)){ // instead of for(safe_int i = a; i < b; i += step)
+/// 		...
+/// 	}
+/// @endcode
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+class safe_range {
+	private:
+		using U = typename std::make_unsigned<T>::type;
+		T first;
+		T step;
+		std::ptrdiff_t count;
+
+		static std::ptrdiff_t validate(const T begin, const T end, const T step) {
+			if(step == T{0}){
+				throw std::out_of_range("safe_range with step 0");
+			}
+			const bool increasing = step > T{0};
+			if(increasing ? !(begin < end) : !(end < begin)){
+				return 0;
+			}
+			// |end-begin| always fits in U, the number of elements is ceil(|end-begin|/|step|)
+			const U distance = increasing ? U(U(end) - U(begin)) : U(U(begin) - U(end));
+			const U elements = U(U(distance - 1) / safeintegralop::details::safe_abs(step) + 1);
+			if(!safeintegralop::in_range<std::ptrdiff_t>(elements)){
+				throw std::out_of_range("safe_range with too many elements");
+			}
+			return static_cast<std::ptrdiff_t>(elements);
+		}
+
+	public:
+		class iterator {
+			private:
+				using Uw = typename std::common_type<U, unsigned>::type; // avoids promotion to int
+				// the current value is stored as unsigned value, since the past-the-end value might not be representable by T
+				U v;
+				U step;
+				std::ptrdiff_t i;
+				friend class safe_range;
+				constexpr iterator(const U v_, const U step_, const std::ptrdiff_t i_) noexcept : v(v_), step(step_), i(i_) {}
+				constexpr U advance(const std::ptrdiff_t n) const noexcept {
+					return U(Uw(v) + Uw(U(n)) * Uw(step));
+				}
+			public:
+				// operator* does not return a reference, see the documentation of safe_range
+				using iterator_category = std::input_iterator_tag;
+#if  __cplusplus > 201703L // compiling with c++20 or greater
+				using iterator_concept = std::random_access_iterator_tag;
+#endif
+				using value_type = safe_integral<T>;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = value_type;
+
+				constexpr iterator() noexcept : v(), step(), i() {}
+
+				constexpr reference operator*() const noexcept { return safe_integral<T>(safeintegralop::details::from_unsigned<T>(v)); }
+				constexpr reference operator[](const difference_type n) const noexcept { return *(*this + n); }
+
+				iterator& operator++() noexcept { v = U(Uw(v) + Uw(step)); ++i; return *this; }
+				iterator operator++(int) noexcept { iterator tmp(*this); ++*this; return tmp; }
+				iterator& operator--() noexcept { v = U(Uw(v) - Uw(step)); --i; return *this; }
+				iterator operator--(int) noexcept { iterator tmp(*this); --*this; return tmp; }
+				iterator& operator+=(const difference_type n) noexcept { v = advance(n); i += n; return *this; }
+				iterator& operator-=(const difference_type n) noexcept { v = advance(-n); i -= n; return *this; }
+
+				constexpr friend iterator operator+(const iterator it, const difference_type n) noexcept { return iterator(it.advance(n), it.step, it.i + n); }
+				constexpr friend iterator operator+(const difference_type n, const iterator it) noexcept { return it + n; }
+				constexpr friend iterator operator-(const iterator it, const difference_type n) noexcept { return iterator(it.advance(-n), it.step, it.i - n); }
+				constexpr friend difference_type operator-(const iterator lhs, const iterator rhs) noexcept { return lhs.i - rhs.i; }
+
+				constexpr friend bool operator==(const iterator lhs, const iterator rhs) noexcept { return lhs.i == rhs.i; }
+				constexpr friend bool operator!=(const iterator lhs, const iterator rhs) noexcept { return lhs.i != rhs.i; }
+				constexpr friend bool operator<(const iterator lhs, const iterator rhs) noexcept { return lhs.i < rhs.i; }
+				constexpr friend bool operator>(const iterator lhs, const iterator rhs) noexcept { return lhs.i > rhs.i; }
+				constexpr friend bool operator<=(const iterator lhs, const iterator rhs) noexcept { return lhs.i <= rhs.i; }
+				constexpr friend bool operator>=(const iterator lhs, const iterator rhs) noexcept { return lhs.i >= rhs.i; }
+		};
+		using const_iterator = iterator;
+		using value_type = safe_integral<T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		/// Constructor
+		/// If step is 0, or the number of elements cannot be represented by a std::ptrdiff_t, an exception is thrown
+		/// If the range is empty (for example begin > end and step > 0), no exception is thrown
+		safe_range(const T begin, const T end, const T step_ = T{1}) : first(begin), step(step_), count(validate(begin, end, step_)) {}
+
+		iterator begin() const noexcept { return iterator(U(first), U(step), 0); }
+		iterator end() const noexcept { return begin() + count; }
+		size_type size() const noexcept { return static_cast<size_type>(count); }
+		bool empty() const noexcept { return count == 0; }
+		value_type operator[](const difference_type n) const noexcept { return begin()[n]; }
+};
+
+template<typename T>
+safe_range<T> make_safe_range(const safe_integral<T> begin, const safe_integral<T> end, const safe_integral<T> step = T{1}) {
+	return safe_range<T>(begin.getvalue(), end.getvalue(), step.getvalue());
+}
+
+#endif // SAFEINTEGRAL_SAFERANGE_HPP
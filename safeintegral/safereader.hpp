@@ -0,0 +1,351 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEREADER_HPP
+#define SAFEINTEGRAL_SAFEREADER_HPP
+
+#include "safeintegral.hpp"
+#include "safeblock.hpp"
+#include "saferange.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <vector>
+#endif
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		constexpr bool native_little_endian() noexcept {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && defined(__ORDER_BIG_ENDIAN__)
+			return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+#else
+			// unknown byte order, the values are always assembled byte by byte
+			return false;
+#endif
+		}
+
+		constexpr bool native_big_endian() noexcept {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && defined(__ORDER_BIG_ENDIAN__)
+			return __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+#else
+			return false;
+#endif
+		}
+
+		// the compilers recognize these loops, and generate a single load (and a byte swap if needed)
+		template <typename T>
+		T load_le(const unsigned char* p) noexcept {
+			using U = typename std::make_unsigned<T>::type;
+			U u = 0;
+			for(std::size_t i = 0; i != sizeof(T); ++i){
+				u = U(u | U(U(p[i]) << (8 * i)));
+			}
+			return from_unsigned<T>(u);
+		}
+
+		template <typename T>
+		T load_be(const unsigned char* p) noexcept {
+			using U = typename std::make_unsigned<T>::type;
+			U u = 0;
+			for(std::size_t i = 0; i != sizeof(T); ++i){
+				u = U(u | U(U(p[i]) << (8 * (sizeof(T) - 1 - i))));
+			}
+			return from_unsigned<T>(u);
+		}
+
+		template <typename T>
+		T load(const unsigned char* p, const bool little_endian) noexcept {
+			return little_endian ? load_le<T>(p) : load_be<T>(p);
+		}
+
+		// the count values of type T starting at first, without any check
+		template <typename T, typename Out>
+		void load_array(const unsigned char* first, const std::size_t count, Out* out, const bool little_endian) noexcept {
+			if(std::is_same<Out, T>::value && (little_endian ? native_little_endian() : native_big_endian())){
+				std::memcpy(out, first, count * sizeof(T));
+				return;
+			}
+			for(std::size_t i = 0; i != count; ++i){
+				out[i] = load<T>(first + i * sizeof(T), little_endian);
+			}
+		}
+	} // end details
+
+	/// Returns the index of the first pair offsets[i], lengths[i] that does not describe a range inside [0, limit]: one of
+	/// them is negative, offsets[i] + lengths[i] overflows, or is bigger than limit. Returns count if all ranges are valid.
+	/// The pairs are validated in blocks, with the minimum and maximum values of both arrays, so that in the common case
+	/// no pair is checked on its own.
+	///
+	/// Example Usage:
+	/// @code
+	/// 	if(safeintegralop::validate_extents(offsets.data(), sizes.data(), offsets.size(), file_size) != offsets.size()){
+	/// 		// corrupted index
+	/// 	}
+	/// 	for(...){ // unchecked
+	/// 		process(data + offsets[i], sizes[i]);
+	/// 	}
+	/// @endcode
+	template <typename T>
+	std::size_t validate_extents(const T* offsets, const T* lengths, const std::size_t count, const T limit) {
+		for(std::size_t b = 0; b < count; b += details::transform_block_size()){
+			const std::size_t n = (count - b < details::transform_block_size()) ? count - b : details::transform_block_size();
+			const safe_interval<T> o = details::minmax_interval<T>(offsets + b, n);
+			const safe_interval<T> l = details::minmax_interval<T>(lengths + b, n);
+			const safe_interval<T> ends = o + l;
+			if(!(o.min() < T{0}) && !(l.min() < T{0}) && ends.is_valid() && !(limit < ends.max())){
+				continue;
+			}
+			for(std::size_t i = b; i != b + n; ++i){
+				if(offsets[i] < T{0} || lengths[i] < T{0} || !is_safe_add(offsets[i], lengths[i]) || limit < T(offsets[i] + lengths[i])){
+					return i;
+				}
+			}
+		}
+		return count;
+	}
+}
+
+/// Read-only view of the content of a file, mapped in memory (with mmap) on POSIX systems, or read in memory on other
+/// systems.
+/// If the file cannot be opened or mapped, an exception is thrown.
+class safe_mapped_file {
+	private:
+		const unsigned char* first = nullptr;
+		std::size_t count = 0;
+#if !defined(__unix__) && !defined(__APPLE__)
+		std::vector<unsigned char> content;
+#endif
+
+	public:
+		explicit safe_mapped_file(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if(fd == -1){
+				throw std::runtime_error("safe_mapped_file cannot open " + path);
+			}
+			struct stat st;
+			if(::fstat(fd, &st) != 0 || st.st_size < 0){
+				::close(fd);
+				throw std::runtime_error("safe_mapped_file cannot read the size of " + path);
+			}
+			count = std::size_t(st.st_size);
+			if(count != 0){
+				void* p = ::mmap(nullptr, count, PROT_READ, MAP_PRIVATE, fd, 0);
+				if(p == MAP_FAILED){
+					::close(fd);
+					throw std::runtime_error("safe_mapped_file cannot map " + path);
+				}
+				first = static_cast<const unsigned char*>(p);
+			}
+			::close(fd);
+#else
+			std::ifstream in(path, std::ios::binary);
+			if(!in){
+				throw std::runtime_error("safe_mapped_file cannot open " + path);
+			}
+			content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			first = content.data();
+			count = content.size();
+#endif
+		}
+
+		safe_mapped_file(const safe_mapped_file&) = delete;
+		safe_mapped_file& operator=(const safe_mapped_file&) = delete;
+
+		~safe_mapped_file() {
+#if defined(__unix__) || defined(__APPLE__)
+			if(first != nullptr){
+				::munmap(const_cast<unsigned char*>(first), count);
+			}
+#endif
+		}
+
+		const unsigned char* data() const noexcept { return first; }
+		std::size_t size() const noexcept { return count; }
+};
+
+/// This class is a set of records of the same size, whose bounds have been validated once, when the batch has been read
+/// with safe_reader::read_records. The fields are read without any check.
+class safe_record_batch {
+	private:
+		const unsigned char* first;
+		std::size_t count;
+		std::size_t record_bytes;
+		friend class safe_reader;
+		safe_record_batch(const unsigned char* first_, const std::size_t count_, const std::size_t record_bytes_) noexcept :
+		    first(first_), count(count_), record_bytes(record_bytes_) {}
+
+		template <typename T, typename Out>
+		void column(const std::size_t offset, Out* out, const bool little_endian) const {
+			if(offset > record_bytes || sizeof(T) > record_bytes - offset){
+				throw std::out_of_range("safe_record_batch field out of range");
+			}
+			for(std::size_t i = 0; i != count; ++i){
+				out[i] = safeintegralop::details::load<T>(first + i * record_bytes + offset, little_endian);
+			}
+		}
+
+	public:
+		std::size_t size() const noexcept { return count; }
+		std::size_t record_size() const noexcept { return record_bytes; }
+
+		/// Returns the field of type T at offset in the record i, stored in little endian (le) or big endian (be) byte order
+		/// Not checked: i < size() and offset + sizeof(T) <= record_size()
+		template <typename T>
+		T le(const std::size_t i, const std::size_t offset) const noexcept {
+			return safeintegralop::details::load_le<T>(first + i * record_bytes + offset);
+		}
+		template <typename T>
+		T be(const std::size_t i, const std::size_t offset) const noexcept {
+			return safeintegralop::details::load_be<T>(first + i * record_bytes + offset);
+		}
+
+		/// Writes the field of type T at offset of every record to out
+		/// If the field is not inside the records, an exception is thrown
+		template <typename T, typename Out>
+		void column_le(const std::size_t offset, Out* out) const {
+			column<T>(offset, out, true);
+		}
+		template <typename T, typename Out>
+		void column_be(const std::size_t offset, Out* out) const {
+			column<T>(offset, out, false);
+		}
+};
+
+/// This class reads the fields of a binary buffer (for example a safe_mapped_file) as safe_integral, without copying the
+/// buffer. Every read advances a cursor, and every computation of the cursor (position + size, count * size) is checked:
+/// reading outside of the buffer, or with sizes that overflow, throws an exception instead of reading out of bounds.
+///
+/// Example Usage:
+/// @code
+/// 	const safe_mapped_file file(path);
+/// 	safe_reader r(file);
+/// 	const auto count = r.read_le<std::uint32_t>();
+/// 	const auto offset = r.read_le<std::uint64_t>();
+/// 	r.seek(offset);                              // throws if offset is outside of the file
+/// 	const auto records = r.read_records(count, 16); // validates count * 16 bytes once
+/// 	for(std::size_t i = 0; i != records.size(); ++i){
+/// 		sum += records.le<std::int32_t>(i, 4);   // unchecked
+/// 	}
+/// @endcode
+class safe_reader {
+	private:
+		const unsigned char* first;
+		std::size_t count;
+		std::size_t pos;
+
+		// returns the data of the next n bytes, and advances the cursor
+		const unsigned char* advance(const safe_integral<std::size_t> n) {
+			const safe_integral<std::size_t> end = safe_integral<std::size_t>(pos) + n;
+			if(end > count){
+				throw std::out_of_range("safe_reader read out of range");
+			}
+			const unsigned char* res = first + pos;
+			pos = end.getvalue();
+			return res;
+		}
+
+		template <typename T>
+		const unsigned char* advance_array(const safe_integral<T> n, const std::size_t size) {
+			if(!safeintegralop::in_range<std::size_t>(n.getvalue())){
+				throw std::out_of_range("safe_reader count out of range");
+			}
+			return advance(safe_integral<std::size_t>(std::size_t(n.getvalue())) * safe_integral<std::size_t>(size));
+		}
+
+	public:
+		safe_reader(const unsigned char* first_, const std::size_t count_) noexcept : first(first_), count(count_), pos(0) {}
+		explicit safe_reader(const safe_mapped_file& f) noexcept : first(f.data()), count(f.size()), pos(0) {}
+
+		std::size_t size() const noexcept { return count; }
+		std::size_t position() const noexcept { return pos; }
+		std::size_t remaining() const noexcept { return count - pos; }
+
+		/// Moves the cursor to offset, if it is outside of the buffer (offset == size() is valid) an exception is thrown
+		template <typename T>
+		void seek(const safe_integral<T> offset) {
+			if(!safeintegralop::in_range<std::size_t>(offset.getvalue()) || safeintegralop::cmp_less(count, offset.getvalue())){
+				throw std::out_of_range("safe_reader seek out of range");
+			}
+			pos = std::size_t(offset.getvalue());
+		}
+
+		template <typename T>
+		void skip(const safe_integral<T> n) {
+			advance_array(n, 1);
+		}
+
+		/// Returns the value of type T at the cursor, stored in little endian (le) or big endian (be) byte order
+		template <typename T>
+		safe_integral<T> read_le() {
+			return safe_integral<T>(safeintegralop::details::load_le<T>(advance(sizeof(T))));
+		}
+		template <typename T>
+		safe_integral<T> read_be() {
+			return safe_integral<T>(safeintegralop::details::load_be<T>(advance(sizeof(T))));
+		}
+
+		/// Returns the next n bytes
+		template <typename T>
+		const unsigned char* read_bytes(const safe_integral<T> n) {
+			return advance_array(n, 1);
+		}
+
+		/// Writes the next n values of type T to out (of type T or safe_integral<T>), the size of all values is checked once
+		template <typename T, typename Out, typename N>
+		void read_array_le(Out* out, const safe_integral<N> n) {
+			safeintegralop::details::load_array<T>(advance_array(n, sizeof(T)), std::size_t(n.getvalue()), out, true);
+		}
+		template <typename T, typename Out, typename N>
+		void read_array_be(Out* out, const safe_integral<N> n) {
+			safeintegralop::details::load_array<T>(advance_array(n, sizeof(T)), std::size_t(n.getvalue()), out, false);
+		}
+
+		/// Returns the next n records of record_size bytes, the size of all records is checked once
+		template <typename N>
+		safe_record_batch read_records(const safe_integral<N> n, const std::size_t record_size) {
+			const unsigned char* data = advance_array(n, record_size);
+			return safe_record_batch(data, std::size_t(n.getvalue()), record_size);
+		}
+
+		/// Returns a reader of the length bytes starting at offset (from the beginning of the buffer)
+		/// If the range is outside of the buffer, or offset + length overflows, an exception is thrown
+		template <typename T, typename L>
+		safe_reader subreader(const safe_integral<T> offset, const safe_integral<L> length) const {
+			safe_reader res(first, count);
+			res.seek(offset);
+			res.first = res.advance_array(length, 1);
+			res.count = std::size_t(length.getvalue());
+			res.pos = 0;
+			return res;
+		}
+};
+
+#endif // SAFEINTEGRAL_SAFEREADER_HPP
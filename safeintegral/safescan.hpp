@@ -0,0 +1,252 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFESCAN_HPP
+#define SAFEINTEGRAL_SAFESCAN_HPP
+
+#include "safeintegral.hpp"
+#include "safeblock.hpp"
+#include "saferange.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace safeintegralop {
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// the number of elements of a block needs to be representable by T
+		template <typename T>
+		constexpr std::size_t scan_block_size() noexcept {
+			return (std::size_t(std::numeric_limits<T>::max()) < transform_block_size()) ? std::size_t(std::numeric_limits<T>::max()) : transform_block_size();
+		}
+
+		// all partial sums of n values in [lo, hi], added to sum, are in the returned interval
+		template <typename T>
+		safe_interval<T> partial_sums_interval(const T sum, const safe_interval<T> values, const std::size_t n) {
+			return safe_interval<T>(sum) +
+			    safe_interval<T>(values.min() < T{0} ? values.min() : T{0}, values.max() < T{0} ? T{0} : values.max()) * safe_interval<T>(T(n));
+		}
+
+		// unchecked running sum of the first values, returns how many values have been summed
+		template <bool exclusive, typename T, typename In, typename Out>
+		std::size_t scan_simd(const In*, const std::size_t, Out*, T&) noexcept {
+			return 0;
+		}
+#if defined(__SSE2__)
+		// log-step scan of 4 values in every register: x + (x << 1 value) + (x << 2 values)
+		// two's complement addition is the same for signed and unsigned values
+		template <bool exclusive, typename T, typename In, typename = typename std::enable_if<sizeof(T) == 4 && sizeof(In) == 4>::type>
+		std::size_t scan_simd(const In* first, const std::size_t count, In* out, T& sum) noexcept {
+			__m128i carry = _mm_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(sum)));
+			std::size_t i = 0;
+			for(; count - i >= 4; i += 4){
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+				__m128i x = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+				x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+				x = _mm_add_epi32(x, carry);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), exclusive ? _mm_sub_epi32(x, v) : x);
+				carry = _mm_shuffle_epi32(x, 0xFF);
+			}
+			sum = from_unsigned<T>(static_cast<typename std::make_unsigned<T>::type>(_mm_cvtsi128_si32(carry)));
+			return i;
+		}
+#endif
+
+		// true if all values of the interval can be represented by T, and all partial sums of n of them, added to sum
+		template <typename T, typename In>
+		bool is_safe_scan_block(const T sum, const safe_interval<In> values, const std::size_t n) {
+			return in_range<T>(values.min()) && in_range<T>(values.max()) &&
+			    partial_sums_interval(sum, safe_interval<T>(static_cast<T>(values.min()), static_cast<T>(values.max())), n).is_valid();
+		}
+
+		// running sum, of type T, of the count values starting at first, written to out if out is not null
+		// On return, sum is the sum of the values before the returned index
+		template <bool exclusive, typename T, typename In, typename Out>
+		std::size_t safe_scan(const In* first, const std::size_t count, Out* out, T& sum) {
+			using In_raw = decltype(raw_value(*first));
+			T s = sum;
+			for(std::size_t b = 0; b < count; b += scan_block_size<T>()){
+				const std::size_t n = (count - b < scan_block_size<T>()) ? count - b : scan_block_size<T>();
+				if(is_safe_scan_block(s, minmax_interval<In_raw>(first + b, n), n)){
+					if(out == nullptr){
+						for(std::size_t i = b; i != b + n; ++i){
+							s = static_cast<T>(s + static_cast<T>(raw_value(first[i])));
+						}
+					} else {
+						for(std::size_t i = b + scan_simd<exclusive>(first + b, n, out + b, s); i != b + n; ++i){
+							const T v = static_cast<T>(raw_value(first[i]));
+							if(exclusive){
+								out[i] = s;
+							}
+							s = static_cast<T>(s + v);
+							if(!exclusive){
+								out[i] = s;
+							}
+						}
+					}
+					continue;
+				}
+				for(std::size_t i = b; i != b + n; ++i){
+					const In_raw r = raw_value(first[i]);
+					if(!in_range<T>(r) || !is_safe_add(s, static_cast<T>(r))){
+						sum = s;
+						return i;
+					}
+					const T v = static_cast<T>(r);
+					if(exclusive && out != nullptr){
+						out[i] = s;
+					}
+					s = static_cast<T>(s + v);
+					if(!exclusive && out != nullptr){
+						out[i] = s;
+					}
+				}
+			}
+			sum = s;
+			return count;
+		}
+
+		// chunks smaller than this are not worth a thread
+		constexpr std::size_t scan_min_chunk_size() noexcept {
+			return std::size_t(1) << 16;
+		}
+
+		template <bool exclusive, typename T, typename T0>
+		std::size_t safe_scan_parallel(const T* first, const std::size_t count, T0* out, const T0 init, unsigned threads) {
+			threads = (count / scan_min_chunk_size() < threads) ? unsigned(count / scan_min_chunk_size()) : threads;
+			if(threads <= 1){
+				T0 sum = init;
+				return safe_scan<exclusive>(first, count, out, sum);
+			}
+			const std::size_t chunk = (count + threads - 1) / threads;
+			const auto chunk_size = [&](const unsigned t){ return count - t * chunk < chunk ? count - t * chunk : chunk; };
+			std::vector<T0> sums(threads, T0{0});
+			std::vector<std::size_t> results(threads, count);
+			std::vector<std::thread> workers;
+			workers.reserve(threads - 1);
+			using job = void (*)(const T*, std::size_t, T0*, T0&, std::size_t&);
+			const auto run = [&](const job f){
+				for(unsigned t = 1; t != threads; ++t){
+					workers.emplace_back(f, first + t * chunk, chunk_size(t), out + t * chunk, std::ref(sums[t]), std::ref(results[t]));
+				}
+				f(first, chunk_size(0), out, sums[0], results[0]);
+				for(auto& w : workers){
+					w.join();
+				}
+				workers.clear();
+			};
+
+			// first pass: the sum of every chunk
+			run([](const T* f, const std::size_t n, T0*, T0& sum, std::size_t& result){
+				result = safe_scan<exclusive>(f, n, static_cast<T0*>(nullptr), sum);
+			});
+			// the sum before every chunk, if a chunk or a sum overflows, the overflowing index is searched sequentially
+			T0 sum = init;
+			for(unsigned t = 0; t != threads; ++t){
+				if(results[t] != chunk_size(t) || !is_safe_add(sum, sums[t])){
+					sum = init;
+					return safe_scan<exclusive>(first, count, out, sum);
+				}
+				const T0 chunk_sum = sums[t];
+				sums[t] = sum;
+				sum = static_cast<T0>(sum + chunk_sum);
+			}
+			// second pass: the partial sums of every chunk, starting from the sum of the preceding chunks
+			run([](const T* f, const std::size_t n, T0* o, T0& sum, std::size_t& result){
+				result = safe_scan<exclusive>(f, n, o, sum);
+			});
+			for(unsigned t = 0; t != threads; ++t){
+				if(results[t] != chunk_size(t)){
+					return t * chunk + results[t];
+				}
+			}
+			return count;
+		}
+	} // end details
+
+	/// out[i] = init + first[0] + ... + first[i], for the count values starting at first (out may be equal to first)
+	/// The running sum has the type T0 of out, for example 64 bits offsets of 32 bits sizes.
+	/// The values are processed in blocks. The minimum and maximum values of every block are searched first, if the running
+	/// sum cannot overflow inside the block, the block is summed without any check, otherwise with a check for every value.
+	/// Returns the index of the first value for which the running sum overflows, or is not representable by T0 (its result,
+	/// and the following, are not written), or count if all values have been summed
+	///
+	/// Example Usage:
+	/// @code
+	/// 	std::vector<std::uint32_t> sizes = ...
+	/// 	std::vector<std::uint64_t> offsets(sizes.size());
+	/// 	if(safe_inclusive_scan(sizes.data(), sizes.size(), offsets.data()) != sizes.size()){
+	/// 		// corrupted sizes
+	/// 	}
+	/// @endcode
+	template <typename T, typename T0>
+	std::size_t safe_inclusive_scan(const T* first, const std::size_t count, T0* out, typename std::remove_cv<T0>::type init = T0{0}) {
+		return details::safe_scan<false>(first, count, out, init);
+	}
+
+	/// out[i] = init + first[0] + ... + first[i-1], for the count values starting at first (out may be equal to first)
+	/// Like safe_inclusive_scan, returns the index of the first value for which the running sum overflows T0
+	template <typename T, typename T0>
+	std::size_t safe_exclusive_scan(const T* first, const std::size_t count, T0* out, typename std::remove_cv<T0>::type init = T0{0}) {
+		return details::safe_scan<true>(first, count, out, init);
+	}
+
+	/// Like safe_inclusive_scan, but the values are split in one chunk per thread, and summed in two passes: the sum of every
+	/// chunk, and then the partial sums of every chunk.
+	/// If the running sum overflows, the following values may have been written too.
+	template <typename T, typename T0>
+	std::size_t safe_inclusive_scan_parallel(const T* first, const std::size_t count, T0* out, const typename std::remove_cv<T0>::type init = T0{0},
+	                                         const unsigned threads = std::thread::hardware_concurrency()) {
+		return details::safe_scan_parallel<false>(first, count, out, init, threads);
+	}
+
+	/// Like safe_exclusive_scan, with the threads of safe_inclusive_scan_parallel
+	template <typename T, typename T0>
+	std::size_t safe_exclusive_scan_parallel(const T* first, const std::size_t count, T0* out, const typename std::remove_cv<T0>::type init = T0{0},
+	                                         const unsigned threads = std::thread::hardware_concurrency()) {
+		return details::safe_scan_parallel<true>(first, count, out, init, threads);
+	}
+
+	/// Like safe_inclusive_scan with raw values, but an exception is thrown if the running sum overflows, after all
+	/// preceding values have been written
+	template <typename T>
+	void safe_inclusive_scan(const safe_integral<T>* first, const std::size_t count, safe_integral<T>* out, const safe_integral<typename std::remove_cv<T>::type> init = T{0}) {
+		T sum = init.getvalue();
+		if(details::safe_scan<false>(first, count, out, sum) != count){
+			throw std::out_of_range("overflow with safe_inclusive_scan");
+		}
+	}
+
+	template <typename T>
+	void safe_exclusive_scan(const safe_integral<T>* first, const std::size_t count, safe_integral<T>* out, const safe_integral<typename std::remove_cv<T>::type> init = T{0}) {
+		T sum = init.getvalue();
+		if(details::safe_scan<true>(first, count, out, sum) != count){
+			throw std::out_of_range("overflow with safe_exclusive_scan");
+		}
+	}
+}
+
+#endif // SAFEINTEGRAL_SAFESCAN_HPP
@@ -0,0 +1,208 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFESPAN_HPP
+#define SAFEINTEGRAL_SAFESPAN_HPP
+
+#include "safeintegral.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace safeintegralop {
+
+	/// true if safe_integral<T> has the same representation of T: same size, same alignment, and standard layout.
+	/// This is a precondition of raw_data, not a guarantee that it is well-defined (see raw_data).
+	template <typename T>
+	struct is_layout_compatible_safe_integral : std::integral_constant<bool,
+		std::is_standard_layout<safe_integral<T>>::value &&
+		sizeof(safe_integral<T>) == sizeof(T) &&
+		alignof(safe_integral<T>) == alignof(T)
+	> {};
+
+	/// Returns a pointer to the storage of an array of safe_integral, for passing it to functions that take raw integral buffers
+	/// The standard only guarantees that the returned pointer points to the member of p[0]: accessing the other elements
+	/// through it relies on the layout checked by is_layout_compatible_safe_integral, and on the compiler not taking
+	/// advantage of the fact that it indexes across different objects, as GCC, Clang and MSVC do not.
+	/// Functions of this library that process arrays of safe_integral use getvalue() on every element instead.
+	/// Example Usage:
+	/// @code
+	/// 	std::vector<safe_int> v(size);
+	/// 	write_to_file(safeintegralop::raw_data(v.data()), v.size());
+	/// @endcode
+	template <typename T>
+	T* raw_data(safe_integral<T>* p) noexcept {
+		static_assert(is_layout_compatible_safe_integral<T>::value, "safe_integral<T> and T have a different layout");
+		return reinterpret_cast<T*>(p);
+	}
+
+	template <typename T>
+	const T* raw_data(const safe_integral<T>* p) noexcept {
+		static_assert(is_layout_compatible_safe_integral<T>::value, "safe_integral<T> and T have a different layout");
+		return reinterpret_cast<const T*>(p);
+	}
+}
+
+/// This class is a non-owning view of a buffer of integrals (for example a memory mapped file or a network buffer),
+/// accessed as safe_integral, without copying it.
+/// Since the buffer contains T and not safe_integral<T>, the elements are accessed through a proxy reference, that reads
+/// and writes T and performs all operations with safe_integral<T>. If an operation throws, the element is not modified.
+/// If T is const, the elements can only be read.
+/// Binary operators are found only for safe_integral, get() returns the element as safe_integral: s[0].get() + s[1].
+/// As with safe_range, the iterators are random access iterators for C++20 (iterator_concept), but only input iterators
+/// for the requirements of the previous standards (iterator_category), since they do not return references.
+///
+/// Example Usage:
+/// @code
+/// 	safe_span<std::int32_t> s(buffer, size);
+/// 	s[0] += 42; // throws on overflow
+/// 	safe_int32 sum = std::accumulate(s.begin(), s.end(), safe_int32(0));
+/// @endcode
+template<typename T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+class safe_span {
+	private:
+		using V = typename std::remove_const<T>::type;
+		T* first;
+		std::size_t count;
+
+	public:
+		using element_type = T;
+		using value_type = safe_integral<V>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		class reference {
+			private:
+				T* p;
+				friend class safe_span;
+				explicit constexpr reference(T* p_) noexcept : p(p_) {}
+			public:
+				reference(const reference&) noexcept = default;
+
+				/// Returns the value of the element
+				constexpr V getvalue() const noexcept { return *p; }
+				constexpr value_type get() const noexcept { return value_type(*p); }
+				constexpr operator value_type() const noexcept { return value_type(*p); }
+
+				reference& operator=(const value_type rhs) noexcept {
+					static_assert(!std::is_const<T>::value, "element is const");
+					*p = rhs.getvalue();
+					return *this;
+				}
+				// assigns the value, not the reference
+				reference& operator=(const reference& rhs) noexcept { return *this = rhs.get(); }
+
+				reference& operator+=(const value_type rhs) { value_type v = get(); v += rhs; return *this = v; }
+				reference& operator-=(const value_type rhs) { value_type v = get(); v -= rhs; return *this = v; }
+				reference& operator*=(const value_type rhs) { value_type v = get(); v *= rhs; return *this = v; }
+				reference& operator/=(const value_type rhs) { value_type v = get(); v /= rhs; return *this = v; }
+				reference& operator%=(const value_type rhs) { value_type v = get(); v %= rhs; return *this = v; }
+				reference& operator++() { value_type v = get(); ++v; return *this = v; }
+				reference& operator--() { value_type v = get(); --v; return *this = v; }
+
+				constexpr friend bool operator==(const reference lhs, const value_type rhs) noexcept { return lhs.get() == rhs; }
+				constexpr friend bool operator!=(const reference lhs, const value_type rhs) noexcept { return lhs.get() != rhs; }
+				constexpr friend bool operator<(const reference lhs, const value_type rhs) noexcept { return lhs.get() < rhs; }
+				constexpr friend bool operator>(const reference lhs, const value_type rhs) noexcept { return lhs.get() > rhs; }
+				constexpr friend bool operator<=(const reference lhs, const value_type rhs) noexcept { return lhs.get() <= rhs; }
+				constexpr friend bool operator>=(const reference lhs, const value_type rhs) noexcept { return lhs.get() >= rhs; }
+		};
+
+		class iterator {
+			private:
+				T* p;
+				friend class safe_span;
+				explicit constexpr iterator(T* p_) noexcept : p(p_) {}
+			public:
+				// operator* returns a proxy and not a reference, see the documentation of safe_span
+				using iterator_category = std::input_iterator_tag;
+#if  __cplusplus > 201703L // compiling with c++20 or greater
+				using iterator_concept = std::random_access_iterator_tag;
+#endif
+				using value_type = safe_integral<V>;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = typename safe_span::reference;
+
+				constexpr iterator() noexcept : p() {}
+
+				constexpr reference operator*() const noexcept { return reference(p); }
+				constexpr reference operator[](const difference_type n) const noexcept { return reference(p + n); }
+
+				iterator& operator++() noexcept { ++p; return *this; }
+				iterator operator++(int) noexcept { iterator tmp(*this); ++p; return tmp; }
+				iterator& operator--() noexcept { --p; return *this; }
+				iterator operator--(int) noexcept { iterator tmp(*this); --p; return tmp; }
+				iterator& operator+=(const difference_type n) noexcept { p += n; return *this; }
+				iterator& operator-=(const difference_type n) noexcept { p -= n; return *this; }
+
+				constexpr friend iterator operator+(const iterator it, const difference_type n) noexcept { return iterator(it.p + n); }
+				constexpr friend iterator operator+(const difference_type n, const iterator it) noexcept { return iterator(it.p + n); }
+				constexpr friend iterator operator-(const iterator it, const difference_type n) noexcept { return iterator(it.p - n); }
+				constexpr friend difference_type operator-(const iterator lhs, const iterator rhs) noexcept { return lhs.p - rhs.p; }
+
+				constexpr friend bool operator==(const iterator lhs, const iterator rhs) noexcept { return lhs.p == rhs.p; }
+				constexpr friend bool operator!=(const iterator lhs, const iterator rhs) noexcept { return lhs.p != rhs.p; }
+				constexpr friend bool operator<(const iterator lhs, const iterator rhs) noexcept { return lhs.p < rhs.p; }
+				constexpr friend bool operator>(const iterator lhs, const iterator rhs) noexcept { return lhs.p > rhs.p; }
+				constexpr friend bool operator<=(const iterator lhs, const iterator rhs) noexcept { return lhs.p <= rhs.p; }
+				constexpr friend bool operator>=(const iterator lhs, const iterator rhs) noexcept { return lhs.p >= rhs.p; }
+		};
+
+		constexpr safe_span() noexcept : first(nullptr), count(0) {}
+		/// Constructor
+		/// Views the count elements starting at data
+		constexpr safe_span(T* data_, const size_type count_) noexcept : first(data_), count(count_) {}
+		template<std::size_t N>
+		constexpr safe_span(T (&arr)[N]) noexcept : first(arr), count(N) {}
+		/// Constructor
+		/// Views a buffer of safe_integral, for example for passing it to a function that takes a safe_span
+		/// Since the elements are accessed as T, this relies on raw_data and has the same caveats
+		safe_span(typename std::conditional<std::is_const<T>::value, const value_type, value_type>::type* data_, const size_type count_) noexcept
+			: first(safeintegralop::raw_data(data_)), count(count_) {}
+		/// Conversion to a read-only view
+		template<typename U, class = typename std::enable_if<std::is_const<T>::value && std::is_same<U, V>::value>::type>
+		constexpr safe_span(const safe_span<U>& other) noexcept : first(other.data()), count(other.size()) {}
+
+		iterator begin() const noexcept { return iterator(first); }
+		iterator end() const noexcept { return iterator(first + count); }
+		T* data() const noexcept { return first; }
+		constexpr size_type size() const noexcept { return count; }
+		constexpr bool empty() const noexcept { return count == 0; }
+		reference operator[](const size_type i) const noexcept { return reference(first + i); }
+		/// Same as operator[], but throws if i is not a valid index
+		reference at(const size_type i) const {
+			if(i >= count){
+				throw std::out_of_range("safe_span index out of range");
+			}
+			return reference(first + i);
+		}
+		safe_span subspan(const size_type offset, const size_type n) const {
+			if(offset > count || n > count - offset){
+				throw std::out_of_range("safe_span subspan out of range");
+			}
+			return safe_span(first + offset, n);
+		}
+};
+
+template<typename T>
+safe_span<T> make_safe_span(T* data, const std::size_t count) noexcept {
+	return safe_span<T>(data, count);
+}
+
+#endif // SAFEINTEGRAL_SAFESPAN_HPP
@@ -0,0 +1,301 @@
+/*
+	Copyright (C) 2015-2018 Federico Kircheis
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SAFEINTEGRAL_SAFEVARINT_HPP
+#define SAFEINTEGRAL_SAFEVARINT_HPP
+
+#include "safeintegral.hpp"
+#include "saferange.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace safeintegralop {
+
+	/// A varint (LEB128) of 64 bits needs at most 10 bytes
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	inline constexpr std::size_t max_varint_bytes = 10; // external linkage, for the templates exported by the module
+#else
+	const std::size_t max_varint_bytes = 10;
+#endif
+
+	/// Returns the number of bytes of the varint of v
+	constexpr std::size_t varint_size(const std::uint64_t v) noexcept {
+		return (v < 0x80u) ? 1 : 1 + varint_size(v >> 7);
+	}
+
+	/// Maps signed values to unsigned values, with small magnitudes to small values: 0, -1, 1, -2, 2... to 0, 1, 2, 3, 4...
+	constexpr std::uint64_t zigzag_encode(const std::int64_t v) noexcept {
+		return (std::uint64_t(v) << 1) ^ ((v < 0) ? ~std::uint64_t{0} : std::uint64_t{0});
+	}
+
+	constexpr std::int64_t zigzag_decode(const std::uint64_t u) noexcept {
+		return details::from_unsigned<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));
+	}
+
+	// All functions in the namespace "details" are for private use
+	namespace details{
+		// decodes the varint starting at first, of at most size bytes
+		// returns the number of bytes read, or 0 if the varint is truncated or has more than 64 bits
+		inline std::size_t decode_varint_u64(const unsigned char* first, const std::size_t size, std::uint64_t& v) noexcept {
+			std::uint64_t res = 0;
+			for(std::size_t i = 0; i != size && i != max_varint_bytes; ++i){
+				const std::uint64_t b = first[i];
+				if(i == max_varint_bytes - 1 && b > 1){
+					return 0;
+				}
+				res |= (b & 0x7Fu) << (7 * i);
+				if(b < 0x80u){
+					v = res;
+					return i + 1;
+				}
+			}
+			return 0;
+		}
+
+		// the low 7 bits of the (at most 8) bytes of x, without the gaps
+		inline std::uint64_t compact_varint_bytes(std::uint64_t x) noexcept {
+#if defined(__BMI2__)
+			return _pext_u64(x, 0x7F7F7F7F7F7F7F7Full);
+#else
+			x &= 0x7F7F7F7F7F7F7F7Full;
+			x = ((x & 0x7F007F007F007F00ull) >> 1) | (x & 0x007F007F007F007Full);
+			x = ((x & 0x3FFF00003FFF0000ull) >> 2) | (x & 0x00003FFF00003FFFull);
+			return ((x & 0x0FFFFFFF00000000ull) >> 4) | (x & 0x000000000FFFFFFFull);
+#endif
+		}
+
+		// decodes the varint of len bytes (from 1 to 10) starting at first, the 8 bytes starting at first need to be readable
+		// returns false if it has more than 64 bits
+		inline bool decode_varint_len(const unsigned char* first, const unsigned len, std::uint64_t& v) noexcept {
+			std::uint64_t x;
+			std::memcpy(&x, first, sizeof(x));
+			if(len < 8){
+				x &= (std::uint64_t{1} << (8 * len)) - 1;
+			}
+			v = compact_varint_bytes(x);
+			if(len > 8){
+				v |= std::uint64_t(first[8] & 0x7Fu) << 56;
+				if(len == 10){
+					if(first[9] > 1){
+						return false;
+					}
+					v |= std::uint64_t(first[9]) << 63;
+				}
+			}
+			return true;
+		}
+
+		// index of the lowest set bit, x needs to be different from 0
+		inline unsigned lowest_bit(unsigned x) noexcept {
+#if defined(__GNUC__)
+			return unsigned(__builtin_ctz(x));
+#else
+			unsigned res = 0;
+			for(; (x & 1u) == 0; x >>= 1){
+				++res;
+			}
+			return res;
+#endif
+		}
+
+		// zigzag_decode of a varint of one byte
+		inline int zigzag_decode_byte(const unsigned char b) noexcept {
+			return int(b >> 1) ^ -int(b & 1u);
+		}
+
+		template <bool zigzag, typename T0>
+		bool varint_value(const std::uint64_t u, T0& out) noexcept {
+			if(zigzag){
+				const std::int64_t s = zigzag_decode(u);
+				if(!in_range<T0>(s)){
+					return false;
+				}
+				out = T0(s);
+				return true;
+			}
+			if(!in_range<T0>(u)){
+				return false;
+			}
+			out = T0(u);
+			return true;
+		}
+
+		template <bool zigzag, typename T0>
+		std::size_t decode_varint(const unsigned char* first, const std::size_t size, safe_integral<T0>& out) noexcept {
+			std::uint64_t u = 0;
+			const std::size_t n = decode_varint_u64(first, size, u);
+			T0 v{};
+			if(n == 0 || !varint_value<zigzag>(u, v)){
+				return 0;
+			}
+			out = v;
+			return n;
+		}
+
+		template <bool zigzag, typename T0, typename Out>
+		std::size_t decode_varints(const unsigned char* first, const std::size_t size, Out* out, const std::size_t count, std::size_t& read) noexcept {
+			std::size_t i = 0;
+			std::size_t pos = 0;
+			T0 v{};
+#if defined(__SSE2__)
+			// masked-VByte: the continuation bits of 16 bytes at once give the length of all values ending in these bytes,
+			// the values are decoded without a branch for every byte.
+			// The 32 bytes starting at pos need to be readable, as the values are loaded with 8 bytes.
+			while(count - i >= 16 && size - pos >= 32){
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + pos));
+				const unsigned mask = unsigned(_mm_movemask_epi8(bytes));
+				if(mask == 0 && (!zigzag || std::is_signed<T0>::value)){
+					// 16 values of one byte, representable by every T0 (from -64 to 63 if zigzag, by every signed T0)
+					for(std::size_t k = 0; k != 16; ++k){
+						out[i + k] = zigzag ? T0(zigzag_decode_byte(first[pos + k])) : T0(first[pos + k]);
+					}
+					i += 16;
+					pos += 16;
+					continue;
+				}
+				unsigned ends = ~mask & 0xFFFFu;
+				unsigned start = 0;
+				while(ends != 0){
+					const unsigned e = lowest_bit(ends);
+					std::uint64_t u = 0;
+					if(e - start + 1 > max_varint_bytes || !decode_varint_len(first + pos + start, e - start + 1, u) || !varint_value<zigzag>(u, v)){
+						read = pos + start;
+						return i;
+					}
+					out[i] = v;
+					++i;
+					start = e + 1;
+					ends &= ends - 1;
+				}
+				if(start == 0){
+					// 16 bytes without the end of a value
+					read = pos;
+					return i;
+				}
+				pos += start;
+			}
+#endif
+			for(; i != count; ++i){
+				std::uint64_t u = 0;
+				const std::size_t n = decode_varint_u64(first + pos, size - pos, u);
+				if(n == 0 || !varint_value<zigzag>(u, v)){
+					break;
+				}
+				out[i] = v;
+				pos += n;
+			}
+			read = pos;
+			return i;
+		}
+	} // end details
+
+	/// Writes the varint (LEB128) of v to out, and returns the number of bytes written (at most max_varint_bytes)
+	///
+	/// Example Usage:
+	/// @code
+	/// 	unsigned char buffer[safeintegralop::max_varint_bytes];
+	/// 	const auto n = safeintegralop::encode_varint(std::uint32_t(300), buffer); // n == 2
+	/// @endcode
+	template <typename T>
+	std::size_t encode_varint(const T v, unsigned char* out) noexcept {
+		static_assert(std::is_unsigned<T>::value && !std::is_same<T, bool>::value, "T needs to be an unsigned integral, use encode_zigzag for signed values");
+		std::uint64_t u = v;
+		std::size_t i = 0;
+		for(; u >= 0x80u; ++i){
+			out[i] = static_cast<unsigned char>(u | 0x80u);
+			u >>= 7;
+		}
+		out[i] = static_cast<unsigned char>(u);
+		return i + 1;
+	}
+
+	template <typename T>
+	std::size_t encode_varint(const safe_integral<T> v, unsigned char* out) noexcept {
+		return encode_varint(v.getvalue(), out);
+	}
+
+	/// Writes the varint of the zigzag encoding of v to out, and returns the number of bytes written
+	template <typename T>
+	std::size_t encode_zigzag(const T v, unsigned char* out) noexcept {
+		static_assert(std::is_signed<T>::value && std::is_integral<T>::value, "T needs to be a signed integral, use encode_varint for unsigned values");
+		return encode_varint(zigzag_encode(v), out);
+	}
+
+	template <typename T>
+	std::size_t encode_zigzag(const safe_integral<T> v, unsigned char* out) noexcept {
+		return encode_zigzag(v.getvalue(), out);
+	}
+
+	/// Decodes the varint starting at first, of at most size bytes, to out
+	/// Returns the number of bytes read, or 0 (out is not modified) if the varint is truncated, has more than 64 bits
+	/// (longer than max_varint_bytes, or with too many bits in the last byte), or its value is not representable by T0
+	///
+	/// Example Usage:
+	/// @code
+	/// 	safe_integral<std::uint16_t> port;
+	/// 	const auto n = safeintegralop::decode_varint(data, size, port);
+	/// 	if(n == 0){
+	/// 		// malformed input
+	/// 	}
+	/// @endcode
+	template <typename T0>
+	std::size_t decode_varint(const unsigned char* first, const std::size_t size, safe_integral<T0>& out) noexcept {
+		return details::decode_varint<false>(first, size, out);
+	}
+
+	/// Like decode_varint, for the values written with encode_zigzag
+	template <typename T0>
+	std::size_t decode_zigzag(const unsigned char* first, const std::size_t size, safe_integral<T0>& out) noexcept {
+		return details::decode_varint<true>(first, size, out);
+	}
+
+	/// Decodes count varints from the size bytes starting at first to out
+	/// Returns the index of the first value that is truncated, has more than 64 bits, or is not representable by T0 (it,
+	/// and the following values, are not written), or count if all values have been decoded.
+	/// read is set to the number of bytes of the decoded values.
+	/// Blocks of 16 bytes are decoded with SSE2, with the continuation bits of all bytes (masked-VByte).
+	template <typename T0>
+	std::size_t decode_varints(const unsigned char* first, const std::size_t size, T0* out, const std::size_t count, std::size_t& read) noexcept {
+		return details::decode_varints<false, T0>(first, size, out, count, read);
+	}
+
+	template <typename T0>
+	std::size_t decode_varints(const unsigned char* first, const std::size_t size, safe_integral<T0>* out, const std::size_t count, std::size_t& read) noexcept {
+		return details::decode_varints<false, T0>(first, size, out, count, read);
+	}
+
+	/// Like decode_varints, for the values written with encode_zigzag
+	template <typename T0>
+	std::size_t decode_zigzags(const unsigned char* first, const std::size_t size, T0* out, const std::size_t count, std::size_t& read) noexcept {
+		return details::decode_varints<true, T0>(first, size, out, count, read);
+	}
+
+	template <typename T0>
+	std::size_t decode_zigzags(const unsigned char* first, const std::size_t size, safe_integral<T0>* out, const std::size_t count, std::size_t& read) noexcept {
+		return details::decode_varints<true, T0>(first, size, out, count, read);
+	}
+}
+
+#endif // SAFEINTEGRAL_SAFEVARINT_HPP
@@ -0,0 +1,145 @@
+// Probe functions for the codegen regression test (target SafeIntegralCodegen)
+// Every function wraps exactly one operation, the name is probe_<op>_<type(s)>.
+// The functions have C linkage so that their symbol names are stable between compilers.
+#include "../../safeintegral/safeintegral.hpp"
+#include "../../safeintegral/safeintegralop.hpp"
+#include "../../safeintegral/safedivider.hpp"
+#include "../../safeintegral/safeaccumulator.hpp"
+
+#define SAFE_INTEGRAL_PROBE_BINARY(name, op, T)                   \
+	extern "C" T probe_##name##_##T(T a, T b);                    \
+	extern "C" T probe_##name##_##T(T a, T b) {                   \
+		return (safe_integral<T>(a) op safe_integral<T>(b)).getvalue(); \
+	}
+#define SAFE_INTEGRAL_PROBE_UNARY(name, op, T)                    \
+	extern "C" T probe_##name##_##T(T a);                         \
+	extern "C" T probe_##name##_##T(T a) {                        \
+		return (op safe_integral<T>(a)).getvalue();               \
+	}
+#define SAFE_INTEGRAL_PROBE_IS_SAFE(name, T)                      \
+	extern "C" bool probe_is_safe_##name##_##T(T a, T b);         \
+	extern "C" bool probe_is_safe_##name##_##T(T a, T b) {        \
+		return safeintegralop::is_safe_##name(a, b);              \
+	}
+#define SAFE_INTEGRAL_PROBE_CONSTANT(name, op, T, V)              \
+	extern "C" T probe_##name##_##V##_##T(T a);                   \
+	extern "C" T probe_##name##_##V##_##T(T a) {                  \
+		return (safe_integral<T>(a) op std::integral_constant<T, V>{}).getvalue(); \
+	}
+#define SAFE_INTEGRAL_PROBE_TYPE(T)                               \
+	SAFE_INTEGRAL_PROBE_BINARY(add, +, T)                         \
+	SAFE_INTEGRAL_PROBE_BINARY(diff, -, T)                        \
+	SAFE_INTEGRAL_PROBE_BINARY(mult, *, T)                        \
+	SAFE_INTEGRAL_PROBE_BINARY(div, /, T)                         \
+	SAFE_INTEGRAL_PROBE_BINARY(mod, %, T)                         \
+	SAFE_INTEGRAL_PROBE_BINARY(leftshift, <<, T)                  \
+	SAFE_INTEGRAL_PROBE_BINARY(rightshift, >>, T)                 \
+	SAFE_INTEGRAL_PROBE_UNARY(neg, -, T)                          \
+	SAFE_INTEGRAL_PROBE_UNARY(inc, ++, T)                         \
+	SAFE_INTEGRAL_PROBE_IS_SAFE(add, T)                           \
+	SAFE_INTEGRAL_PROBE_IS_SAFE(mult, T)                          \
+	SAFE_INTEGRAL_PROBE_IS_SAFE(div, T)                           \
+	SAFE_INTEGRAL_PROBE_CONSTANT(div, /, T, 1000)                 \
+	SAFE_INTEGRAL_PROBE_CONSTANT(mod, %, T, 60)                   \
+	SAFE_INTEGRAL_PROBE_CONSTANT(leftshift, <<, T, 10)            \
+	SAFE_INTEGRAL_PROBE_CONSTANT(rightshift, >>, T, 10)
+
+using llong = long long;
+using ullong = unsigned long long;
+
+SAFE_INTEGRAL_PROBE_TYPE(int)
+SAFE_INTEGRAL_PROBE_TYPE(unsigned)
+SAFE_INTEGRAL_PROBE_TYPE(llong)
+SAFE_INTEGRAL_PROBE_TYPE(ullong)
+
+#define SAFE_INTEGRAL_PROBE_DIVIDER(T)                                \
+	extern "C" T probe_divider_##T(T a, const safe_divider<T>& d);    \
+	extern "C" T probe_divider_##T(T a, const safe_divider<T>& d) {   \
+		return (safe_integral<T>(a) / d).getvalue();                  \
+	}
+
+SAFE_INTEGRAL_PROBE_DIVIDER(int)
+SAFE_INTEGRAL_PROBE_DIVIDER(unsigned)
+SAFE_INTEGRAL_PROBE_DIVIDER(llong)
+SAFE_INTEGRAL_PROBE_DIVIDER(ullong)
+
+#define SAFE_INTEGRAL_PROBE_ACCUMULATOR(T)                                      \
+	extern "C" void probe_accumulator_##T(safe_accumulator<T>& acc, T a);      \
+	extern "C" void probe_accumulator_##T(safe_accumulator<T>& acc, T a) {     \
+		acc += a;                                                               \
+	}
+
+SAFE_INTEGRAL_PROBE_ACCUMULATOR(int)
+SAFE_INTEGRAL_PROBE_ACCUMULATOR(unsigned)
+SAFE_INTEGRAL_PROBE_ACCUMULATOR(llong)
+SAFE_INTEGRAL_PROBE_ACCUMULATOR(ullong)
+
+// safe_result, the same operations of SAFE_INTEGRAL_PROBE_MIXED and SAFE_INTEGRAL_PROBE_STORE, without std::optional
+#define SAFE_INTEGRAL_PROBE_RESULT(name, T0, T1, T2)                     \
+	extern "C" T0 probe_##name##_result_##T0##_##T1##_##T2(T1 a, T2 b);  \
+	extern "C" T0 probe_##name##_result_##T0##_##T1##_##T2(T1 a, T2 b) { \
+		return safeintegralop::name##_result<T0>(a, b).value_or(T0{0});  \
+	}
+#define SAFE_INTEGRAL_PROBE_STORE_RESULT(name, T0, T1, T2)                                 \
+	extern "C" bool probe_store_##name##_result_##T0##_##T1##_##T2(T1 a, T2 b, T0* out);   \
+	extern "C" bool probe_store_##name##_result_##T0##_##T1##_##T2(T1 a, T2 b, T0* out) {  \
+		const auto res = safeintegralop::name##_result<T0>(a, b);                          \
+		if(res){                                                                           \
+			*out = res.value;                                                              \
+		}                                                                                  \
+		return res.ok;                                                                     \
+	}
+#define SAFE_INTEGRAL_PROBE_RESULT_TYPES(T0, T1, T2)                     \
+	SAFE_INTEGRAL_PROBE_RESULT(safe_add, T0, T1, T2)                     \
+	SAFE_INTEGRAL_PROBE_RESULT(safe_diff, T0, T1, T2)                    \
+	SAFE_INTEGRAL_PROBE_RESULT(safe_mult, T0, T1, T2)                    \
+	SAFE_INTEGRAL_PROBE_RESULT(safe_div, T0, T1, T2)                     \
+	SAFE_INTEGRAL_PROBE_RESULT(safe_mod, T0, T1, T2)                     \
+	SAFE_INTEGRAL_PROBE_STORE_RESULT(safe_add, T0, T1, T2)               \
+	SAFE_INTEGRAL_PROBE_STORE_RESULT(safe_mult, T0, T1, T2)
+
+SAFE_INTEGRAL_PROBE_RESULT_TYPES(int, int, int)
+SAFE_INTEGRAL_PROBE_RESULT_TYPES(int, int, unsigned)
+SAFE_INTEGRAL_PROBE_RESULT_TYPES(unsigned, llong, unsigned)
+SAFE_INTEGRAL_PROBE_RESULT_TYPES(llong, ullong, llong)
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+#define SAFE_INTEGRAL_PROBE_MIXED(name, T0, T1, T2)                      \
+	extern "C" T0 probe_##name##_##T0##_##T1##_##T2(T1 a, T2 b);         \
+	extern "C" T0 probe_##name##_##T0##_##T1##_##T2(T1 a, T2 b) {        \
+		return safeintegralop::name<T0>(a, b).value_or(T0{0});           \
+	}
+#define SAFE_INTEGRAL_PROBE_STORE(name, T0, T1, T2)                                \
+	extern "C" bool probe_store_##name##_##T0##_##T1##_##T2(T1 a, T2 b, T0* out);   \
+	extern "C" bool probe_store_##name##_##T0##_##T1##_##T2(T1 a, T2 b, T0* out) {  \
+		const auto res = safeintegralop::name<T0>(a, b);                            \
+		if(res){                                                                    \
+			*out = *res;                                                            \
+		}                                                                           \
+		return res.has_value();                                                     \
+	}
+#define SAFE_INTEGRAL_PROBE_MIXED_TYPES(T0, T1, T2)                      \
+	SAFE_INTEGRAL_PROBE_MIXED(safe_add, T0, T1, T2)                      \
+	SAFE_INTEGRAL_PROBE_MIXED(safe_diff, T0, T1, T2)                     \
+	SAFE_INTEGRAL_PROBE_MIXED(safe_mult, T0, T1, T2)                     \
+	SAFE_INTEGRAL_PROBE_MIXED(safe_div, T0, T1, T2)                      \
+	SAFE_INTEGRAL_PROBE_MIXED(safe_mod, T0, T1, T2)                      \
+	SAFE_INTEGRAL_PROBE_STORE(safe_add, T0, T1, T2)                      \
+	SAFE_INTEGRAL_PROBE_STORE(safe_mult, T0, T1, T2)
+
+SAFE_INTEGRAL_PROBE_MIXED_TYPES(int, int, int)
+SAFE_INTEGRAL_PROBE_MIXED_TYPES(int, int, unsigned)
+SAFE_INTEGRAL_PROBE_MIXED_TYPES(unsigned, llong, unsigned)
+SAFE_INTEGRAL_PROBE_MIXED_TYPES(llong, ullong, llong)
+
+#define SAFE_INTEGRAL_PROBE_MIXED_CONSTANT(name, T0, T1, V)                  \
+	extern "C" T0 probe_##name##_##V##_##T0##_##T1(T1 a);                     \
+	extern "C" T0 probe_##name##_##V##_##T0##_##T1(T1 a) {                    \
+		return safeintegralop::name<T0>(a, std::integral_constant<int, V>{}).value_or(T0{0}); \
+	}
+
+SAFE_INTEGRAL_PROBE_MIXED_CONSTANT(safe_div, int, llong, 1000)
+SAFE_INTEGRAL_PROBE_MIXED_CONSTANT(safe_div, llong, llong, 1000)
+SAFE_INTEGRAL_PROBE_MIXED_CONSTANT(safe_mod, int, llong, 60)
+SAFE_INTEGRAL_PROBE_MIXED_CONSTANT(safe_mod, unsigned, ullong, 60)
+#endif
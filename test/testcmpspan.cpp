@@ -0,0 +1,175 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeintegralop_cmp_span.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+	template <typename T>
+	std::vector<T> boundary_values() {
+		std::vector<T> values;
+		for(int i = -70; i != 70; ++i){
+			if(safeintegralop::in_range<T>(i)){
+				values.push_back(static_cast<T>(i));
+			}
+		}
+		for(int i = 0; i != 3; ++i){
+			values.push_back(static_cast<T>(std::numeric_limits<T>::max() - i));
+			values.push_back(static_cast<T>(std::numeric_limits<T>::min() + i));
+			values.push_back(static_cast<T>(std::numeric_limits<T>::max() / 2 - i));
+		}
+		return values;
+	}
+
+	bool bit(const std::vector<std::uint64_t>& mask, const std::size_t i) {
+		return ((mask[i / 64] >> (i % 64)) & 1u) != 0;
+	}
+
+	// compares all kernels with the scalar functions
+	template <typename T, typename U>
+	void compare_with_scalar() {
+		const auto values = boundary_values<T>();
+		const auto count = values.size();
+		std::vector<std::uint64_t> mask((count + 63) / 64);
+		std::vector<std::uint32_t> selection(count);
+		for(const auto u : boundary_values<U>()){
+			std::vector<std::uint32_t> expected_less, expected_less_eq, expected_great, expected_equal;
+			for(std::size_t i = 0; i != count; ++i){
+				if(safeintegralop::cmp_less(values[i], u)) expected_less.push_back(static_cast<std::uint32_t>(i));
+				if(safeintegralop::cmp_less_eq(values[i], u)) expected_less_eq.push_back(static_cast<std::uint32_t>(i));
+				if(safeintegralop::cmp_great(values[i], u)) expected_great.push_back(static_cast<std::uint32_t>(i));
+				if(safeintegralop::cmp_equal(values[i], u)) expected_equal.push_back(static_cast<std::uint32_t>(i));
+			}
+			// not using REQUIRE for every value, it would make the test much slower
+			if(safeintegralop::cmp_less_count(values.data(), count, u) != expected_less.size() ||
+			   safeintegralop::cmp_less_eq_count(values.data(), count, u) != expected_less_eq.size() ||
+			   safeintegralop::cmp_great_count(values.data(), count, u) != expected_great.size() ||
+			   safeintegralop::cmp_equal_count(values.data(), count, u) != expected_equal.size()){
+				FAIL("count with " << +u);
+			}
+
+			selection.resize(safeintegralop::cmp_less_select(values.data(), count, u, selection.data()));
+			if(selection != expected_less) FAIL("cmp_less_select with " << +u);
+			selection.resize(count);
+			selection.resize(safeintegralop::cmp_less_eq_select(values.data(), count, u, selection.data()));
+			if(selection != expected_less_eq) FAIL("cmp_less_eq_select with " << +u);
+			selection.resize(count);
+			selection.resize(safeintegralop::cmp_great_select(values.data(), count, u, selection.data()));
+			if(selection != expected_great) FAIL("cmp_great_select with " << +u);
+			selection.resize(count);
+			selection.resize(safeintegralop::cmp_equal_select(values.data(), count, u, selection.data()));
+			if(selection != expected_equal) FAIL("cmp_equal_select with " << +u);
+			selection.resize(count);
+
+			safeintegralop::cmp_less_mask(values.data(), count, u, mask.data());
+			for(std::size_t i = 0; i != count; ++i){
+				if(bit(mask, i) != safeintegralop::cmp_less(values[i], u)) FAIL("cmp_less_mask with " << +u);
+			}
+			safeintegralop::cmp_great_mask(values.data(), count, u, mask.data());
+			for(std::size_t i = 0; i != count; ++i){
+				if(bit(mask, i) != safeintegralop::cmp_great(values[i], u)) FAIL("cmp_great_mask with " << +u);
+			}
+			if(count % 64 != 0 && (mask.back() >> (count % 64)) != 0){
+				FAIL("unused bits are not 0");
+			}
+		}
+
+		std::size_t in_range = 0;
+		for(const auto v : values){
+			in_range += safeintegralop::in_range<U>(v);
+		}
+		REQUIRE(safeintegralop::in_range_count<U>(values.data(), count) == in_range);
+		selection.resize(safeintegralop::in_range_select<U>(values.data(), count, selection.data()));
+		REQUIRE(selection.size() == in_range);
+		safeintegralop::in_range_mask<U>(values.data(), count, mask.data());
+		for(std::size_t i = 0; i != count; ++i){
+			if(bit(mask, i) != safeintegralop::in_range<U>(values[i])) FAIL("in_range_mask");
+		}
+	}
+
+	template <typename T>
+	void compare_with_scalar() {
+		compare_with_scalar<T, std::int16_t>();
+		compare_with_scalar<T, std::uint16_t>();
+		compare_with_scalar<T, std::int32_t>();
+		compare_with_scalar<T, std::uint32_t>();
+		compare_with_scalar<T, std::int64_t>();
+		compare_with_scalar<T, std::uint64_t>();
+	}
+}
+
+TEST_CASE("span comparisons, same results of scalar comparisons", "[cmp]") {
+	compare_with_scalar<std::int16_t>();
+	compare_with_scalar<std::uint16_t>();
+	compare_with_scalar<std::int32_t>();
+	compare_with_scalar<std::uint32_t>();
+	compare_with_scalar<std::int64_t>();
+	compare_with_scalar<std::uint64_t>();
+}
+
+TEST_CASE("span comparisons, mixed signs", "[cmp]") {
+	const std::vector<std::int64_t> column = {-1, 0, 1, std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::min()};
+	const auto big = std::uint64_t(std::numeric_limits<std::int64_t>::max()) + 1;
+	REQUIRE(safeintegralop::cmp_less_count(column.data(), column.size(), big) == 5);
+	REQUIRE(safeintegralop::cmp_less_count(column.data(), column.size(), 0u) == 2);
+	REQUIRE(safeintegralop::cmp_great_count(column.data(), column.size(), big) == 0);
+	REQUIRE(safeintegralop::cmp_equal_count(column.data(), column.size(), std::uint64_t(-1)) == 0);
+
+	const std::vector<std::uint64_t> ucolumn = {0, 1, big, std::numeric_limits<std::uint64_t>::max()};
+	REQUIRE(safeintegralop::cmp_less_count(ucolumn.data(), ucolumn.size(), -1) == 0);
+	REQUIRE(safeintegralop::cmp_great_count(ucolumn.data(), ucolumn.size(), -1) == 4);
+	REQUIRE(safeintegralop::in_range_count<std::int64_t>(ucolumn.data(), ucolumn.size()) == 2);
+
+	std::vector<std::size_t> selection(ucolumn.size());
+	selection.resize(safeintegralop::cmp_great_select(ucolumn.data(), ucolumn.size(), std::numeric_limits<std::int64_t>::max(), selection.data()));
+	REQUIRE(selection == std::vector<std::size_t>({2, 3}));
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+
+	std::vector<std::int64_t> make_column() {
+		std::vector<std::int64_t> v(bigvector);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			v[i] = std::int64_t(i * 2654435761u % 2000001) - 1000000;
+		}
+		return v;
+	}
+}
+
+TEST_CASE("filter int64 < uint64 with cmp_less", "[cmp][.]") {
+	const auto column = make_column();
+	std::vector<std::uint32_t> selection(column.size());
+	std::size_t n = 0;
+	for(int r = 0; r != repetitions; ++r){
+		n = 0;
+		for(std::size_t i = 0; i != column.size(); ++i){
+			if(safeintegralop::cmp_less(column[i], std::uint64_t(r))){
+				selection[n++] = static_cast<std::uint32_t>(i);
+			}
+		}
+	}
+	REQUIRE(n == safeintegralop::cmp_less_count(column.data(), column.size(), std::uint64_t(repetitions - 1)));
+}
+
+TEST_CASE("filter int64 < uint64 with cmp_less_select", "[cmp][.]") {
+	const auto column = make_column();
+	std::vector<std::uint32_t> selection(column.size());
+	std::size_t n = 0;
+	for(int r = 0; r != repetitions; ++r){
+		n = safeintegralop::cmp_less_select(column.data(), column.size(), std::uint64_t(r), selection.data());
+	}
+	REQUIRE(n == safeintegralop::cmp_less_count(column.data(), column.size(), std::uint64_t(repetitions - 1)));
+}
+
+TEST_CASE("filter int64 < uint64 with cmp_less_mask", "[cmp][.]") {
+	const auto column = make_column();
+	std::vector<std::uint64_t> mask(column.size() / 64);
+	for(int r = 0; r != repetitions; ++r){
+		safeintegralop::cmp_less_mask(column.data(), column.size(), std::uint64_t(r), mask.data());
+	}
+	REQUIRE((mask[0] & 1u) == 1u);
+}
@@ -0,0 +1,446 @@
+// Compile-time tests, formerly part of the headers.
+// Moved here so that including the library does not pay for them in every translation unit.
+#include "../safeintegral/safeintegral.hpp"
+#include "../safeintegral/safeintegralop.hpp"
+
+#include <cstdint>
+#include <utility>
+
+inline void compile_self_test(){
+	auto one = safe_integral<int>(1);
+	auto two = safe_integral<int>(2);
+	static_assert( noexcept(std::swap(one, two)) , "throwing swap" );
+}
+
+namespace safeintegralop {
+
+	namespace ct {
+
+		// Compile tests for in_range
+		static_assert(in_range<short>(1),   "in range");
+		static_assert(in_range<short>(1u),  "in range");
+		static_assert(in_range<short>(1ul), "in range");
+		static_assert(in_range<short>(-1l), "in range");
+
+
+		static_assert(!in_range<int16_t>(std::numeric_limits<uint16_t>::max()), "in range");
+		static_assert(in_range<int16_t>(std::numeric_limits<uint8_t>::max()), "in range");
+		static_assert(!in_range<uint8_t>(-1), "in range, negative value, unsigned range");
+		static_assert(in_range<int8_t>(-1), "in range, negative value, unsigned range");
+		static_assert(in_range<uint8_t>(std::numeric_limits<uint16_t>::min()), "in range");
+		static_assert(in_range<int8_t>(std::numeric_limits<uint16_t>::min()), "in range");
+		static_assert(!in_range<uint8_t>(std::numeric_limits<int16_t>::min()), "in range");
+		static_assert(!in_range<int8_t>(std::numeric_limits<int16_t>::min()), "in range");
+		static_assert(!in_range<uint16_t>(100000), "value bigger than the unsigned range");
+		static_assert(!in_range<uint32_t>(int64_t{1} << 40), "value bigger than the unsigned range");
+		static_assert(in_range<int32_t>(std::numeric_limits<uint16_t>::max()), "in range");
+
+		// Compile tests for cmp_equal
+		static_assert(cmp_equal(1, 1),    "comparison same signed type, same value");
+		static_assert(cmp_equal(1u, 1u),  "comparison same unsigned type, same value (2)");
+		static_assert(cmp_equal(1ul, 1u), "comparison unsigned types, same value");
+		static_assert(cmp_equal(1u, 1ul), "comparison unsigned types, same value (2)");
+		static_assert(cmp_equal(1l, 1),   "comparison signed types, same value");
+		static_assert(cmp_equal(1, 1l),   "comparison signed types, same value (2)");
+		static_assert(cmp_equal(1ul, 1),  "comparison signed/unsigned types, same value");
+		static_assert(cmp_equal(1, 1ul),  "comparison signed/unsigned types, same value (2)");
+
+
+		static_assert(!cmp_equal(1, 2),    "comparison same signed type, different values");
+		static_assert(!cmp_equal(1, -1),   "comparison same signed type, different values (2)");
+		static_assert(!cmp_equal(1u, 2u),  "comparison same unsigned type, different values");
+		static_assert(!cmp_equal(1ul, 2u), "comparison unsigned types, different values");
+		static_assert(!cmp_equal(2u, 1ul), "comparison unsigned types, different values (2)");
+		static_assert(!cmp_equal(1l, 2),   "comparison signed types, different values");
+		static_assert(!cmp_equal(2, 1l),   "comparison signed types, different values (2)");
+		static_assert(!cmp_equal(2ul, 1),  "comparison signed/unsigned types, different values");
+		static_assert(!cmp_equal(1, 2ul),  "comparison signed/unsigned types, different values (2)");
+
+		static_assert(!cmp_equal(std::numeric_limits<uint8_t>::max(), std::numeric_limits<int8_t>::max()),
+		    "comparison unsigned/signed type");
+		static_assert(!cmp_equal(std::numeric_limits<uint8_t>::max(), -1),
+		    "comparison unsigned/signed type");
+		static_assert(!cmp_equal(std::numeric_limits<int32_t>::max(), std::numeric_limits<uint16_t>::max()),
+		    "comparison signed/unsigned type, wider signed type");
+		static_assert(cmp_less(uint16_t{5}, 65536), "comparison unsigned/signed type, wider signed type");
+		static_assert(!cmp_less(std::numeric_limits<int32_t>::max(), std::numeric_limits<uint16_t>::max()),
+		    "comparison signed/unsigned type, wider signed type");
+
+
+		// Compile tests for cmp_less
+		static_assert(!cmp_less(1, 1),    "comparison same signed type, same value");
+		static_assert(!cmp_less(1u, 1u),  "comparison same unsigned type, same value (2)");
+		static_assert(!cmp_less(1ul, 1u), "comparison unsigned types, same value");
+		static_assert(!cmp_less(1u, 1ul), "comparison unsigned types, same value (2)");
+		static_assert(!cmp_less(1l, 1),   "comparison signed types, same value");
+		static_assert(!cmp_less(1, 1l),   "comparison signed types, same value (2)");
+		static_assert(!cmp_less(1ul, 1),  "comparison signed/unsigned types, same value");
+		static_assert(!cmp_less(1, 1ul),  "comparison signed/unsigned types, same value (2)");
+
+		static_assert(cmp_less(1, 2),    "comparison same signed type, different values");
+		static_assert(!cmp_less(1, -1),  "comparison same signed type, different values (2)");
+		static_assert(cmp_less(1u, 2u),  "comparison same unsigned type, different values");
+		static_assert(cmp_less(1ul, 2u) ,"comparison unsigned types, different values");
+		static_assert(!cmp_less(2u, 1ul),"comparison unsigned types, different values (2)");
+		static_assert(cmp_less(1l, 2),   "comparison signed types, different values");
+		static_assert(!cmp_less(2, 1l),  "comparison signed types, different values (2)");
+		static_assert(cmp_less(1ul, 2),  "comparison signed/unsigned types, different values");
+		static_assert(!cmp_less(2, 1ul), "comparison signed/unsigned types, different values (2)");
+
+		static_assert(!cmp_less(std::numeric_limits<uint8_t>::max(), std::numeric_limits<int8_t>::max()),
+		    "comparison unsigned/signed type");
+		static_assert(!cmp_less(std::numeric_limits<uint8_t>::max(), -1),
+		    "comparison unsigned/signed type");
+	}
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	namespace ct {
+		// constants for testing
+		constexpr std::uint64_t max64u = std::numeric_limits<std::uint64_t>::max();
+		constexpr std::uint64_t min64u = std::numeric_limits<std::uint64_t>::min();
+		constexpr std::uint32_t max32u = std::numeric_limits<std::uint32_t>::max();
+		constexpr std::uint32_t max32u_1 = std::numeric_limits<std::uint32_t>::max()-1;
+		constexpr std::uint32_t min32u = std::numeric_limits<std::uint32_t>::min();
+		constexpr std::uint16_t max16u = std::numeric_limits<std::uint16_t>::max();
+		constexpr std::uint16_t min16u = std::numeric_limits<std::uint16_t>::min();
+		constexpr std::uint8_t max08u = std::numeric_limits<std::uint8_t>::max();
+		constexpr std::uint8_t max08u_1 = std::numeric_limits<std::uint8_t>::max()-1;
+		constexpr std::uint8_t min08u = std::numeric_limits<std::uint8_t>::min();
+
+		constexpr std::int64_t max64s = std::numeric_limits<std::int64_t>::max();
+		constexpr std::int64_t min64s = std::numeric_limits<std::int64_t>::min();
+		constexpr std::int32_t max32s = std::numeric_limits<std::int32_t>::max();
+		constexpr std::int32_t min32s = std::numeric_limits<std::int32_t>::min();
+		constexpr std::int32_t max32s_1 = std::numeric_limits<std::int32_t>::max()-1;
+		constexpr std::int16_t max16s = std::numeric_limits<std::int16_t>::max();
+		constexpr std::int16_t max16s_1 = std::numeric_limits<std::int16_t>::max()-1;
+		constexpr std::int16_t min16s = std::numeric_limits<std::int16_t>::min();
+		constexpr std::int8_t max08s = std::numeric_limits<std::int8_t>::max();
+		constexpr std::int8_t max08s_1 = std::numeric_limits<std::int8_t>::max()-1;
+		constexpr std::int8_t min08s = std::numeric_limits<std::int8_t>::min();
+		constexpr std::int8_t min08s_1 = std::numeric_limits<std::int8_t>::min()+1;
+
+		// safe_add -------
+		static_assert(safe_add<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 2, "dumb test");
+		static_assert(!safe_add<std::uint32_t>(max32u, std::uint32_t(1)), "overflow");
+		static_assert(safe_add<std::uint32_t>(max08u_1, std::uint32_t(1)) == max08u, "exact max");
+		static_assert(safe_add<std::uint64_t>(max32u, max32u)==2*std::uint64_t(max32u), "in range after overflow: max32u+max32u < max64u");
+		static_assert(!safe_add<std::uint32_t>(max32u, max32u), "!in range after overflow: max32u+max32u > max32u");
+
+		static_assert(safe_add<std::int32_t>(1, 1) == 2, "dumb test");
+		static_assert(!safe_add<std::int32_t>(max32s, 1), "overflow");
+		static_assert(safe_add<std::int32_t>(max32s_1, 1) == max32s, "exact max");
+		static_assert(safe_add<std::int32_t>(std::int64_t(max32s)+1, -2) == std::int64_t(max32s)-1, "in range after overflow: (max32s+1)+ (-2) < max32u");
+		static_assert(!safe_add<std::int32_t>(std::int64_t(max32s)+2, -1), "!in range after overflow: (max32s+2) + (-1) > max32s");
+
+		static_assert(safe_add<std::uint32_t>(1, 1) == 2, "dumb test");
+		static_assert(!safe_add<std::uint32_t>(max64s, 1), "overflow");
+		static_assert(safe_add<std::uint32_t>(2*std::int64_t(max32u), -std::int64_t(max32u)) == max32u, "exact max");
+		static_assert(safe_add<std::uint32_t>(std::int64_t(max32u)+1, -2) == std::int64_t(max32u)-1, "in range after overflow");
+		static_assert(safe_add<std::uint32_t>(-1, +2) == 1, "in range after overflow");
+		static_assert(safe_add<std::uint32_t>(max32s, std::int32_t(1)) == std::uint32_t(max32s)+1, "in range after overflow");
+
+		static_assert(safe_add<std::uint32_t>(1, 1u) == 2, "dumb test");
+		static_assert(!safe_add<std::uint32_t>(max64s, 1u), "overflow");
+		static_assert(safe_add<std::uint32_t>(2*std::uint64_t(max32s), -std::int64_t(max32s)) == max32s, "exact max");
+		static_assert(safe_add<std::uint32_t>(std::uint64_t(max32s)+1, -2) == max32s_1, "in range after overflow");
+		static_assert(safe_add<std::uint32_t>(-1, 2u) == 1, "in range after overflow");
+		static_assert(safe_add<std::uint32_t>(min32s, std::uint64_t(std::uint64_t(max32s)+1)) == 0, "");
+
+		// safe_diff
+		static_assert(safe_diff<std::uint32_t>(std::int32_t(1), std::int32_t(1)) == 0, "dumb test");
+		static_assert(safe_diff<std::uint32_t>(std::int32_t(2), std::int32_t(1)) == 1, "dumb test");
+		static_assert(!safe_diff<std::uint32_t>(std::int32_t(0), std::int32_t(1)), "overflow");
+		static_assert(safe_diff<std::int32_t>(std::int32_t(0), std::int32_t(1)) == -1, "dumb test");
+
+		static_assert(!safe_diff<std::int32_t>(std::int32_t(0), min32s), "overflow: 0 - min08s == 128 > max08s");
+		static_assert(safe_diff<std::uint32_t>(std::int32_t(0), min32s) == details::safe_abs(min32s), "in range after overflow: 0 - min08s == 128 < max08u");
+
+
+		static_assert(safe_diff<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 0, "dumb");
+		static_assert(safe_diff<std::uint32_t>(std::uint32_t(2), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_diff<std::uint32_t>(std::uint32_t(0), std::uint32_t(1)), "overflow: 0 - 1 = -1 < 0");
+		static_assert(safe_diff<std::int32_t>(std::uint32_t(0), std::uint32_t(1)) == -1, "no overflow");
+		static_assert(safe_diff<std::int32_t>(std::uint32_t(1), std::uint32_t(2)) == -1, "no overflow");
+
+
+		static_assert(safe_diff<std::uint32_t>(std::int32_t(2), std::uint32_t(1)) == 1, "dumb test");
+		static_assert(safe_diff<std::int32_t>(std::int32_t(2), std::uint32_t(1)) == 1, "dumb test");
+		static_assert(!safe_diff<std::uint32_t>(std::int32_t(0), std::uint32_t(1)), "overflow");
+		static_assert(safe_diff<std::int32_t>(std::int32_t(0), std::uint32_t(1)) == -1, "dumb test");
+
+		static_assert(!safe_diff<std::uint32_t>(std::int32_t(-2), std::uint32_t(1)), "dumb test");
+		static_assert(safe_diff<std::int32_t>(std::int32_t(-1), std::uint32_t(1)) == -2, "dumb test");
+		static_assert(!safe_diff<std::int32_t>(max64s, 0), "dumb test");
+
+		static_assert(safe_diff<std::uint32_t>(std::uint32_t(1), std::int32_t(1)) == 0, "dumb test");
+		static_assert(!safe_diff<std::uint32_t>(std::uint32_t(1), std::int32_t(2)), "dumb test");
+		static_assert(safe_diff<std::uint32_t>(std::uint32_t(1), std::int32_t(-1)) == 2, "dumb test");
+		static_assert(safe_diff<std::uint32_t>(std::uint32_t(2), std::int32_t(-1)) == 3, "dumb test");
+		static_assert(safe_diff<std::int32_t>(std::uint32_t(1), std::int32_t(-1)) == 2, "dumb test");
+		static_assert(safe_diff<std::int32_t>(std::uint32_t(2), std::int32_t(-1)) == 3, "dumb test");
+		static_assert(!safe_diff<std::int32_t>(max32u, std::int32_t(-1)), "dumb test");
+		static_assert(safe_diff<std::uint32_t>(max32u_1, std::int32_t(-1)) == max32u, "dumb test");
+		static_assert(!safe_diff<std::int32_t>(max64u, 0), "dumb test");
+
+		// safe_mult
+		static_assert(safe_mult<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(safe_mult<std::uint32_t>(max32u, std::uint32_t(0)) == 0, "dumb");
+		static_assert(safe_mult<std::uint32_t>(max32u, std::uint32_t(1)) == max32u, "dumb");
+		static_assert(!safe_mult<std::uint32_t>(max32u, std::uint32_t(2)), "dumb");
+
+		static_assert(safe_mult<std::int32_t>(std::int32_t(1), std::int32_t(1)) == 1, "dumb");
+		static_assert(safe_mult<std::int32_t>(max64s, std::int32_t(0)) == 0, "dumb");
+		static_assert(safe_mult<std::int32_t>(max32s, std::int32_t(1)) == max32s, "dumb");
+		static_assert(!safe_mult<std::int32_t>(max32s, std::int32_t(2)), "dumb");
+
+		static_assert(safe_mult<std::int32_t>(std::int32_t(-1), std::int32_t(1)) == -1, "dumb");
+		static_assert(safe_mult<std::int32_t>(max64s, std::int32_t(0)) == 0, "dumb");
+		static_assert(!safe_mult<std::int32_t>(min32s, std::int32_t(-1)), "dumb");
+		static_assert(safe_mult<std::int32_t>(max32s, std::int32_t(-1)) == -max32s, "dumb");
+		static_assert(!safe_mult<std::int32_t>(max32s, std::int32_t(-2)), "dumb");
+		static_assert(safe_mult<std::int64_t>(max32s, max32s) == max32s * std::int64_t(max32s), "in range after overflow");
+		static_assert(safe_mult<std::int64_t>(min32s, max32s) == min32s * std::int64_t(max32s), "in range after overflow");
+
+		static_assert(!safe_mult<std::uint32_t>(std::int32_t(-1), std::int32_t(1)), "dumb");
+		static_assert(safe_mult<std::uint32_t>(max64s, std::int32_t(0)) == 0, "dumb");
+		static_assert(safe_mult<std::uint32_t>(min32s, std::int32_t(-1)) == details::safe_abs(min32s), "dumb");
+		static_assert(safe_mult<std::uint32_t>(min32s, std::int32_t(0)) == 0, "dumb");
+		static_assert(!safe_mult<std::uint32_t>(max32s, std::int32_t(-1)), "dumb");
+		static_assert(safe_mult<std::uint32_t>(max32s, std::int32_t(2)) == 2*std::uint32_t(max32s), "dumb");
+
+		static_assert(safe_mult<std::int32_t>(std::int32_t(-1), std::uint32_t(1)) == -1, "dumb");
+		static_assert(safe_mult<std::int32_t>(max64s, std::int32_t(0)) == 0, "dumb");
+		static_assert(!safe_mult<std::int32_t>(std::int32_t(-1), max64s), "dumb");
+		static_assert(safe_mult<std::int32_t>(std::int32_t(-1), max32s) == -max32s, "dumb");
+		static_assert(!safe_mult<std::int32_t>(std::uint32_t(-2), max32s), "dumb");
+
+		static_assert(!safe_mult<std::uint32_t>(std::int32_t(-1), std::uint32_t(1)), "dumb");
+		static_assert(safe_mult<std::uint32_t>(max32s, std::uint32_t(0)) == 0, "dumb");
+		static_assert(safe_mult<std::uint32_t>(min32s, std::uint32_t(0)) == 0, "dumb");
+		static_assert(!safe_mult<std::uint32_t>(std::int32_t(-1), max32s), "dumb");
+		static_assert(safe_mult<std::uint32_t>(max32s, std::uint32_t(2)) == 2*std::uint32_t(max32s), "dumb");
+
+
+		// safe_div
+		static_assert(safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
+		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(1))==max32u, "dumb");
+		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(2))==max32u/2, "dumb");
+		static_assert(!safe_div<std::uint32_t>(max64u, std::uint32_t(2)), "dumb");
+		static_assert(safe_div<std::uint32_t>(max64u, max64u)==1, "dumb");
+
+		static_assert(safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
+		static_assert(safe_div<std::int32_t>(std::uint32_t(max32s), std::uint32_t(1)) == max32s, "dumb");
+		static_assert(safe_div<std::int32_t>(std::uint32_t(max32s), std::uint32_t(2)) == max32s/2, "dumb");
+		static_assert(!safe_div<std::int32_t>(max64u, std::uint32_t(2)), "dumb");
+		static_assert(safe_div<std::int32_t>(max64u, max64u)==1, "dumb");
+
+		static_assert(safe_div<std::int32_t>(std::int32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_div<std::int32_t>(std::int32_t(1), std::uint32_t(0)), "dumb");
+		static_assert(safe_div<std::int32_t>(max32s, std::uint32_t(1)) == max32s, "dumb");
+		static_assert(safe_div<std::int32_t>(max32s, std::uint32_t(2)) == max32s/2, "dumb");
+		static_assert(!safe_div<std::int32_t>(max64u, std::uint32_t(2)), "dumb");
+		static_assert(safe_div<std::int32_t>(max64s, std::uint64_t(max64s)) == 1, "dumb");
+
+		static_assert(safe_div<std::uint32_t>(std::int32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_div<std::uint32_t>(std::int32_t(1), std::uint32_t(0)), "dumb");
+		static_assert(safe_div<std::uint32_t>(max32s, std::uint32_t(1)) == max32s, "dumb");
+		static_assert(safe_div<std::uint32_t>(max32s, std::uint32_t(2)) == max32s/2, "dumb");
+		static_assert(!safe_div<std::uint32_t>(max64u, std::uint32_t(2)), "dumb");
+		static_assert(safe_div<std::uint32_t>(max64s, std::uint64_t(max64s)) == 1, "dumb");
+
+		static_assert(safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_div<std::int32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
+		static_assert(!safe_div<std::int32_t>(max32u, std::uint32_t(1)), "dumb");
+		static_assert(safe_div<std::int32_t>(max32u, std::uint32_t(2)) == max32u/2, "dumb");
+		static_assert(!safe_div<std::int32_t>(max64u, std::uint32_t(2)), "dumb");
+		static_assert(safe_div<std::int32_t>(max64u, std::uint64_t(max64s)) == max64u/std::uint64_t(max64s), "dumb");
+
+		static_assert(safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(1)) == 1, "dumb");
+		static_assert(!safe_div<std::uint32_t>(std::uint32_t(1), std::uint32_t(0)), "dumb");
+		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(1)) == max32u, "dumb");
+		static_assert(safe_div<std::uint32_t>(max32u, std::uint32_t(2)) == max32u/2, "dumb");
+		static_assert(!safe_div<std::uint32_t>(max64u, std::uint32_t(2)), "dumb");
+		static_assert(safe_div<std::uint32_t>(max64u, std::uint64_t(max64s)) == max64u/std::uint64_t(max64s), "dumb");
+
+		static_assert(safe_div<std::int32_t>(-6, 3) == -2, "negative result");
+		static_assert(safe_div<std::int32_t>(6, -3) == -2, "negative result");
+		static_assert(safe_div<std::int32_t>(min32s, 1) == min32s, "exact min");
+		static_assert(safe_div<std::int32_t>(std::int64_t(min32s)*2, 2) == min32s, "exact min");
+		static_assert(!safe_div<std::int32_t>(std::int64_t(min32s)*2, 1), "overflow");
+
+		// safe_mod
+		static_assert(safe_mod<std::int32_t>(7, 3) == 1, "dumb");
+		static_assert(safe_mod<std::int32_t>(-7, 3) == -1, "sign of the dividend");
+		static_assert(safe_mod<std::int32_t>(7, -3) == 1, "sign of the dividend");
+		static_assert(!safe_mod<std::int32_t>(7, 0), "division by 0");
+		static_assert(safe_mod<std::int32_t>(min32s, -1) == 0, "min%-1");
+		static_assert(safe_mod<std::int64_t>(min64s, max64u) == min64s, "|a| < |b|");
+		static_assert(!safe_mod<std::uint32_t>(-7, 3), "negative result");
+		static_assert(safe_mod<std::uint8_t>(max64u, std::uint64_t(256)) == max08u, "in range after reduction");
+		static_assert(!safe_mod<std::int8_t>(std::int32_t(-200), std::uint32_t(300)), "overflow");
+		static_assert(safe_mod<std::int8_t>(min32s, std::uint32_t(max32s)) == -1, "in range after reduction");
+		static_assert(safe_mod<std::int8_t>(std::int32_t(-128), std::uint32_t(300)) == min08s, "exact min");
+		static_assert(!safe_mod<std::int8_t>(std::int32_t(-129), std::uint32_t(300)), "overflow");
+
+		// safe_neg
+		static_assert(safe_neg<std::int32_t>(1) == -1, "dumb");
+		static_assert(safe_neg<std::int32_t>(0) == 0, "dumb");
+		static_assert(!safe_neg<std::int32_t>(min32s), "overflow");
+		static_assert(safe_neg<std::int64_t>(min32s) == -std::int64_t(min32s), "in range after overflow");
+		static_assert(safe_neg<std::uint32_t>(min32s) == details::safe_abs(min32s), "in range after overflow");
+		static_assert(!safe_neg<std::uint32_t>(1u), "negative result");
+		static_assert(safe_neg<std::int32_t>(std::uint32_t(max32s)+1) == min32s, "exact min");
+		static_assert(!safe_neg<std::int32_t>(std::uint32_t(max32s)+2), "overflow");
+		static_assert(!safe_neg<std::int64_t>(max64u), "overflow");
+
+		// safe_abs
+		static_assert(safe_abs<std::int32_t>(-1) == 1, "dumb");
+		static_assert(!safe_abs<std::int32_t>(min32s), "overflow");
+		static_assert(safe_abs<std::uint32_t>(min32s) == details::safe_abs(min32s), "in range after overflow");
+		static_assert(safe_abs<std::uint8_t>(min08s) == 128, "in range after overflow");
+		static_assert(!safe_abs<std::int8_t>(max08u), "overflow");
+
+		// safe_cast
+		static_assert(safe_cast<std::int8_t>(max08s) == max08s, "dumb");
+		static_assert(!safe_cast<std::int8_t>(max08u), "overflow");
+		static_assert(!safe_cast<std::uint32_t>(-1), "negative");
+		static_assert(safe_cast<std::uint64_t>(max32s) == std::uint64_t(max32s), "dumb");
+
+		// safe_shl
+		static_assert(safe_shl<std::int32_t>(1, 4) == 16, "dumb");
+		static_assert(safe_shl<std::int32_t>(-1, 4) == -16, "negative value");
+		static_assert(safe_shl<std::int32_t>(1, 30) == std::int32_t(1) << 30, "exact max power");
+		static_assert(!safe_shl<std::int32_t>(1, 31), "overflow");
+		static_assert(safe_shl<std::int32_t>(-1, 31) == min32s, "exact min");
+		static_assert(safe_shl<std::uint32_t>(1, 31) == std::uint32_t(1) << 31, "in range");
+		static_assert(safe_shl<std::int64_t>(1, 31) == std::int64_t(1) << 31, "in range after overflow");
+		static_assert(!safe_shl<std::int32_t>(1, -1), "negative shift");
+		static_assert(safe_shl<std::int32_t>(0, 200) == 0, "big shift of 0");
+		static_assert(!safe_shl<std::int64_t>(1, 200), "big shift");
+		static_assert(safe_shl<std::int8_t>(std::uint64_t(3), 5) == 96, "dumb");
+		static_assert(!safe_shl<std::int8_t>(std::uint64_t(3), 6), "overflow");
+
+		// safe_shr
+		static_assert(safe_shr<std::int32_t>(16, 4) == 1, "dumb");
+		static_assert(safe_shr<std::int32_t>(-16, 4) == -1, "negative value");
+		static_assert(safe_shr<std::int32_t>(-17, 4) == -2, "rounded towards -inf");
+		static_assert(safe_shr<std::int32_t>(-1, 200) == -1, "big shift of a negative value");
+		static_assert(safe_shr<std::int32_t>(1, 200) == 0, "big shift");
+		static_assert(!safe_shr<std::int32_t>(1, -1), "negative shift");
+		static_assert(!safe_shr<std::uint32_t>(-1, 1), "negative result");
+		static_assert(safe_shr<std::int8_t>(max64u, 57) == max08s, "in range after shift");
+		static_assert(!safe_shr<std::int8_t>(max64u, 56), "overflow");
+		static_assert(safe_shr<std::int8_t>(min64s, 56) == min08s, "exact min");
+
+		// safe_div and safe_mod with a constant divisor
+		using c1000 = std::integral_constant<int, 1000>;
+		using cm1 = std::integral_constant<int, -1>;
+		static_assert(details::is_always_safe_div<std::int32_t, std::int32_t, int, 1000>(), "no runtime check");
+		static_assert(!details::is_always_safe_div<std::int32_t, std::int32_t, int, -1>(), "min/-1");
+		static_assert(details::is_always_safe_div<std::int16_t, std::int32_t, int, 1 << 16>(), "in range after division");
+		static_assert(!details::is_always_safe_div<std::uint32_t, std::int32_t, int, 1000>(), "negative values");
+		static_assert(details::is_always_safe_mod<std::int16_t, std::int64_t, int, 1000>(), "no runtime check");
+		static_assert(!details::is_always_safe_mod<std::uint16_t, std::int64_t, int, 1000>(), "negative values");
+		static_assert(details::is_always_safe_mod<std::uint16_t, std::uint64_t, int, -1000>(), "sign of the dividend");
+		static_assert(safe_div<std::int32_t>(5999, c1000{}) == 5, "dumb");
+		static_assert(safe_div<std::int32_t>(-5999, c1000{}) == -5, "truncation");
+		static_assert(safe_div<std::int8_t>(max32s, std::integral_constant<std::uint32_t, 1u << 24>{}) == max08s, "in range after division");
+		static_assert(safe_div<std::int32_t>(max32s, cm1{}) == -max32s, "dumb");
+		static_assert(!safe_div<std::int32_t>(min32s, cm1{}), "overflow");
+		static_assert(safe_div<std::int64_t>(min32s, cm1{}) == -std::int64_t(min32s), "in range after overflow");
+		static_assert(safe_div<std::int32_t>(max64u, std::integral_constant<std::uint64_t, max64u>{}) == 1, "dumb");
+		static_assert(safe_mod<std::int32_t>(5999, c1000{}) == 999, "dumb");
+		static_assert(safe_mod<std::int32_t>(-5999, c1000{}) == -999, "sign of the dividend");
+		static_assert(safe_mod<std::int32_t>(min32s, cm1{}) == 0, "min%-1");
+		static_assert(!safe_mod<std::uint32_t>(-5999, c1000{}), "negative result");
+		static_assert(safe_mod<std::int8_t>(min64s, std::integral_constant<int, 128>{}) == 0, "dumb");
+		static_assert(safe_mod<std::int8_t>(max64s, std::integral_constant<int, 128>{}) == max08s, "exact max");
+
+		// predicates with a constant second operand
+		static_assert(is_safe_div(min32s, c1000{}), "dumb");
+		static_assert(!is_safe_div(min32s, cm1{}), "overflow");
+		static_assert(!is_safe_div(1, std::integral_constant<int, 0>{}), "division by 0");
+		static_assert(!is_safe_mod(min32s, cm1{}), "overflow");
+		static_assert(is_safe_leftshift(1, std::integral_constant<int, 30>{}), "dumb");
+		static_assert(!is_safe_leftshift(2, std::integral_constant<int, 30>{}), "overflow");
+		static_assert(!is_safe_leftshift(-1, std::integral_constant<int, 1>{}), "negative value");
+		static_assert(!is_safe_leftshift(1, std::integral_constant<int, 31>{}), "invalid shift count");
+		static_assert(is_safe_leftshift(1u, std::integral_constant<unsigned, 31>{}), "dumb");
+		static_assert(is_safe_rightshift(1, std::integral_constant<int, 31>{}), "dumb");
+		static_assert(!is_safe_rightshift(1, std::integral_constant<int, 32>{}), "invalid shift count");
+		static_assert(!is_safe_rightshift(-1, std::integral_constant<int, 1>{}), "negative value");
+
+		// safe_pow
+		static_assert(details::pow_table<std::int32_t>::table.positive[2] == 46340, "floor(sqrt(max))");
+		static_assert(details::pow_table<std::int32_t>::table.negative[31] == 2, "(-2)^31 == min");
+		static_assert(details::pow_table<std::uint64_t>::table.positive[2] == max32u, "floor(sqrt(max))");
+		static_assert(safe_pow<std::int32_t>(2, 30) == std::int32_t(1) << 30, "exact max power");
+		static_assert(!safe_pow<std::int32_t>(2, 31), "overflow");
+		static_assert(safe_pow<std::int32_t>(-2, 31) == min32s, "exact min");
+		static_assert(safe_pow<std::int64_t>(2, 31) == std::int64_t(1) << 31, "in range after overflow");
+		static_assert(safe_pow<std::int32_t>(-3, 3) == -27, "negative result");
+		static_assert(safe_pow<std::int32_t>(-3, 4) == 81, "positive result");
+		static_assert(safe_pow<std::int32_t>(0, 0) == 1, "0^0");
+		static_assert(safe_pow<std::int32_t>(0, 200) == 0, "big exponent");
+		static_assert(safe_pow<std::int32_t>(-1, 201) == -1, "big exponent");
+		static_assert(!safe_pow<std::int32_t>(2, -1), "negative exponent");
+		static_assert(!safe_pow<std::uint32_t>(-1, 3), "negative result");
+		static_assert(safe_pow<std::uint32_t>(-2, 4) == 16, "positive result");
+		static_assert(safe_pow<std::uint64_t>(3, 40) == 12157665459056928801ull, "exact max power");
+		static_assert(!safe_pow<std::uint64_t>(3, 41), "overflow");
+		static_assert(safe_pow<std::int8_t>(max64u, 0) == 1, "x^0");
+		static_assert(!safe_pow<std::int8_t>(max64u, 1), "overflow");
+		static_assert(safe_pow<std::int64_t>(std::int16_t(-300), std::integral_constant<int, 3>{}) == -27000000, "dumb");
+		static_assert(!safe_pow<std::int32_t>(2, std::integral_constant<int, 31>{}), "overflow");
+		static_assert(safe_pow<std::int32_t>(-2, std::integral_constant<int, 31>{}) == min32s, "exact min");
+		static_assert(safe_pow<std::int32_t>(-1, std::integral_constant<int, 1001>{}) == -1, "big exponent");
+		static_assert(!safe_pow<std::int32_t>(2, std::integral_constant<int, 1001>{}), "big exponent");
+		static_assert(safe_pow<std::int32_t>(5, std::integral_constant<int, 0>{}) == 1, "x^0");
+
+		// safe_gcd, safe_lcm, safe_midpoint, safe_isqrt
+		static_assert(safe_gcd<std::int32_t>(12, 18) == 6, "dumb test");
+		static_assert(safe_gcd<std::int32_t>(-12, 18u) == 6, "mixed signs");
+		static_assert(safe_gcd<std::int32_t>(0, 0) == 0, "gcd(0,0)");
+		static_assert(!safe_gcd<std::int32_t>(min32s, 0), "|min| not representable");
+		static_assert(safe_gcd<std::uint32_t>(min32s, 0) == std::uint32_t(1) << 31, "|min| in unsigned type");
+		static_assert(safe_gcd<std::int8_t>(max64u, max64u - 1) == 1, "consecutive numbers");
+		static_assert(safe_lcm<std::int32_t>(4, -6) == 12, "dumb test");
+		static_assert(safe_lcm<std::int32_t>(0, max32s) == 0, "lcm(0,x)");
+		static_assert(!safe_lcm<std::int32_t>(max32s, max32s_1), "overflow");
+		static_assert(safe_lcm<std::int64_t>(max32s, max32s_1) == std::int64_t(max32s) * max32s_1, "in range after overflow");
+		static_assert(safe_midpoint<std::int32_t>(max32s, max32s_1) == max32s, "rounded towards a");
+		static_assert(safe_midpoint<std::int32_t>(max32s_1, max32s) == max32s_1, "rounded towards a");
+		static_assert(safe_midpoint<std::int32_t>(min32s, max32s) == -1, "rounded towards a");
+		static_assert(safe_midpoint<std::int32_t>(max32s, min32s) == 0, "rounded towards a");
+		static_assert(safe_midpoint<std::int64_t>(min64s, max64u) == max64s / 2, "mixed types");
+		static_assert(safe_midpoint<std::int8_t>(min64s, max64s) == -1, "in range after overflow");
+		static_assert(!safe_midpoint<std::int8_t>(max64u, max64u), "not representable");
+		static_assert(safe_isqrt<std::uint32_t>(max64u) == max32u, "exact max");
+		static_assert(safe_isqrt<std::int32_t>(99) == 9, "rounded down");
+		static_assert(safe_isqrt<std::int32_t>(100) == 10, "exact");
+		static_assert(!safe_isqrt<std::int32_t>(-1), "negative value");
+		static_assert(!safe_isqrt<std::int8_t>(max32s), "not representable");
+
+		// safe_factorial, safe_binomial
+		static_assert(safe_factorial<std::int32_t>(0) == 1, "0!");
+		static_assert(safe_factorial<std::int32_t>(12) == 479001600, "exact max");
+		static_assert(!safe_factorial<std::int32_t>(13), "overflow");
+		static_assert(safe_factorial<std::uint64_t>(20) == 2432902008176640000ull, "exact max");
+		static_assert(!safe_factorial<std::uint64_t>(21), "overflow");
+		static_assert(!safe_factorial<std::int8_t>(-1), "negative value");
+		static_assert(safe_binomial<std::int32_t>(5, 2) == 10, "dumb test");
+		static_assert(safe_binomial<std::int32_t>(5, 6) == 0, "k > n");
+		static_assert(safe_binomial<std::int32_t>(5, -1) == 0, "k < 0");
+		static_assert(!safe_binomial<std::int32_t>(-5, 2), "n < 0");
+		static_assert(safe_binomial<std::uint64_t>(67, 33) == 14226520737620288370ull, "last row of the table");
+		static_assert(!safe_binomial<std::int64_t>(67, 33), "overflow");
+		static_assert(safe_binomial<std::int64_t>(max32s, 2) == std::int64_t(max32s) * (max32s - 1) / 2, "beyond the table");
+		static_assert(safe_binomial<std::int8_t>(max64u, 0) == 1, "C(n, 0)");
+		static_assert(!safe_binomial<std::int8_t>(max64u, 1), "overflow");
+	}
+#endif
+
+}
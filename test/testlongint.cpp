@@ -144,6 +144,13 @@ TEST_CASE( "arithmetic op* (negative)", "[negative]" ) {
 	REQUIRE_THROWS_AS(s*3l, std::out_of_range);
 
 	REQUIRE_NOTHROW(make_safe(std::numeric_limits<long int>::max())*1l);
+
+	// negative factors
+	REQUIRE(make_safe(-2l)*-3l == 6l);
+	REQUIRE_NOTHROW(make_safe(-2l)*(std::numeric_limits<long int>::min()/2+1));
+	REQUIRE_THROWS_AS(make_safe(-2l)*(std::numeric_limits<long int>::min()/2), std::out_of_range);
+	REQUIRE(make_safe(std::numeric_limits<long int>::max()/2+1)*-2l == std::numeric_limits<long int>::min());
+	REQUIRE_THROWS_AS(make_safe(std::numeric_limits<long int>::max()/2+2)*-2l, std::out_of_range);
 }
 
 TEST_CASE( "arithmetic op/", "[positive]" ) {
@@ -286,6 +293,25 @@ TEST_CASE("bitwise op<< (negative) 2", "[negative]") {
 	REQUIRE_THROWS_AS(s << 63l, std::out_of_range);
 }
 
+TEST_CASE( "bitwise op<<=", "[positive]" ) {
+	auto i = 3l;
+	auto s = make_safe(i);
+	s<<=2l;
+	i<<=2l;
+	REQUIRE(getvalue(s) == i);
+	auto ss = safe_short(3);
+	ss <<= safe_short(4);
+	REQUIRE(ss == 48);
+}
+
+TEST_CASE( "bitwise op<<= (negative)", "[negative]" ) {
+	auto s = make_safe<int64_t>(1);
+	REQUIRE_THROWS_AS(s<<=63l, std::out_of_range);
+	REQUIRE(getvalue(s) == 1);
+	s = -2l;
+	REQUIRE_THROWS_AS(s<<=2l, std::out_of_range);
+}
+
 TEST_CASE( "bitwise op>>", "[positive]" ) {
 	auto i = 2l;
 	auto s = make_safe(i);
@@ -303,3 +329,35 @@ TEST_CASE( "bitwise op>> (negative) 2", "[negative]" ) {
 	auto s = make_safe(i);
 	REQUIRE_THROWS_AS(s>>-2l, std::out_of_range);
 }
+
+TEST_CASE( "arithmetic operators with unsigned types", "[positive][negative]" ) {
+	auto s = make_safe(std::numeric_limits<unsigned long>::max()/2);
+	REQUIRE(getvalue(s*2ul) == std::numeric_limits<unsigned long>::max()-1);
+	REQUIRE_THROWS_AS(s*3ul, std::out_of_range);
+	REQUIRE(getvalue(s/2ul) == std::numeric_limits<unsigned long>::max()/4);
+	REQUIRE_THROWS_AS(s/0ul, std::out_of_range);
+	REQUIRE(getvalue(s%2ul) == 1ul);
+	REQUIRE(getvalue(-make_safe(0ul)) == 0ul);
+	REQUIRE_THROWS_AS(-s, std::out_of_range);
+}
+
+TEST_CASE( "arithmetic operators with constant operand", "[positive][negative]" ) {
+	using minus_one = std::integral_constant<int, -1>;
+	using one = std::integral_constant<int, 1>;
+	using sixty_two = std::integral_constant<int, 62>;
+	const auto min = make_safe(std::numeric_limits<int64_t>::min());
+	auto s = make_safe<int64_t>(3600);
+	REQUIRE(getvalue(s/std::integral_constant<int, 60>{}) == 60);
+	REQUIRE(getvalue(s%std::integral_constant<int, 7>{}) == 3600%7);
+	REQUIRE(getvalue(s<<std::integral_constant<int, 2>{}) == 3600*4);
+	REQUIRE(getvalue(s>>std::integral_constant<int, 2>{}) == 3600/4);
+	REQUIRE(getvalue(s/std::integral_constant<int, -1>{}) == -3600);
+	REQUIRE_THROWS_AS(min/minus_one{}, std::out_of_range);
+	REQUIRE_THROWS_AS(min%minus_one{}, std::out_of_range);
+	REQUIRE_THROWS_AS(s<<sixty_two{}, std::out_of_range);
+	REQUIRE_THROWS_AS(-s<<one{}, std::out_of_range);
+	REQUIRE_THROWS_AS(-s>>one{}, std::out_of_range);
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	REQUIRE(getvalue(s/safe_constant<1000>) == 3);
+#endif
+}
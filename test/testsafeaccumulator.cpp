@@ -0,0 +1,206 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeaccumulator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+	// doubles the sum of a with merge, until it is not valid any more, returns the number of merges
+	template <typename T>
+	int merges_until_invalid(safe_accumulator<T>& a) {
+		int n = 0;
+		while(a.is_valid()){
+			a.merge(a);
+			++n;
+		}
+		return n;
+	}
+}
+
+TEST_CASE("safe_accumulator sum", "[accumulator]") {
+	safe_accumulator<std::int32_t> a;
+	REQUIRE(a.value() == 0);
+	for(int i = 0; i != 1000; ++i){
+		a += std::numeric_limits<std::int32_t>::max();
+	}
+	// the intermediate sums do not fit in 32 bits
+	REQUIRE(!a.is_valid());
+	REQUIRE_THROWS_AS(a.value(), std::out_of_range);
+	for(int i = 0; i != 1000; ++i){
+		a += safe_integral<std::int32_t>(std::numeric_limits<std::int32_t>::min());
+	}
+	REQUIRE(a.value() == -1000);
+
+	safe_accumulator<std::uint8_t> u(250);
+	u += 5;
+	REQUIRE(u.value() == 255);
+	u += 1;
+	REQUIRE_THROWS_AS(u.value(), std::out_of_range);
+
+	safe_accumulator<std::int8_t> s(-128);
+	REQUIRE(s.value() == -128);
+	s += -1;
+	REQUIRE(!s.is_valid());
+}
+
+TEST_CASE("safe_accumulator of 64 bits", "[accumulator]") {
+	const auto max = std::numeric_limits<std::int64_t>::max();
+	const auto min = std::numeric_limits<std::int64_t>::min();
+	safe_accumulator<std::int64_t> a(max);
+	a += max;
+	a += max;
+	REQUIRE(!a.is_valid());
+	a += min;
+	a += min;
+	REQUIRE(a.value() == max - 2);
+	a += 2;
+	REQUIRE(a.value() == max);
+	a += min;
+	a += min;
+	a += min;
+	REQUIRE(!a.is_valid());
+	a += max;
+	REQUIRE(!a.is_valid());
+	a += 2;
+	REQUIRE(a.value() == min);
+	a += 1ll;
+	REQUIRE(a.value() == min + 1);
+
+	safe_accumulator<std::uint64_t> u(std::numeric_limits<std::uint64_t>::max());
+	REQUIRE(u.value() == std::numeric_limits<std::uint64_t>::max());
+	u += 1u;
+	REQUIRE(!u.is_valid());
+	u.merge(safe_accumulator<std::uint64_t>(std::numeric_limits<std::uint64_t>::max()));
+	REQUIRE(!u.is_valid());
+
+	safe_accumulator<std::uint64_t> v;
+	v.merge(u);
+	REQUIRE(!v.is_valid());
+}
+
+TEST_CASE("safe_accumulator internal overflow", "[accumulator]") {
+	// the internal sum becomes invalid after 2^62, also if the following values would bring it back in range
+	safe_accumulator<std::int32_t> a(std::numeric_limits<std::int32_t>::max());
+	REQUIRE(merges_until_invalid(a) == 1);
+	a.merge(a);
+	REQUIRE(!a.is_valid());
+	safe_accumulator<std::int32_t> b(1);
+	for(int i = 0; i != 61; ++i){
+		b.merge(b);
+	}
+	safe_accumulator<std::int32_t> c(-1);
+	for(int i = 0; i != 61; ++i){
+		c.merge(c);
+	}
+	b.merge(c);
+	REQUIRE(b.value() == 0);
+	b.merge(b);
+	REQUIRE(b.value() == 0);
+
+	safe_accumulator<std::int32_t> d(1);
+	for(int i = 0; i != 62; ++i){
+		d.merge(d);
+	}
+	safe_accumulator<std::int32_t> e(-1);
+	for(int i = 0; i != 62; ++i){
+		e.merge(e);
+	}
+	// -2^62 is inside the internal range, 2^62 is not
+	d.merge(e);
+	REQUIRE(!d.is_valid());
+	e += 1;
+	e.merge(safe_accumulator<std::int32_t>(-1));
+	REQUIRE(!e.is_valid());
+
+	safe_accumulator<std::int64_t> f(1);
+	for(int i = 0; i != 125; ++i){
+		f.merge(f);
+	}
+	REQUIRE(!f.is_valid());
+	f.merge(safe_accumulator<std::int64_t>(-1));
+	REQUIRE(!f.is_valid());
+}
+
+TEST_CASE("safe_accumulator merge of threads", "[accumulator]") {
+	const std::size_t threads = 4;
+	const int values = 100000;
+	std::vector<safe_accumulator<std::int32_t>> partial(threads);
+	std::vector<std::thread> workers;
+	for(std::size_t t = 0; t != threads; ++t){
+		workers.emplace_back([&partial, t, values]{
+			for(int i = 0; i != values; ++i){
+				partial[t] += (i % 2 == 0) ? std::numeric_limits<std::int32_t>::max() : -std::numeric_limits<std::int32_t>::max() + 1;
+			}
+		});
+	}
+	for(auto& w : workers){
+		w.join();
+	}
+	safe_accumulator<std::int32_t> total;
+	for(const auto& p : partial){
+		total.merge(p);
+	}
+	REQUIRE(total.value() == int(threads) * values / 2);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t events = 1 << 16;
+	const auto repetitions = 2000;
+
+	std::vector<std::int32_t> make_events() {
+		std::vector<std::int32_t> v(events);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			v[i] = std::int32_t(i % 1000) - 400;
+		}
+		return v;
+	}
+}
+
+TEST_CASE("counter of events with safe_integral", "[accumulator][.]") {
+	const auto v = make_events();
+	safe_integral<std::int64_t> acc(0);
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto e : v){
+			acc += e;
+		}
+	}
+	REQUIRE(acc.getvalue() > 0);
+}
+
+TEST_CASE("counter of events with safe_accumulator", "[accumulator][.]") {
+	const auto v = make_events();
+	safe_accumulator<std::int64_t> acc;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto e : v){
+			acc += e;
+		}
+	}
+	REQUIRE(acc.value() > 0);
+}
+
+TEST_CASE("counter of events with safe_accumulator of 32 bits", "[accumulator][.]") {
+	const auto v = make_events();
+	safe_accumulator<std::int32_t> acc;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto e : v){
+			acc += e;
+		}
+	}
+	REQUIRE(!acc.is_valid());
+}
+
+TEST_CASE("counter of events without checks", "[accumulator][.]") {
+	const auto v = make_events();
+	std::int64_t acc = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto e : v){
+			acc += e;
+		}
+	}
+	REQUIRE(acc > 0);
+}
@@ -0,0 +1,130 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeintegral.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+namespace {
+	// rows of Pascal's triangle with a check for every sum, empty if the value does not fit in a std::uint64_t
+	std::vector<std::vector<std::optional<std::uint64_t>>> make_pascal(const int rows) {
+		std::vector<std::vector<std::optional<std::uint64_t>>> pascal(rows);
+		for(int n = 0; n != rows; ++n){
+			pascal[n].resize(n + 1);
+			pascal[n][0] = pascal[n][n] = 1;
+			for(int k = 1; k < n; ++k){
+				const auto a = pascal[n - 1][k - 1];
+				const auto b = pascal[n - 1][k];
+				pascal[n][k] = (a && b) ? safeintegralop::safe_add<std::uint64_t>(*a, *b) : std::optional<std::uint64_t>{};
+			}
+		}
+		return pascal;
+	}
+
+	template <typename T0>
+	void compare_with_pascal(const std::vector<std::vector<std::optional<std::uint64_t>>>& pascal) {
+		for(int n = 0; n != int(pascal.size()); ++n){
+			for(int k = -2; k <= n + 2; ++k){
+				const auto expected =
+				  (k < 0 || k > n) ? T0{0} :
+				  pascal[n][k] ? safeintegralop::safe_cast<T0>(*pascal[n][k]) : std::optional<T0>{};
+				if(safeintegralop::safe_binomial<T0>(n, k) != expected){
+					FAIL("C(" << n << ", " << k << ")");
+				}
+			}
+		}
+	}
+
+	// C(n, k) == C(n-1, k-1) + C(n-1, k), also beyond the precalculated triangle
+	template <typename T0, typename T1>
+	void compare_with_recurrence(const T1 first_n, const int max_k) {
+		for(T1 n = first_n; n != T1(first_n + 2000); ++n){
+			for(int k = 1; k <= max_k; ++k){
+				const auto a = safeintegralop::safe_binomial<T0>(n - 1, k - 1);
+				const auto b = safeintegralop::safe_binomial<T0>(n - 1, k);
+				const auto expected = (a && b) ? safeintegralop::safe_add<T0>(*a, *b) : std::optional<T0>{};
+				if(safeintegralop::safe_binomial<T0>(n, k) != expected){
+					FAIL("C(" << n << ", " << k << ")");
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("safe_binomial, same results of Pascal's triangle", "[binomial]") {
+	const auto pascal = make_pascal(200);
+	compare_with_pascal<std::int8_t>(pascal);
+	compare_with_pascal<std::uint8_t>(pascal);
+	compare_with_pascal<std::int16_t>(pascal);
+	compare_with_pascal<std::int32_t>(pascal);
+	compare_with_pascal<std::uint32_t>(pascal);
+	compare_with_pascal<std::int64_t>(pascal);
+	compare_with_pascal<std::uint64_t>(pascal);
+}
+
+TEST_CASE("safe_binomial, beyond the table", "[binomial]") {
+	compare_with_recurrence<std::int16_t>(1, 4);
+	compare_with_recurrence<std::uint32_t>(1, 8);
+	compare_with_recurrence<std::int64_t>(1, 20);
+	compare_with_recurrence<std::uint64_t>(std::uint64_t(1) << 20, 4);
+	compare_with_recurrence<std::uint64_t>(std::uint64_t(6074001000) - 1000, 2);
+
+	// C(n, 2) == n/2 * (n-1) for even n
+	const std::uint64_t n = std::uint64_t(1) << 32;
+	REQUIRE(safeintegralop::safe_binomial<std::uint64_t>(n, 2) == (n / 2) * (n - 1));
+	REQUIRE(safeintegralop::safe_binomial<std::uint64_t>(n, n - 2) == (n / 2) * (n - 1));
+	REQUIRE(!safeintegralop::safe_binomial<std::uint64_t>(std::numeric_limits<std::uint64_t>::max(), 2));
+	REQUIRE(safeintegralop::safe_binomial<std::uint64_t>(std::numeric_limits<std::uint64_t>::max(), 1) == std::numeric_limits<std::uint64_t>::max());
+	REQUIRE(safeintegralop::safe_binomial<std::int8_t>(std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::max()) == 1);
+}
+
+TEST_CASE("safe_factorial, same results of repeated safe_mult", "[binomial]") {
+	std::optional<std::uint64_t> expected = 1;
+	for(int n = 0; n != 30; ++n){
+		expected = (n == 0 || !expected) ? expected : safeintegralop::safe_mult<std::uint64_t>(*expected, n);
+		REQUIRE(safeintegralop::safe_factorial<std::uint64_t>(n) == expected);
+		REQUIRE(safeintegralop::safe_factorial<std::int32_t>(n) == (expected ? safeintegralop::safe_cast<std::int32_t>(*expected) : std::optional<std::int32_t>{}));
+		REQUIRE(safeintegralop::safe_factorial<std::uint8_t>(n) == (expected ? safeintegralop::safe_cast<std::uint8_t>(*expected) : std::optional<std::uint8_t>{}));
+	}
+	REQUIRE(!safeintegralop::safe_factorial<std::uint64_t>(-1));
+	REQUIRE(!safeintegralop::safe_factorial<std::uint64_t>(std::numeric_limits<std::uint64_t>::max()));
+}
+
+// Simple profiling test
+namespace {
+	const auto repetitions = 20000;
+	// the intermediate values of the multiplicative formula, reduced with C(n, k) == C(n, n-k), fit in 64 bits
+	const int max_n = 60;
+}
+
+TEST_CASE("binomial with safe_integral and the multiplicative formula", "[binomial][.]") {
+	unsigned long long res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(int n = 0; n != max_n; ++n){
+			for(int k = 0; k <= n; ++k){
+				const int kr = (k <= n / 2) ? k : n - k;
+				safe_ulonglong c = 1;
+				for(int i = 1; i <= kr; ++i){
+					c = c * (n - kr + i) / i;
+				}
+				res ^= c.getvalue();
+			}
+		}
+	}
+	REQUIRE(res == 0);
+}
+
+TEST_CASE("binomial with safe_binomial", "[binomial][.]") {
+	unsigned long long res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(int n = 0; n != max_n; ++n){
+			for(int k = 0; k <= n; ++k){
+				res ^= *safeintegralop::safe_binomial<unsigned long long>(n, k);
+			}
+		}
+	}
+	REQUIRE(res == 0);
+}
+#endif
@@ -0,0 +1,260 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeblock.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	// generic lambdas require c++14
+	struct mult_add {
+		template <typename V>
+		constexpr V operator()(const V a, const V b) const {
+			return a * b + a;
+		}
+	};
+
+	struct mult_add_offset {
+		int offset;
+		template <typename V>
+		constexpr V operator()(const V a, const V b) const {
+			return a * b + a + offset;
+		}
+	};
+
+	struct polynomial {
+		template <typename V>
+		constexpr V operator()(const V a) const {
+			return (a * a - a) / 2 + 1;
+		}
+	};
+
+	// throws an exception that is not an overflow for a
+	struct throw_on {
+		int a;
+		template <typename V>
+		V operator()(const V v) const {
+			if(v == a){
+				throw std::logic_error("throw_on");
+			}
+			return v;
+		}
+		constexpr safe_interval<int> operator()(const safe_interval<int> v) const {
+			return v;
+		}
+	};
+
+	using interval = safe_interval<int>;
+	using uinterval = safe_interval<unsigned int>;
+}
+
+TEST_CASE("safe_interval arithmetic", "[block]") {
+	const auto max = std::numeric_limits<int>::max();
+	const auto min = std::numeric_limits<int>::min();
+
+	const auto a = interval(-10, 10) * interval(0, 100) + 5;
+	REQUIRE(a.is_valid());
+	REQUIRE(a.min() == -995);
+	REQUIRE(a.max() == 1005);
+
+	const auto b = interval(-10, 10) - interval(-3, 7);
+	REQUIRE(b.min() == -17);
+	REQUIRE(b.max() == 13);
+
+	const auto c = interval(-100, 50) / interval(3, 7);
+	REQUIRE(c.min() == -33);
+	REQUIRE(c.max() == 16);
+
+	const auto d = -interval(-5, 7);
+	REQUIRE(d.min() == -7);
+	REQUIRE(d.max() == 5);
+
+	REQUIRE(interval(max - 1).is_valid());
+	REQUIRE((interval(0, max - 1) + 1).is_valid());
+	REQUIRE(!(interval(0, max) + 1).is_valid());
+	REQUIRE(!(interval(min, 0) - 1).is_valid());
+	REQUIRE(!(-interval(min, 0)).is_valid());
+	REQUIRE(!(interval(-2, 2) * interval(min / 2, 0)).is_valid());
+	REQUIRE((interval(-2, 2) * interval(min / 2 + 1, 0)).is_valid());
+	REQUIRE(!(interval(1, 10) / interval(-1, 1)).is_valid());
+	REQUIRE(!(interval(min, 10) / interval(-1, -1)).is_valid());
+	REQUIRE(!((interval(0, max) + 1) * 0).is_valid());
+
+	REQUIRE(!(uinterval(0, 10) - uinterval(0, 1)).is_valid());
+	REQUIRE((uinterval(5, 10) - uinterval(0, 5)).is_valid());
+	REQUIRE(!(-uinterval(0, 1)).is_valid());
+	REQUIRE((-uinterval(0)).is_valid());
+
+	REQUIRE(interval(-5, 7).contains(7));
+	REQUIRE(!interval(-5, 7).contains(8));
+	REQUIRE_THROWS_AS(interval(1, 0), std::out_of_range);
+	REQUIRE_THROWS_AS(make_safe_interval(1u, 0u), std::out_of_range);
+}
+
+TEST_CASE("safe_interval in constant expressions", "[block]") {
+	static_assert(safeintegralop::is_safe_interval(polynomial{}, interval(-1000, 1000)), "");
+	static_assert(!safeintegralop::is_safe_interval(polynomial{}, interval(-100000, 1000)), "");
+	static_assert(safeintegralop::is_safe_interval(mult_add{}, interval(-1000, 1000), interval(0, 100)), "");
+	REQUIRE(true);
+}
+
+TEST_CASE("safe_transform", "[block]") {
+	const auto max = std::numeric_limits<int>::max();
+	std::vector<int> a = {1, -2, 3, 1000, -1000};
+	std::vector<int> b = {7, 8, -9, 1000, 0};
+	std::vector<int> out(a.size());
+
+	// unchecked path
+	REQUIRE(safeintegralop::safe_transform(a.data(), b.data(), a.size(), out.data(), mult_add{}) == a.size());
+	REQUIRE(out == std::vector<int>({8, -18, -24, 1001000, -1000}));
+	REQUIRE(safeintegralop::safe_transform(a.data(), a.size(), out.data(), polynomial{}) == a.size());
+	REQUIRE(out == std::vector<int>({1, 4, 4, 499501, 500501}));
+
+	// checked path, the interval is too big but no value overflows
+	a[4] = 0;
+	b[4] = max;
+	REQUIRE(safeintegralop::safe_transform(a.data(), b.data(), a.size(), out.data(), mult_add{}) == a.size());
+	REQUIRE(out.back() == 0);
+
+	// checked path, a value overflows
+	b[1] = max;
+	out.assign(out.size(), 0);
+	REQUIRE(safeintegralop::safe_transform(a.data(), b.data(), a.size(), out.data(), mult_add{}) == 1);
+	REQUIRE(out == std::vector<int>({8, 0, 0, 0, 0}));
+
+	// values are processed in blocks
+	std::vector<int> big(5000, 3);
+	big[4500] = max;
+	std::vector<int> big_out(big.size());
+	REQUIRE(safeintegralop::safe_transform(big.data(), big.size(), big_out.data(), polynomial{}) == 4500);
+	REQUIRE(big_out[4499] == 4);
+	REQUIRE(big_out[4500] == 0);
+
+	REQUIRE(safeintegralop::safe_transform(a.data(), 0, out.data(), polynomial{}) == 0);
+	REQUIRE_THROWS_AS(safeintegralop::minmax_interval(a.data(), 0), std::out_of_range);
+
+	std::vector<safe_int> sa(a.begin(), a.end());
+	std::vector<safe_int> sb(b.begin(), b.end());
+	std::vector<safe_int> sout(a.size());
+	REQUIRE_NOTHROW(safeintegralop::safe_transform(sa.data(), sa.size(), sout.data(), polynomial{}));
+	REQUIRE(sout[3] == 499501);
+	REQUIRE_THROWS_AS(safeintegralop::safe_transform(sa.data(), sb.data(), sa.size(), sout.data(), mult_add{}), std::out_of_range);
+	REQUIRE(sout[0] == 8);
+}
+
+TEST_CASE("safe_transform_parallel", "[block]") {
+	const auto max = std::numeric_limits<int>::max();
+	std::vector<int> a(200000);
+	std::vector<int> b(a.size());
+	for(std::size_t i = 0; i != a.size(); ++i){
+		a[i] = int(i % 2000) - 1000;
+		b[i] = int(i % 777);
+	}
+	std::vector<int> expected(a.size());
+	REQUIRE(safeintegralop::safe_transform(a.data(), b.data(), a.size(), expected.data(), mult_add{}) == a.size());
+
+	for(const unsigned threads : {0u, 1u, 2u, 4u, 7u}){
+		std::vector<int> out(a.size());
+		REQUIRE(safeintegralop::safe_transform_parallel(a.data(), b.data(), a.size(), out.data(), mult_add{}, threads) == a.size());
+		REQUIRE(out == expected);
+
+		// the lowest overflowing index is returned, whatever chunk overflows first
+		for(const std::size_t k : {std::size_t(0), std::size_t(16383), std::size_t(16384), std::size_t(100000), a.size() - 1}){
+			auto c = b;
+			c[k] = max;
+			c[a.size() - 1] = max;
+			c[k + (a.size() - k) / 2] = max;
+			const auto i = safeintegralop::safe_transform_parallel(a.data(), c.data(), a.size(), out.data(), mult_add{}, threads);
+			REQUIRE(i == (a[k] == 0 ? a.size() - 1 : k));
+			REQUIRE(std::equal(out.begin(), out.begin() + std::ptrdiff_t(i), expected.begin()));
+		}
+
+		// values are transformed before the exception is rethrown
+		std::vector<safe_int> sa(a.begin(), a.end());
+		std::vector<safe_int> sout(a.size());
+		REQUIRE_THROWS_AS(safeintegralop::safe_transform_parallel(sa.data(), sa.size(), sout.data(), throw_on{a[150000]}, threads), std::logic_error);
+		REQUIRE_NOTHROW(safeintegralop::safe_transform_parallel(sa.data(), sa.size(), sout.data(), polynomial{}, threads));
+		REQUIRE(sout[3] == polynomial{}(a[3]));
+		sa[123456] = max;
+		REQUIRE_THROWS_AS(safeintegralop::safe_transform_parallel(sa.data(), sa.size(), sout.data(), polynomial{}, threads), std::out_of_range);
+		REQUIRE(safeintegralop::safe_transform_parallel(a.data(), 0, out.data(), polynomial{}, threads) == 0);
+	}
+}
+
+// Simple profiling test
+namespace {
+	const auto bigvector = 1000000;
+	const auto repetitions = 100;
+
+	std::vector<int> make_values(const int seed) {
+		std::vector<int> v;
+		v.reserve(bigvector);
+		for(int i = 0; i != bigvector; ++i){
+			v.push_back((i * seed) % 20000 - 10000);
+		}
+		return v;
+	}
+}
+
+TEST_CASE("a * b + a with safe_int", "[block][.]") {
+	const auto a = make_values(7);
+	const auto b = make_values(13);
+	const std::vector<safe_int> sa(a.begin(), a.end());
+	const std::vector<safe_int> sb(b.begin(), b.end());
+	std::vector<safe_int> out(a.size());
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 0; i != sa.size(); ++i){
+			out[i] = mult_add_offset{r}(sa[i], sb[i]);
+		}
+	}
+	REQUIRE(out[1] == -9993 * -9987 - 9993 + repetitions - 1);
+}
+
+TEST_CASE("a * b + a with safe_transform", "[block][.]") {
+	const auto a = make_values(7);
+	const auto b = make_values(13);
+	const std::vector<safe_int> sa(a.begin(), a.end());
+	const std::vector<safe_int> sb(b.begin(), b.end());
+	std::vector<safe_int> out(a.size());
+	for(int r = 0; r != repetitions; ++r){
+		safeintegralop::safe_transform(sa.data(), sb.data(), sa.size(), out.data(), mult_add_offset{r});
+	}
+	REQUIRE(out[1] == -9993 * -9987 - 9993 + repetitions - 1);
+}
+
+TEST_CASE("a * b + a with int", "[block][.]") {
+	const auto a = make_values(7);
+	const auto b = make_values(13);
+	std::vector<int> out(a.size());
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 0; i != a.size(); ++i){
+			out[i] = mult_add_offset{r}(a[i], b[i]);
+		}
+	}
+	REQUIRE(out[1] == -9993 * -9987 - 9993 + repetitions - 1);
+}
+
+TEST_CASE("a * b + a with safe_transform_parallel", "[block][.]") {
+	const auto a = make_values(7);
+	const auto b = make_values(13);
+	const std::vector<safe_int> sa(a.begin(), a.end());
+	const std::vector<safe_int> sb(b.begin(), b.end());
+	std::vector<safe_int> out(a.size());
+	for(int r = 0; r != repetitions; ++r){
+		safeintegralop::safe_transform_parallel(sa.data(), sb.data(), sa.size(), out.data(), mult_add_offset{r});
+	}
+	REQUIRE(out[1] == -9993 * -9987 - 9993 + repetitions - 1);
+}
+
+TEST_CASE("a * b + a with safe_transform_parallel, overflow at the beginning", "[block][.]") {
+	const auto a = make_values(7);
+	auto b = make_values(13);
+	b[1] = std::numeric_limits<int>::max();
+	std::vector<int> out(a.size());
+	for(int r = 0; r != repetitions; ++r){
+		REQUIRE(safeintegralop::safe_transform_parallel(a.data(), b.data(), a.size(), out.data(), mult_add_offset{r}) == 1);
+	}
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safebuffer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+TEST_CASE("default_init_allocator", "[buffer]") {
+	std::vector<safe_int, default_init_allocator<safe_int>> v(100);
+	REQUIRE(v.size() == 100);
+	std::iota(v.begin(), v.end(), 0);
+	REQUIRE(v[99] == 99);
+
+	v.resize(200);
+	REQUIRE(v[99] == 99);
+	v.push_back(7);
+	REQUIRE(v.back() == 7);
+
+	// the other constructors behave like std::allocator
+	v.assign(10, 42);
+	REQUIRE(std::all_of(v.begin(), v.end(), [](const safe_int i){ return i == 42; }));
+	v.resize(20, 1);
+	REQUIRE(v[19] == 1);
+
+	const auto copy = v;
+	REQUIRE(copy == v);
+
+	std::vector<int, default_init_allocator<int>> raw(10);
+	raw.assign(5, -1);
+	REQUIRE(raw.size() == 5);
+	REQUIRE(raw[4] == -1);
+}
+
+TEST_CASE("make_uninitialized", "[buffer]") {
+	auto buffer = make_uninitialized<safe_longlong>(1000);
+	REQUIRE(buffer.size() == 1000);
+	std::fill(buffer.begin(), buffer.end(), 3);
+	REQUIRE(std::accumulate(buffer.begin(), buffer.end(), safe_longlong(0)) == 3000);
+
+	const safe_int i(safe_uninitialized);
+	(void)i;
+}
+
+// Simple profiling test
+namespace {
+	// 1 GiB of safe_int
+	const std::size_t bigbuffer = std::size_t(1) << 28;
+}
+
+TEST_CASE("fill std::vector<safe_int>", "[buffer][.]") {
+	std::vector<safe_int> v(bigbuffer);
+	for(std::size_t i = 0; i != v.size(); ++i){
+		v[i] = static_cast<int>(i);
+	}
+	REQUIRE(v[bigbuffer - 1] == static_cast<int>(bigbuffer - 1));
+}
+
+TEST_CASE("fill make_uninitialized<safe_int>", "[buffer][.]") {
+	auto v = make_uninitialized<safe_int>(bigbuffer);
+	for(std::size_t i = 0; i != v.size(); ++i){
+		v[i] = static_cast<int>(i);
+	}
+	REQUIRE(v[bigbuffer - 1] == static_cast<int>(bigbuffer - 1));
+}
+
+TEST_CASE("resize std::vector<safe_int>", "[buffer][.]") {
+	std::vector<safe_int> v;
+	for(std::size_t size = 1 << 20; size <= bigbuffer; size *= 2){
+		v.resize(size);
+	}
+	REQUIRE(v.size() == bigbuffer);
+}
+
+TEST_CASE("resize uninitialized_vector<safe_int>", "[buffer][.]") {
+	uninitialized_vector<safe_int> v;
+	for(std::size_t size = 1 << 20; size <= bigbuffer; size *= 2){
+		v.resize(size);
+	}
+	REQUIRE(v.size() == bigbuffer);
+}
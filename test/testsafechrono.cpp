@@ -0,0 +1,203 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safechrono.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include <vector>
+
+static_assert(!std::chrono::treat_as_floating_point<safe_integral<std::int64_t>>::value, "");
+static_assert(std::is_same<std::common_type<safe_int, safe_longlong>::type, safe_longlong>::value, "");
+static_assert(std::is_same<std::common_type<safe_int, long long>::type, safe_longlong>::value, "");
+static_assert(std::is_same<std::common_type<short, safe_integral<short>>::type, safe_integral<short>>::value, "");
+static_assert(std::is_same<std::common_type<safe_integral<std::uint64_t>, std::intmax_t>::type, safe_integral<std::uint64_t>>::value, "");
+static_assert(safeintegralop::safe_duration_cast<std::chrono::milliseconds>(std::chrono::seconds(3)).count() == 3000, "");
+
+namespace {
+	using safe_nanoseconds = std::chrono::duration<safe_integral<std::int64_t>, std::nano>;
+	using safe_seconds = std::chrono::duration<safe_integral<std::int64_t>>;
+
+	// std::chrono::duration_cast with safe_integral reps throws if the conversion overflows
+	template <typename From, typename To, typename Period1, typename Period2>
+	void check_duration_cast(const From v) {
+		using safe_from = std::chrono::duration<safe_integral<From>, Period1>;
+		using safe_to = std::chrono::duration<safe_integral<To>, Period2>;
+		using raw_to = std::chrono::duration<To, Period2>;
+		bool overflow = false;
+		safe_to expected;
+		try{
+			expected = std::chrono::duration_cast<safe_to>(safe_from(v));
+		} catch(const std::out_of_range&){
+			overflow = true;
+		}
+		if(overflow){
+			REQUIRE_THROWS_AS(safeintegralop::safe_duration_cast<raw_to>(std::chrono::duration<From, Period1>(v)), std::out_of_range);
+			REQUIRE_THROWS_AS(safeintegralop::safe_duration_cast<safe_to>(safe_from(v)), std::out_of_range);
+		} else {
+			REQUIRE(safeintegralop::safe_duration_cast<raw_to>(std::chrono::duration<From, Period1>(v)).count() == expected.count().getvalue());
+			REQUIRE(safeintegralop::safe_duration_cast<safe_to>(safe_from(v)) == expected);
+		}
+	}
+
+	// values near the limits of the conversion, and of From
+	template <typename From, typename To, typename Period1, typename Period2>
+	void check_duration_cast() {
+		using limits = safeintegralop::details::duration_cast_limits<From, To, typename std::ratio_divide<Period1, Period2>::type>;
+		const From values[] = {limits::lo, limits::hi, std::numeric_limits<From>::min(), std::numeric_limits<From>::max(), From(0), From(1)};
+		for(const From v : values){
+			for(int d = -3; d <= 3; ++d){
+				const bool below = d < 0 && v < std::numeric_limits<From>::min() + From(-d);
+				const bool above = d > 0 && v > std::numeric_limits<From>::max() - From(d);
+				if(!below && !above){
+					check_duration_cast<From, To, Period1, Period2>(From(v + From(d)));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("safe_integral as rep of duration", "[chrono]") {
+	const auto max = std::numeric_limits<std::int64_t>::max();
+	const safe_nanoseconds t0(1000);
+	const safe_nanoseconds t1(max - 10);
+	REQUIRE((t1 - t0).count() == max - 1010);
+	REQUIRE_THROWS_AS(t1 + t0, std::out_of_range);
+	REQUIRE_THROWS_AS(t1 * 2, std::out_of_range);
+	REQUIRE(t0 < t1);
+	REQUIRE(safe_nanoseconds::zero().count() == 0);
+	REQUIRE(safe_nanoseconds::max().count() == max);
+	REQUIRE(safe_nanoseconds::min().count() == std::numeric_limits<std::int64_t>::min());
+
+	// the implicit conversions, and std::chrono::duration_cast, are checked
+	const safe_seconds s(max / 1000000000);
+	const safe_nanoseconds ns = s;
+	REQUIRE(ns.count() == max / 1000000000 * 1000000000);
+	REQUIRE_THROWS_AS(safe_nanoseconds(s + safe_seconds(1)), std::out_of_range);
+	REQUIRE_THROWS_AS(t1 + s, std::out_of_range);
+	REQUIRE(std::chrono::duration_cast<safe_seconds>(t1).count() == max / 1000000000);
+	using safe_int_seconds = std::chrono::duration<safe_int>;
+	REQUIRE_THROWS_AS(std::chrono::duration_cast<safe_int_seconds>(t1), std::out_of_range);
+	REQUIRE(std::chrono::duration_cast<safe_int_seconds>(safe_nanoseconds(5000000000)).count() == 5);
+
+	REQUIRE(static_cast<safe_int>(safe_longlong(-5)) == -5);
+	REQUIRE_THROWS_AS(static_cast<safe_int>(safe_longlong(max)), std::out_of_range);
+	REQUIRE_THROWS_AS(static_cast<safe_uint>(safe_int(-1)), std::out_of_range);
+}
+
+TEST_CASE("safe_duration_cast", "[chrono]") {
+	REQUIRE(safeintegralop::safe_duration_cast<std::chrono::seconds>(std::chrono::milliseconds(-1999)).count() == -1);
+	REQUIRE(safeintegralop::safe_duration_cast<safe_nanoseconds>(std::chrono::seconds(2)).count() == 2000000000);
+	REQUIRE_THROWS_AS(safeintegralop::safe_duration_cast<std::chrono::nanoseconds>(std::chrono::hours(3000000)), std::out_of_range);
+	REQUIRE_THROWS_AS(safeintegralop::safe_duration_cast<std::chrono::duration<std::uint32_t>>(std::chrono::seconds(-1)), std::out_of_range);
+
+	check_duration_cast<std::int64_t, std::int64_t, std::nano, std::ratio<1>>();
+	check_duration_cast<std::int64_t, std::int64_t, std::ratio<1>, std::nano>();
+	check_duration_cast<std::int32_t, std::int64_t, std::ratio<3600>, std::nano>();
+	check_duration_cast<std::int64_t, std::int32_t, std::nano, std::milli>();
+	check_duration_cast<std::int64_t, std::int32_t, std::milli, std::micro>();
+	check_duration_cast<std::uint64_t, std::int64_t, std::milli, std::micro>();
+	check_duration_cast<std::int64_t, std::uint64_t, std::milli, std::micro>();
+	check_duration_cast<std::int64_t, std::uint32_t, std::ratio<1>, std::milli>();
+	check_duration_cast<std::uint32_t, std::int16_t, std::ratio<1>, std::ratio<1>>();
+	check_duration_cast<std::int16_t, std::int8_t, std::ratio<3>, std::ratio<5>>();
+	check_duration_cast<std::int64_t, std::int64_t, std::ratio<3>, std::ratio<5>>();
+	check_duration_cast<std::int64_t, std::int64_t, std::ratio<5>, std::ratio<3>>();
+}
+
+TEST_CASE("safe_duration_cast of columns", "[chrono]") {
+	std::vector<std::chrono::nanoseconds> ns(5000);
+	for(std::size_t i = 0; i != ns.size(); ++i){
+		ns[i] = std::chrono::nanoseconds(std::int64_t(i) * 1000000007 - 2000000000000);
+	}
+	std::vector<std::chrono::duration<std::int32_t, std::milli>> ms(ns.size());
+	REQUIRE(safeintegralop::safe_duration_cast(ns.data(), ns.size(), ms.data()) == ns.size());
+	for(std::size_t i = 0; i != ns.size(); ++i){
+		REQUIRE(ms[i] == std::chrono::duration_cast<std::chrono::milliseconds>(ns[i]));
+	}
+
+	// the first value that does not fit in 32 bits
+	ns[3000] = std::chrono::hours(1000);
+	ns[4000] = std::chrono::hours(-1000);
+	ms.assign(ms.size(), std::chrono::duration<std::int32_t, std::milli>(-1));
+	REQUIRE(safeintegralop::safe_duration_cast(ns.data(), ns.size(), ms.data()) == 3000);
+	REQUIRE(ms[2999] == std::chrono::duration_cast<std::chrono::milliseconds>(ns[2999]));
+	REQUIRE(ms[3000].count() == -1);
+
+	std::vector<safe_nanoseconds> safe_ns(ns.begin(), ns.end());
+	std::vector<safe_seconds> s(ns.size());
+	REQUIRE(safeintegralop::safe_duration_cast(safe_ns.data(), safe_ns.size(), s.data()) == ns.size());
+	REQUIRE(s[4000].count() == -3600000);
+
+	std::vector<std::int64_t> counts(ns.size());
+	for(std::size_t i = 0; i != ns.size(); ++i){
+		counts[i] = ns[i].count();
+	}
+	std::vector<std::int32_t> out(counts.size());
+	REQUIRE((safeintegralop::safe_duration_count_cast<std::chrono::duration<std::int32_t>, std::chrono::nanoseconds>(counts.data(), counts.size(), out.data())) == counts.size());
+	REQUIRE(out[4000] == -3600000);
+	REQUIRE((safeintegralop::safe_duration_count_cast<std::chrono::duration<std::int32_t, std::milli>, std::chrono::nanoseconds>(counts.data(), counts.size(), out.data())) == 3000);
+	REQUIRE((safeintegralop::safe_duration_count_cast<std::chrono::duration<std::int32_t, std::milli>, std::chrono::nanoseconds>(counts.data(), 0, out.data())) == 0);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+
+	std::vector<std::int64_t> make_timestamps() {
+		std::vector<std::int64_t> v(bigvector);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			v[i] = 1500000000000000000 + std::int64_t(i) * 999983;
+		}
+		return v;
+	}
+}
+
+TEST_CASE("nanoseconds to microseconds with std::chrono::duration_cast and safe_integral", "[chrono][.]") {
+	const auto t = make_timestamps();
+	const std::vector<safe_nanoseconds> ns(t.begin(), t.end());
+	using safe_microseconds = std::chrono::duration<safe_integral<std::int64_t>, std::micro>;
+	std::vector<safe_microseconds> us(ns.size());
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 0; i != ns.size(); ++i){
+			us[i] = std::chrono::duration_cast<safe_microseconds>(ns[i]);
+		}
+	}
+	REQUIRE(us[1].count() == t[1] / 1000);
+}
+
+TEST_CASE("nanoseconds to microseconds with safe_duration_cast", "[chrono][.]") {
+	const auto t = make_timestamps();
+	const std::vector<safe_nanoseconds> ns(t.begin(), t.end());
+	using safe_microseconds = std::chrono::duration<safe_integral<std::int64_t>, std::micro>;
+	std::vector<safe_microseconds> us(ns.size());
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 0; i != ns.size(); ++i){
+			us[i] = safeintegralop::safe_duration_cast<safe_microseconds>(ns[i]);
+		}
+	}
+	REQUIRE(us[1].count() == t[1] / 1000);
+}
+
+TEST_CASE("nanoseconds to microseconds with safe_duration_count_cast", "[chrono][.]") {
+	const auto t = make_timestamps();
+	std::vector<std::int64_t> us(t.size());
+	for(int r = 0; r != repetitions; ++r){
+		REQUIRE((safeintegralop::safe_duration_count_cast<std::chrono::microseconds, std::chrono::nanoseconds>(t.data(), t.size(), us.data())) == t.size());
+	}
+	REQUIRE(us[1] == t[1] / 1000);
+}
+
+TEST_CASE("nanoseconds to microseconds with std::chrono::duration_cast", "[chrono][.]") {
+	const auto t = make_timestamps();
+	std::vector<std::chrono::microseconds> us(t.size());
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 0; i != t.size(); ++i){
+			us[i] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(t[i]));
+		}
+	}
+	REQUIRE(us[1].count() == t[1] / 1000);
+}
@@ -0,0 +1,144 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safecolumn.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace {
+	template <typename T>
+	std::vector<T> decode_all(const safe_column<T>& c) {
+		std::vector<T> v(c.size());
+		c.decode(0, c.size(), v.data());
+		return v;
+	}
+}
+
+TEST_CASE("safe_column encoding", "[column]") {
+	std::vector<std::int64_t> raw(3000);
+	for(std::size_t i = 0; i != raw.size(); ++i){
+		raw[i] = 1000000000000ll + std::int64_t(i % 200);
+	}
+	// the first block needs more than 16 bits
+	raw[5] = 1000000000000ll + 70000;
+	// the last (partial) block has only equal values
+	std::fill(raw.begin() + 2048, raw.end(), -7);
+
+	safe_column<std::int64_t> c(raw.data(), raw.size());
+	REQUIRE(c.size() == raw.size());
+	REQUIRE(c.width(0) == 4);
+	REQUIRE(c.width(1024) == 1);
+	REQUIRE(c.width(2999) == 0);
+	REQUIRE(c.encoded_bytes() == 1024 * 4 + 1024 * 1);
+	REQUIRE(decode_all(c) == raw);
+	REQUIRE(c[5] == 1000000000000ll + 70000);
+	REQUIRE(c.at(2999) == -7);
+	REQUIRE_THROWS_AS(c.at(3000), std::out_of_range);
+
+	std::vector<std::int64_t> part(10);
+	c.decode(1020, 10, part.data());
+	REQUIRE(std::equal(part.begin(), part.end(), raw.begin() + 1020));
+	REQUIRE_THROWS_AS(c.decode(2995, 10, part.data()), std::out_of_range);
+}
+
+TEST_CASE("safe_column writes", "[column]") {
+	std::vector<std::int32_t> raw(2000, 100);
+	safe_column<std::int32_t> c(raw.data(), raw.size());
+	REQUIRE(c.width(0) == 0);
+
+	// the value does not fit in the encoding, the block is re-encoded
+	c[3] += 1;
+	raw[3] += 1;
+	REQUIRE(c.width(0) == 1);
+	REQUIRE(decode_all(c) == raw);
+
+	// smaller than the base
+	c[1500] = -100000;
+	raw[1500] = -100000;
+	REQUIRE(c.width(1500) == 4);
+	REQUIRE(c.width(0) == 1);
+	REQUIRE(decode_all(c) == raw);
+
+	// fits in the encoding of the block
+	c[1501] = 0;
+	raw[1501] = 0;
+	REQUIRE(c.width(1500) == 4);
+	REQUIRE(decode_all(c) == raw);
+
+	// the element is not modified if the operation fails
+	c[7] = std::numeric_limits<std::int32_t>::max();
+	raw[7] = std::numeric_limits<std::int32_t>::max();
+	REQUIRE_THROWS_AS(c[7] += 1, std::out_of_range);
+	REQUIRE_THROWS_AS(++c[7], std::out_of_range);
+	c[8] = std::numeric_limits<std::int32_t>::min();
+	raw[8] = std::numeric_limits<std::int32_t>::min();
+	REQUIRE(c.width(0) == 4);
+	REQUIRE(decode_all(c) == raw);
+}
+
+TEST_CASE("safe_column append and push_back", "[column]") {
+	safe_column<std::uint16_t> c;
+	std::vector<std::uint16_t> raw;
+	for(int i = 0; i != 5000; ++i){
+		const auto v = std::uint16_t((i % 3 == 0) ? 65535 - i % 7 : i % 256);
+		c.push_back(v);
+		raw.push_back(v);
+	}
+	REQUIRE(decode_all(c) == raw);
+
+	const std::vector<std::uint16_t> more(2000, 42);
+	c.append(more.data(), more.size());
+	raw.insert(raw.end(), more.begin(), more.end());
+	REQUIRE(c.size() == 7000);
+	REQUIRE(decode_all(c) == raw);
+	REQUIRE(c.width(6999) == 0);
+
+	safe_column<std::int8_t> s;
+	s.push_back(std::numeric_limits<std::int8_t>::min());
+	s.push_back(std::numeric_limits<std::int8_t>::max());
+	REQUIRE(s.width(0) == 1);
+	REQUIRE(s[0] == std::numeric_limits<std::int8_t>::min());
+	REQUIRE(s[1] == std::numeric_limits<std::int8_t>::max());
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+
+	std::vector<std::int64_t> make_counters() {
+		std::vector<std::int64_t> v(bigvector);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			v[i] = std::int64_t(1) << 40 | std::int64_t(i * 2654435761u % 60000);
+		}
+		return v;
+	}
+}
+
+TEST_CASE("sum of std::vector<std::int64_t>", "[column][.]") {
+	const auto raw = make_counters();
+	safe_longlong sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		sum = std::accumulate(raw.begin(), raw.end(), safe_longlong(0));
+	}
+	REQUIRE(sum > 0);
+}
+
+TEST_CASE("sum of safe_column<std::int64_t>, decoded in blocks", "[column][.]") {
+	const auto raw = make_counters();
+	const safe_column<std::int64_t> c(raw.data(), raw.size());
+	INFO("encoded bytes: " << c.encoded_bytes() << " of " << raw.size() * sizeof(std::int64_t));
+	REQUIRE(c.encoded_bytes() * 4 == raw.size() * sizeof(std::int64_t));
+	std::vector<std::int64_t> buffer(safe_column<std::int64_t>::block_size);
+	safe_longlong sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		sum = 0;
+		for(std::size_t i = 0; i < c.size(); i += buffer.size()){
+			c.decode(i, buffer.size(), buffer.data());
+			sum = std::accumulate(buffer.begin(), buffer.end(), sum);
+		}
+	}
+	REQUIRE(sum > 0);
+}
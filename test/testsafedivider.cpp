@@ -0,0 +1,156 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safedivider.hpp"
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	template <typename T>
+	std::vector<T> interesting_values() {
+		std::vector<T> values;
+		for(int i = -300; i != 300; ++i){
+			if(safeintegralop::in_range<T>(i)){
+				values.push_back(static_cast<T>(i));
+			}
+		}
+		using U = typename std::make_unsigned<T>::type;
+		for(int i = 0; i != std::numeric_limits<T>::digits; ++i){
+			const auto p = static_cast<T>(T{1} << i);
+			values.push_back(p);
+			values.push_back(static_cast<T>(p - 1));
+			values.push_back(static_cast<T>(p + 1));
+			values.push_back(static_cast<T>(U(p) * 3u)); // p*3 overflows for the largest p of a signed T
+			if(std::is_signed<T>::value){
+				values.push_back(static_cast<T>(-p));
+			}
+		}
+		values.push_back(std::numeric_limits<T>::max());
+		values.push_back(static_cast<T>(std::numeric_limits<T>::max() - 1));
+		values.push_back(std::numeric_limits<T>::min());
+		values.push_back(static_cast<T>(std::numeric_limits<T>::min() + 1));
+		values.push_back(static_cast<T>(std::numeric_limits<T>::max() / 3));
+		values.push_back(static_cast<T>(std::numeric_limits<T>::max() / 7 * 5));
+		return values;
+	}
+
+	template <typename T>
+	void compare_with_builtin_division() {
+		const auto values = interesting_values<T>();
+		for(const auto d : values){
+			if(d == T{0}){
+				continue;
+			}
+			const auto divider = safe_divider<T>(d);
+			REQUIRE(divider.divisor() == d);
+			for(const auto n : values){
+				const auto s = safe_integral<T>(n);
+				if(safeintegralop::is_safe_div(n, d)){
+					// not using REQUIRE for every value, it would make the test much slower
+					if(getvalue(s / divider) != n / d || getvalue(s % divider) != n % d){
+						FAIL(+n << " / " << +d);
+					}
+				} else {
+					REQUIRE_THROWS_AS(s / divider, std::out_of_range);
+					REQUIRE_THROWS_AS(s % divider, std::out_of_range);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("safe_divider, same results of operator/", "[divider]") {
+	compare_with_builtin_division<signed char>();
+	compare_with_builtin_division<unsigned char>();
+	compare_with_builtin_division<short>();
+	compare_with_builtin_division<unsigned short>();
+	compare_with_builtin_division<int>();
+	compare_with_builtin_division<unsigned int>();
+	compare_with_builtin_division<long long>();
+	compare_with_builtin_division<unsigned long long>();
+}
+
+TEST_CASE("safe_divider, division by 0", "[divider][negative]") {
+	REQUIRE_THROWS_AS(safe_divider<int>(0), std::out_of_range);
+	REQUIRE_THROWS_AS(make_safe_divider(0ull), std::out_of_range);
+}
+
+TEST_CASE("safe_divider, bulk division", "[divider]") {
+	std::vector<int> values = {7, -7, 100, std::numeric_limits<int>::max(), std::numeric_limits<int>::min(), 1};
+	std::vector<int> out(values.size());
+
+	REQUIRE(safe_divider<int>(7).quotients(values.data(), values.size(), out.data()) == values.size());
+	REQUIRE(out == std::vector<int>({1, -1, 14, std::numeric_limits<int>::max()/7, std::numeric_limits<int>::min()/7, 0}));
+	REQUIRE(safe_divider<int>(7).remainders(values.data(), values.size(), out.data()) == values.size());
+	REQUIRE(out == std::vector<int>({0, 0, 2, std::numeric_limits<int>::max()%7, std::numeric_limits<int>::min()%7, 1}));
+
+	REQUIRE(safe_divider<int>(-1).quotients(values.data(), values.size(), out.data()) == 4);
+	REQUIRE(out[3] == -std::numeric_limits<int>::max());
+
+	std::vector<safe_int> safe_values(values.begin(), values.end());
+	std::vector<safe_int> safe_out(values.size());
+	REQUIRE_NOTHROW(safe_divider<int>(3).quotients(safe_values.data(), safe_values.size(), safe_out.data()));
+	REQUIRE(safe_out[2] == 33);
+	REQUIRE_THROWS_AS(safe_divider<int>(-1).remainders(safe_values.data(), safe_values.size(), safe_out.data()), std::out_of_range);
+}
+
+// Simple profiling test
+namespace {
+	const auto bigvector = 1000000;
+	const auto repetitions = 100;
+
+	template <typename T>
+	std::vector<safe_integral<T>> make_dividends() {
+		std::vector<safe_integral<T>> v;
+		v.reserve(bigvector);
+		for(int i = 0; i != bigvector; ++i){
+			v.push_back(static_cast<T>((static_cast<unsigned long long>(i) * 7919u) % static_cast<unsigned long long>(std::numeric_limits<T>::max())));
+		}
+		return v;
+	}
+}
+
+TEST_CASE("operator/ of safe_int", "[divider][.]") {
+	const auto v = make_dividends<int>();
+	std::vector<safe_int> out(v.size());
+	for(int r = 0; r != repetitions; ++r){
+		const auto d = make_safe(r + 3);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			out[i] = v[i] / d;
+		}
+	}
+	REQUIRE(out[1] == 7919/(repetitions + 2));
+}
+
+TEST_CASE("safe_divider of safe_int", "[divider][.]") {
+	const auto v = make_dividends<int>();
+	std::vector<safe_int> out(v.size());
+	for(int r = 0; r != repetitions; ++r){
+		const auto d = safe_divider<int>(r + 3);
+		d.quotients(v.data(), v.size(), out.data());
+	}
+	REQUIRE(out[1] == 7919/(repetitions + 2));
+}
+
+TEST_CASE("operator/ of safe_ulonglong", "[divider][.]") {
+	const auto v = make_dividends<unsigned long long>();
+	std::vector<safe_ulonglong> out(v.size());
+	for(int r = 0; r != repetitions; ++r){
+		const auto d = make_safe(r + 3ull);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			out[i] = v[i] / d;
+		}
+	}
+	REQUIRE(out[1] == 7919ull/(repetitions + 2));
+}
+
+TEST_CASE("safe_divider of safe_ulonglong", "[divider][.]") {
+	const auto v = make_dividends<unsigned long long>();
+	std::vector<safe_ulonglong> out(v.size());
+	for(int r = 0; r != repetitions; ++r){
+		const auto d = safe_divider<unsigned long long>(r + 3ull);
+		d.quotients(v.data(), v.size(), out.data());
+	}
+	REQUIRE(out[1] == 7919ull/(repetitions + 2));
+}
@@ -0,0 +1,207 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safedot.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+	template <typename T>
+	std::vector<T> make_values(const std::size_t count, const T lo, const T hi, std::uint64_t state) {
+		std::vector<T> values(count);
+		const auto range = std::uint64_t(std::int64_t(hi) - std::int64_t(lo)) + 1;
+		for(auto& v : values){
+			state = state * 6364136223846793005u + 1442695040888963407u;
+			v = static_cast<T>(std::int64_t(lo) + std::int64_t((state >> 33) % range));
+		}
+		return values;
+	}
+
+	// composition of safe_mult and safe_add
+	template <typename R, typename T>
+	std::size_t reference_dot(const T* a, const std::size_t stride_a, const T* b, const std::size_t stride_b, const std::size_t count, R& sum) {
+		safe_integral<R> s = sum;
+		for(std::size_t i = 0; i != count; ++i){
+			try{
+				s += safe_integral<R>(R(a[i * stride_a])) * safe_integral<R>(R(b[i * stride_b]));
+			} catch(const std::out_of_range&){
+				sum = s.getvalue();
+				return i;
+			}
+		}
+		sum = s.getvalue();
+		return count;
+	}
+
+	template <typename R, typename T>
+	void compare_dot_with_reference(const T lo, const T hi) {
+		for(const std::size_t count : {0, 1, 7, 31, 33, 5000, 20000}){
+			auto a = make_values<T>(count, lo, hi, 1);
+			const auto b = make_values<T>(count, lo, hi, 2);
+			for(const std::size_t spike : {std::size_t(0), count / 2, count}){
+				if(spike < count){
+					a[spike] = std::numeric_limits<T>::max();
+				}
+				for(const R init : {R{0}, std::numeric_limits<R>::max(), std::numeric_limits<R>::min()}){
+					R expected = init;
+					const auto expected_index = reference_dot(a.data(), 1, b.data(), 1, count, expected);
+					R sum = init;
+					const auto index = safeintegralop::safe_dot(a.data(), b.data(), count, sum);
+					if(index != expected_index || sum != expected){
+						FAIL("safe_dot with count " << count << " and spike " << spike);
+					}
+				}
+			}
+		}
+	}
+
+	template <typename R, typename T>
+	void compare_gemm_with_reference(const std::size_t m, const std::size_t n, const std::size_t k, const T lo, const T hi, const bool spike) {
+		auto a = make_values<T>(m * k, lo, hi, 3);
+		const auto b = make_values<T>(k * n, lo, hi, 4);
+		if(spike && !a.empty()){
+			a[a.size() / 2] = std::numeric_limits<T>::max();
+			a[(a.size() / 2 + 1) % a.size()] = std::numeric_limits<T>::max();
+		}
+		std::vector<R> c(m * n, R{42});
+		std::vector<char> overflow_flags(m * n + 1, 2);
+		bool* overflow = reinterpret_cast<bool*>(overflow_flags.data());
+		std::vector<bool> flags(m * n, true);
+		const auto overflows = safeintegralop::safe_gemm(a.data(), b.data(), m, n, k, c.data(), overflow);
+		std::size_t expected_overflows = 0;
+		for(std::size_t i = 0; i != m; ++i){
+			for(std::size_t j = 0; j != n; ++j){
+				R expected = R{0};
+				const bool failed = reference_dot(a.data() + i * k, 1, b.data() + j, n, k, expected) != k;
+				expected_overflows += failed;
+				if(c[i * n + j] != expected || overflow[i * n + j] != failed){
+					FAIL("safe_gemm " << m << "x" << n << "x" << k << " at " << i << ", " << j);
+				}
+			}
+		}
+		REQUIRE(overflows == expected_overflows);
+		REQUIRE(overflow_flags[m * n] == 2);
+	}
+}
+
+TEST_CASE("safe_dot, same results of safe_mult and safe_add", "[dot]") {
+	compare_dot_with_reference<std::int32_t, std::int16_t>(-100, 100);
+	compare_dot_with_reference<std::int32_t, std::int16_t>(std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max());
+	compare_dot_with_reference<std::int64_t, std::int16_t>(std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max());
+	compare_dot_with_reference<std::int64_t, std::int32_t>(-1000000, 1000000);
+	compare_dot_with_reference<std::uint32_t, std::uint16_t>(0, 1000);
+	compare_dot_with_reference<std::int32_t, std::uint8_t>(0, 255);
+	compare_dot_with_reference<std::int16_t, std::int8_t>(-10, 10);
+	compare_dot_with_reference<std::uint64_t, std::uint64_t>(0, 1000);
+}
+
+TEST_CASE("safe_dot", "[dot]") {
+	const std::vector<std::int16_t> a = {1, 2, 3};
+	const std::vector<std::int16_t> b = {4, 5, 6};
+	std::int32_t sum = 0;
+	REQUIRE(safeintegralop::safe_dot(a.data(), b.data(), a.size(), sum) == 3);
+	REQUIRE(sum == 32);
+
+	// -32768 * -32768 + -32768 * -32768 does not fit in a std::int32_t
+	const std::vector<std::int16_t> c(64, std::numeric_limits<std::int16_t>::min());
+	sum = 0;
+	REQUIRE(safeintegralop::safe_dot(c.data(), c.data(), c.size(), sum) == 1);
+	REQUIRE(sum == 1 << 30);
+
+	const std::vector<safe_integral<std::int16_t>> sa = {1, 2, 3};
+	REQUIRE(safeintegralop::safe_dot<std::int64_t>(sa.data(), sa.data(), sa.size()) == 14);
+	const std::vector<safe_integral<std::int32_t>> big(3, std::numeric_limits<std::int32_t>::max());
+	REQUIRE_THROWS_AS(safeintegralop::safe_dot<std::int32_t>(big.data(), big.data(), big.size()), std::out_of_range);
+	// more than one block, the sum overflows only in the last one
+	std::vector<safe_integral<std::int16_t>> many(3000, std::int16_t(1));
+	many[2998] = std::numeric_limits<std::int16_t>::max();
+	many[2999] = std::numeric_limits<std::int16_t>::max();
+	REQUIRE(safeintegralop::safe_dot<std::int32_t>(many.data(), many.data(), many.size()) == 2998 + 2 * 32767 * 32767);
+	many[2997] = std::numeric_limits<std::int16_t>::max();
+	REQUIRE_THROWS_AS(safeintegralop::safe_dot<std::int32_t>(many.data(), many.data(), many.size()), std::out_of_range);
+}
+
+TEST_CASE("safe_gemm, same results of safe_dot", "[dot]") {
+	for(const bool spike : {false, true}){
+		compare_gemm_with_reference<std::int32_t, std::int16_t>(1, 1, 1, -100, 100, spike);
+		compare_gemm_with_reference<std::int32_t, std::int16_t>(17, 300, 131, -100, 100, spike);
+		compare_gemm_with_reference<std::int32_t, std::int16_t>(9, 8, 300, -1000, 1000, spike);
+		compare_gemm_with_reference<std::int32_t, std::int16_t>(5, 13, 7, std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max(), spike);
+		compare_gemm_with_reference<std::int64_t, std::int16_t>(17, 300, 131, std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max(), spike);
+		compare_gemm_with_reference<std::int64_t, std::int32_t>(20, 30, 40, -100000, 100000, spike);
+		compare_gemm_with_reference<std::uint16_t, std::uint8_t>(20, 30, 40, 0, 5, spike);
+	}
+	compare_gemm_with_reference<std::int32_t, std::int16_t>(0, 3, 3, -100, 100, false);
+	compare_gemm_with_reference<std::int32_t, std::int16_t>(3, 3, 0, -100, 100, false);
+}
+
+TEST_CASE("safe_gemm", "[dot]") {
+	const std::vector<safe_integral<std::int16_t>> a = {1, 2, 3, 4};
+	const std::vector<safe_integral<std::int16_t>> b = {5, 6, 7, 8};
+	std::vector<safe_int> c(4);
+	safeintegralop::safe_gemm(a.data(), b.data(), 2, 2, 2, c.data());
+	REQUIRE(c == std::vector<safe_int>({19, 22, 43, 50}));
+
+	const std::vector<safe_int> big(4, std::numeric_limits<int>::max());
+	REQUIRE_THROWS_AS(safeintegralop::safe_gemm(big.data(), big.data(), 2, 2, 2, c.data()), std::out_of_range);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t matrix_size = 256;
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+}
+
+TEST_CASE("int16 matrix multiply with safe_integral", "[dot][.]") {
+	const auto a = make_values<std::int16_t>(matrix_size * matrix_size, -100, 100, 1);
+	const auto b = make_values<std::int16_t>(matrix_size * matrix_size, -100, 100, 2);
+	const std::vector<safe_integral<std::int32_t>> sa(a.begin(), a.end());
+	const std::vector<safe_integral<std::int32_t>> sb(b.begin(), b.end());
+	std::vector<safe_integral<std::int32_t>> c(matrix_size * matrix_size);
+	for(std::size_t i = 0; i != matrix_size; ++i){
+		for(std::size_t j = 0; j != matrix_size; ++j){
+			safe_integral<std::int32_t> sum = 0;
+			for(std::size_t k = 0; k != matrix_size; ++k){
+				sum += sa[i * matrix_size + k] * sb[k * matrix_size + j];
+			}
+			c[i * matrix_size + j] = sum;
+		}
+	}
+	std::int32_t expected = 0;
+	REQUIRE(safeintegralop::safe_dot(a.data(), b.data(), matrix_size, expected) == matrix_size);
+	REQUIRE(expected != 0);
+}
+
+TEST_CASE("int16 matrix multiply with safe_gemm", "[dot][.]") {
+	const auto a = make_values<std::int16_t>(matrix_size * matrix_size, -100, 100, 1);
+	const auto b = make_values<std::int16_t>(matrix_size * matrix_size, -100, 100, 2);
+	std::vector<std::int32_t> c(matrix_size * matrix_size);
+	REQUIRE(safeintegralop::safe_gemm(a.data(), b.data(), matrix_size, matrix_size, matrix_size, c.data()) == 0);
+}
+
+TEST_CASE("int16 dot product with safe_integral", "[dot][.]") {
+	const auto a = make_values<std::int16_t>(bigvector, -100, 100, 1);
+	const auto b = make_values<std::int16_t>(bigvector, -100, 100, 2);
+	safe_integral<std::int32_t> sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		sum = 0;
+		for(std::size_t i = 0; i != bigvector; ++i){
+			sum += safe_integral<std::int32_t>(a[i]) * safe_integral<std::int32_t>(b[i]);
+		}
+	}
+	std::int32_t expected = 0;
+	REQUIRE(safeintegralop::safe_dot(a.data(), b.data(), bigvector, expected) == bigvector);
+	REQUIRE(sum == expected);
+}
+
+TEST_CASE("int16 dot product with safe_dot", "[dot][.]") {
+	const auto a = make_values<std::int16_t>(bigvector, -100, 100, 1);
+	const auto b = make_values<std::int16_t>(bigvector, -100, 100, 2);
+	std::int32_t sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		sum = 0;
+		REQUIRE(safeintegralop::safe_dot(a.data(), b.data(), bigvector, sum) == bigvector);
+	}
+}
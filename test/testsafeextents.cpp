@@ -0,0 +1,138 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeextents.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+	// same interface of std::layout_stride::mapping<std::dextents<std::size_t, 2>>
+	struct mock_extents {
+		std::size_t e[2];
+		std::size_t extent(const std::size_t r) const { return e[r]; }
+	};
+	struct mock_mapping {
+		mock_extents ext;
+		std::size_t s[2];
+		const mock_extents& extents() const { return ext; }
+		std::size_t stride(const std::size_t r) const { return s[r]; }
+	};
+}
+
+TEST_CASE("safe_extents layouts", "[extents]") {
+	const safe_extents<std::size_t, 3> e(4, 5, 6);
+	REQUIRE(e.rank() == 3);
+	REQUIRE(e.size() == 120);
+	REQUIRE(e.required_span_size() == 120);
+	REQUIRE(e.stride(0) == 30);
+	REQUIRE(e.stride(1) == 6);
+	REQUIRE(e.stride(2) == 1);
+	REQUIRE(e.index(0, 0, 0) == 0);
+	REQUIRE(e.index(3, 4, 5) == 119);
+	REQUIRE(e.index(1, 2, 3) == 30 + 12 + 3);
+	REQUIRE(e.required_bytes(sizeof(double)) == 960);
+
+	const safe_extents<int, 2, safe_layout_left> l(3, 7);
+	REQUIRE(l.stride(0) == 1);
+	REQUIRE(l.stride(1) == 3);
+	REQUIRE(l.index(2, 6) == 20);
+	REQUIRE(l.required_span_size() == 21);
+
+	// rows of 10 elements, with 16 elements of padding
+	const safe_extents<std::ptrdiff_t, 2, safe_layout_stride> s({{100, 10}}, {{16, 1}});
+	REQUIRE(s.size() == 1000);
+	REQUIRE(s.required_span_size() == 99 * 16 + 10);
+	REQUIRE(s.index(99, 9) == 99 * 16 + 9);
+
+	const safe_extents<std::size_t, 2> empty(0, 10);
+	REQUIRE(empty.size() == 0);
+	REQUIRE(empty.required_span_size() == 0);
+	REQUIRE(!empty.contains(0, 0));
+
+	const mock_mapping m{{{20, 30}}, {1, 20}};
+	const auto fm = safe_extents<std::size_t, 2, safe_layout_stride>::from_mapping(m);
+	REQUIRE(fm.extent(1) == 30);
+	REQUIRE(fm.index(19, 29) == 19 + 29 * 20);
+	REQUIRE(fm.required_span_size() == 600);
+}
+
+TEST_CASE("safe_extents overflow", "[extents]") {
+	const std::size_t big = std::size_t(1) << (std::numeric_limits<std::size_t>::digits / 2);
+	REQUIRE_THROWS_AS((safe_extents<std::size_t, 2>(big, big)), std::out_of_range);
+	REQUIRE_THROWS_AS((safe_extents<std::size_t, 2, safe_layout_left>(big, big)), std::out_of_range);
+	REQUIRE_NOTHROW((safe_extents<std::size_t, 2>(big, big - 1)));
+	REQUIRE_THROWS_AS((safe_extents<std::int32_t, 3>(2000, 2000, 1000)), std::out_of_range);
+	REQUIRE_THROWS_AS((safe_extents<std::int32_t, 2>(-1, 10)), std::out_of_range);
+	REQUIRE_THROWS_AS((safe_extents<std::int16_t, 1>(40000)), std::out_of_range);
+	// the product of the extents is representable, but not the required storage
+	REQUIRE_THROWS_AS((safe_extents<std::int32_t, 2, safe_layout_stride>({{1000, 10}}, {{10000000, 1}})), std::out_of_range);
+	REQUIRE_THROWS_AS((safe_extents<std::int32_t, 2, safe_layout_stride>({{10, 10}}, {{-10, 1}})), std::out_of_range);
+	REQUIRE_THROWS_AS((safe_extents<std::size_t, 1>(std::size_t(1) << 62).required_bytes(8)), std::out_of_range);
+}
+
+TEST_CASE("safe_extents at", "[extents]") {
+	const safe_extents<std::int64_t, 2> e(3, 4);
+	REQUIRE(e.contains(2, 3));
+	REQUIRE(e.contains(std::uint8_t(2), 3u));
+	REQUIRE(!e.contains(3, 0));
+	REQUIRE(!e.contains(0, -1));
+	REQUIRE(e.at(2, 3) == 11);
+	REQUIRE_THROWS_AS(e.at(0, 4), std::out_of_range);
+	REQUIRE_THROWS_AS(e.at(-1, 0), std::out_of_range);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t height = 2048;
+	const std::size_t width = 2048;
+	const auto repetitions = 20;
+}
+
+TEST_CASE("2D stencil, indexes computed with safe_integral", "[extents][.]") {
+	std::vector<std::int32_t> in(height * width, 1);
+	std::vector<std::int32_t> out(in.size());
+	const safe_integral<std::size_t> stride = width;
+	for(int rep = 0; rep != repetitions; ++rep){
+		for(std::size_t r = 1; r + 1 < height; ++r){
+			for(std::size_t c = 1; c + 1 < width; ++c){
+				const safe_integral<std::size_t> sr = r;
+				const safe_integral<std::size_t> sc = c;
+				const auto one = safe_integral<std::size_t>(1);
+				out[(sr * stride + sc).getvalue()] =
+				    in[((sr - one) * stride + sc).getvalue()] + in[((sr + one) * stride + sc).getvalue()] +
+				    in[(sr * stride + sc - one).getvalue()] + in[(sr * stride + sc + one).getvalue()] - 4 * in[(sr * stride + sc).getvalue()];
+			}
+		}
+	}
+	REQUIRE(out[width + 1] == 0);
+}
+
+TEST_CASE("2D stencil, indexes computed with safe_extents", "[extents][.]") {
+	const safe_extents<std::size_t, 2> e(height, width);
+	std::vector<std::int32_t> in(e.size(), 1);
+	std::vector<std::int32_t> out(e.size());
+	for(int rep = 0; rep != repetitions; ++rep){
+		for(std::size_t r = 1; r + 1 < e.extent(0); ++r){
+			for(std::size_t c = 1; c + 1 < e.extent(1); ++c){
+				out[e.index(r, c)] = in[e.index(r - 1, c)] + in[e.index(r + 1, c)] + in[e.index(r, c - 1)] + in[e.index(r, c + 1)] - 4 * in[e.index(r, c)];
+			}
+		}
+	}
+	REQUIRE(out[width + 1] == 0);
+}
+
+TEST_CASE("2D stencil, raw indexes", "[extents][.]") {
+	std::vector<std::int32_t> in(height * width, 1);
+	std::vector<std::int32_t> out(in.size());
+	for(int rep = 0; rep != repetitions; ++rep){
+		for(std::size_t r = 1; r + 1 < height; ++r){
+			for(std::size_t c = 1; c + 1 < width; ++c){
+				out[r * width + c] = in[(r - 1) * width + c] + in[(r + 1) * width + c] + in[r * width + c - 1] + in[r * width + c + 1] - 4 * in[r * width + c];
+			}
+		}
+	}
+	REQUIRE(out[width + 1] == 0);
+}
@@ -0,0 +1,166 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeintegral.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+namespace {
+	// true if res is the reference result calculated with long long, or has no value if it is not representable by T0
+	template <typename T0>
+	bool is_expected(const safeintegralop::safe_result<T0> res, const long long expected) {
+		return safeintegralop::in_range<T0>(expected) ? (res.ok && res.value == T0(expected)) : !res.ok;
+	}
+
+	// reference results calculated with long long, every value of T1 and T2 is small enough
+	template <typename T0, typename T1, typename T2>
+	void compare_with_long_long() {
+		for(long long a = std::numeric_limits<T1>::min(); a <= std::numeric_limits<T1>::max(); ++a){
+			for(long long b = std::numeric_limits<T2>::min(); b <= std::numeric_limits<T2>::max(); ++b){
+				const long long gcd = std::gcd(a, b);
+				const long long lcm = std::lcm(a, b);
+				const long long midpoint = a + (b - a) / 2; // truncated towards zero, i.e. towards a
+				if(!is_expected(safeintegralop::safe_gcd_result<T0>(T1(a), T2(b)), gcd)){
+					FAIL("gcd(" << a << ", " << b << ")");
+				}
+				if(!is_expected(safeintegralop::safe_lcm_result<T0>(T1(a), T2(b)), lcm)){
+					FAIL("lcm(" << a << ", " << b << ")");
+				}
+				if(!is_expected(safeintegralop::safe_midpoint_result<T0>(T1(a), T2(b)), midpoint)){
+					FAIL("midpoint(" << a << ", " << b << ")");
+				}
+			}
+		}
+	}
+
+	// r == floor(sqrt(x)) <-> r*r <= x < (r+1)*(r+1)
+	bool is_isqrt(const std::uint64_t x, const std::uint64_t r) {
+		return r * r <= x && (r + 1 > x / (r + 1));
+	}
+}
+
+TEST_CASE("safe_gcd, safe_lcm and safe_midpoint, all values of small types", "[gcd]") {
+	compare_with_long_long<std::int8_t, std::int8_t, std::int8_t>();
+	compare_with_long_long<std::int16_t, std::int8_t, std::uint8_t>();
+	compare_with_long_long<std::uint8_t, std::uint8_t, std::int8_t>();
+	compare_with_long_long<std::int8_t, std::uint8_t, std::uint8_t>();
+}
+
+TEST_CASE("safe_gcd, safe_lcm and safe_midpoint, extremes of 64 bit types", "[gcd]") {
+	const auto max64u = std::numeric_limits<std::uint64_t>::max();
+	const auto max64s = std::numeric_limits<std::int64_t>::max();
+	const auto min64s = std::numeric_limits<std::int64_t>::min();
+
+	REQUIRE(safeintegralop::safe_gcd<std::uint64_t>(min64s, min64s) == std::uint64_t(1) << 63);
+	REQUIRE(!safeintegralop::safe_gcd<std::int64_t>(min64s, min64s));
+	REQUIRE(safeintegralop::safe_gcd<std::int64_t>(min64s, max64u) == 1);
+	REQUIRE(safeintegralop::safe_gcd<std::int64_t>(max64u, max64u / 3) == max64u / 3);
+	REQUIRE(safeintegralop::safe_lcm<std::uint64_t>(max64u / 3, 3) == max64u);
+	REQUIRE(!safeintegralop::safe_lcm<std::int64_t>(max64u / 3, 3));
+	REQUIRE(!safeintegralop::safe_lcm<std::uint64_t>(max64s, max64s - 1));
+	REQUIRE(safeintegralop::safe_lcm<std::uint64_t>(min64s, 2) == std::uint64_t(1) << 63);
+
+	REQUIRE(safeintegralop::safe_midpoint<std::int64_t>(min64s, max64u) == max64s / 2);
+	REQUIRE(safeintegralop::safe_midpoint<std::int64_t>(max64u, min64s) == max64s / 2 + 1);
+	REQUIRE(safeintegralop::safe_midpoint<std::uint64_t>(max64u, max64u - 1) == max64u);
+	REQUIRE(safeintegralop::safe_midpoint<std::int64_t>(min64s, min64s + 1) == min64s);
+	REQUIRE(safeintegralop::safe_midpoint<std::int64_t>(min64s + 1, min64s) == min64s + 1);
+	REQUIRE(!safeintegralop::safe_midpoint<std::int64_t>(max64u, max64u - 2));
+}
+
+TEST_CASE("safe_isqrt", "[gcd]") {
+	for(std::uint64_t x = 0; x != 1 << 20; ++x){
+		if(!is_isqrt(x, *safeintegralop::safe_isqrt<std::uint64_t>(x))){
+			FAIL("isqrt(" << x << ")");
+		}
+	}
+	// squares, and their neighbours, up to the biggest
+	for(std::uint64_t r = 1; r <= std::numeric_limits<std::uint32_t>::max(); r = r * 3 + 1){
+		for(const auto x : {r * r - 1, r * r, r * r + 1, r * r + 2 * r}){
+			REQUIRE(is_isqrt(x, *safeintegralop::safe_isqrt<std::uint64_t>(x)));
+		}
+	}
+	const auto max32u = std::numeric_limits<std::uint32_t>::max();
+	REQUIRE(safeintegralop::safe_isqrt<std::uint64_t>(std::uint64_t(max32u) * max32u) == max32u);
+	REQUIRE(safeintegralop::safe_isqrt<std::uint64_t>(std::uint64_t(max32u) * max32u - 1) == max32u - 1);
+	REQUIRE(safeintegralop::safe_isqrt<std::uint32_t>(std::numeric_limits<std::uint64_t>::max()) == max32u);
+	REQUIRE(safeintegralop::safe_isqrt<std::int32_t>(std::numeric_limits<std::int32_t>::max()) == 46340);
+	REQUIRE(!safeintegralop::safe_isqrt<std::int16_t>(std::numeric_limits<std::int32_t>::max()));
+	REQUIRE(!safeintegralop::safe_isqrt<std::uint64_t>(-1));
+}
+
+TEST_CASE("safe_gcd_reduce and safe_lcm_reduce", "[gcd]") {
+	const std::vector<int> v = {-12, 18, 30, 0};
+	REQUIRE(safeintegralop::safe_gcd_reduce<int>(v.data(), v.size()) == 6);
+	REQUIRE(safeintegralop::safe_gcd_reduce<int>(v.data(), 1) == 12);
+	REQUIRE(safeintegralop::safe_gcd_reduce<int>(v.data(), 0) == 0);
+	REQUIRE(safeintegralop::safe_lcm_reduce<int>(v.data(), 3) == 180);
+	REQUIRE(safeintegralop::safe_lcm_reduce<int>(v.data(), v.size()) == 0);
+	REQUIRE(safeintegralop::safe_lcm_reduce<int>(v.data(), 0) == 1);
+
+	std::vector<std::int64_t> primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+	REQUIRE(safeintegralop::safe_lcm_reduce<std::int64_t>(primes.data(), primes.size()) == 614889782588491410ll);
+	primes.push_back(53);
+	REQUIRE(!safeintegralop::safe_lcm_reduce<std::int64_t>(primes.data(), primes.size()));
+	REQUIRE(safeintegralop::safe_gcd_reduce<std::int64_t>(primes.data(), primes.size()) == 1);
+
+	const std::vector<std::int32_t> mins(3, std::numeric_limits<std::int32_t>::min());
+	REQUIRE(!safeintegralop::safe_gcd_reduce<std::int32_t>(mins.data(), mins.size()));
+	REQUIRE(safeintegralop::safe_lcm_reduce<std::uint32_t>(mins.data(), mins.size()) == std::uint32_t(1) << 31);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 16;
+	const auto repetitions = 100;
+
+	std::vector<std::uint64_t> make_values() {
+		std::vector<std::uint64_t> v(bigvector);
+		std::uint64_t x = 88172645463325252ull;
+		for(auto& i : v){
+			// xorshift
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+			i = x;
+		}
+		return v;
+	}
+}
+
+TEST_CASE("gcd with std::gcd", "[gcd][.]") {
+	const auto v = make_values();
+	std::uint64_t res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 1; i != v.size(); ++i){
+			res += std::gcd(v[i - 1], v[i]);
+		}
+	}
+	REQUIRE(res != 0);
+}
+
+TEST_CASE("gcd with safe_gcd", "[gcd][.]") {
+	const auto v = make_values();
+	std::uint64_t res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(std::size_t i = 1; i != v.size(); ++i){
+			res += *safeintegralop::safe_gcd<std::uint64_t>(v[i - 1], v[i]);
+		}
+	}
+	REQUIRE(res != 0);
+}
+
+TEST_CASE("isqrt with safe_isqrt", "[gcd][.]") {
+	const auto v = make_values();
+	std::uint64_t res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto x : v){
+			res += *safeintegralop::safe_isqrt<std::uint64_t>(x);
+		}
+	}
+	REQUIRE(res != 0);
+}
+#endif
@@ -0,0 +1,136 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeintegral.hpp"
+#include "../safeintegral/safeheadroom.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	const safeintegralop::headroom_entry* find_entry(const std::vector<safeintegralop::headroom_entry>& report, const std::string& site, const std::string& type) {
+		for(const auto& e : report){
+			if(e.site == site && e.type == type){
+				return &e;
+			}
+		}
+		return nullptr;
+	}
+}
+
+TEST_CASE("record_headroom", "[headroom]") {
+	safeintegralop::reset_headroom();
+	safeintegralop::record_headroom(std::int64_t(1000));
+	safeintegralop::record_headroom(std::int64_t(-3));
+	safeintegralop::record_headroom(std::int64_t(70000));
+	safeintegralop::record_headroom(std::uint16_t(200));
+
+	const auto report = safeintegralop::headroom_report();
+	const auto e = find_entry(report, "", "int64_t");
+	REQUIRE(e != nullptr);
+	REQUIRE(e->count == 3);
+	REQUIRE(e->max_positive == 70000);
+	REQUIRE(e->max_negative == 3);
+	REQUIRE(e->positive_headroom == std::uint64_t(std::numeric_limits<std::int64_t>::max()) - 70000);
+	REQUIRE(e->negative_headroom == (std::uint64_t(1) << 63) - 3);
+	REQUIRE(e->positive_bits[10] == 1); // 1000
+	REQUIRE(e->positive_bits[17] == 1); // 70000
+	REQUIRE(e->negative_bits[2] == 1);  // -3
+	REQUIRE(std::string(e->recommended) == "int32_t");
+
+	const auto u = find_entry(report, "", "uint16_t");
+	REQUIRE(u != nullptr);
+	REQUIRE(u->count == 1);
+	REQUIRE(u->negative_headroom == 0);
+	REQUIRE(std::string(u->recommended) == "uint8_t");
+
+	safeintegralop::reset_headroom();
+	REQUIRE(safeintegralop::headroom_report().empty());
+}
+
+TEST_CASE("headroom sites and threads", "[headroom]") {
+	safeintegralop::reset_headroom();
+	const safe_headroom_site quantity("quantity");
+	const safe_headroom_site price("price");
+	REQUIRE(safe_headroom_site("quantity").id() == quantity.id());
+
+	std::vector<std::thread> threads;
+	for(int t = 0; t != 4; ++t){
+		threads.emplace_back([&, t]{
+			safe_headroom_scope scope(quantity);
+			for(int i = 0; i != 1000; ++i){
+				safeintegralop::record_headroom(t * 1000 + i);
+			}
+			{
+				safe_headroom_scope inner(price);
+				safeintegralop::record_headroom(-t * 100000);
+			}
+			safeintegralop::record_headroom(1);
+		});
+	}
+	for(auto& t : threads){
+		t.join();
+	}
+	safeintegralop::record_headroom(std::numeric_limits<int>::min());
+
+	const auto report = safeintegralop::headroom_report();
+	const auto q = find_entry(report, "quantity", "int32_t");
+	REQUIRE(q != nullptr);
+	REQUIRE(q->count == 4 * 1001);
+	REQUIRE(q->max_positive == 3999);
+	REQUIRE(q->max_negative == 0);
+	REQUIRE(std::string(q->recommended) == "int16_t");
+
+	const auto p = find_entry(report, "price", "int32_t");
+	REQUIRE(p != nullptr);
+	REQUIRE(p->count == 4);
+	REQUIRE(p->max_negative == 300000);
+	REQUIRE(p->positive_bits[0] == 1);
+	REQUIRE(std::string(p->recommended) == "int32_t");
+
+	const auto untagged = find_entry(report, "", "int32_t");
+	REQUIRE(untagged != nullptr);
+	REQUIRE(untagged->count == 1);
+	REQUIRE(untagged->negative_headroom == 0);
+
+	std::ostringstream os;
+	safeintegralop::print_headroom_report(os);
+	REQUIRE(os.str().find("quantity\tint32_t\t4004\t3999\t0\t") != std::string::npos);
+	REQUIRE(os.str().find("price\tint32_t\t4\t0\t-300000\t") != std::string::npos);
+}
+
+#if defined( SAFE_INTEGRAL_PROFILE_HEADROOM )
+TEST_CASE("headroom of the operations of safe_integral", "[headroom]") {
+	safeintegralop::reset_headroom();
+	safe_longlong sum = 0;
+	for(int i = 1; i <= 100; ++i){
+		sum += i;
+	}
+	const safe_longlong product = sum * safe_longlong(-2);
+	REQUIRE(product == -10100);
+	// the comparisons, and the values calculated at compile time, are not recorded
+	constexpr safe_longlong ct = safe_longlong(1) + safe_longlong(1);
+	REQUIRE(ct == 2);
+
+	const auto report = safeintegralop::headroom_report();
+	const auto e = find_entry(report, "", "int64_t");
+	REQUIRE(e != nullptr);
+	REQUIRE(e->count == 101);
+	REQUIRE(e->max_positive == 5050);
+	REQUIRE(e->max_negative == 10100);
+	REQUIRE(std::string(e->recommended) == "int16_t");
+
+	safeintegralop::reset_headroom();
+	safe_longlong shifted = 3;
+	shifted <<= safe_longlong(20);
+	REQUIRE(shifted == 3 << 20);
+	const auto shift_report = safeintegralop::headroom_report();
+	const auto s = find_entry(shift_report, "", "int64_t");
+	REQUIRE(s != nullptr);
+	REQUIRE(s->count == 1);
+	REQUIRE(s->max_positive == 3 << 20);
+}
+#endif
@@ -0,0 +1,156 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safepacked.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace {
+	template <unsigned Bits, bool Signed>
+	void test_limits() {
+		using array = packed_safe_array<Bits, Signed>;
+		using raw_type = typename array::raw_type;
+		const std::int64_t minv = Signed ? -(std::int64_t(1) << (Bits - 1)) : 0;
+		const std::int64_t maxv = std::int64_t((std::uint64_t(1) << (Signed ? Bits - 1 : Bits)) - 1);
+		REQUIRE(std::int64_t(array::min()) == minv);
+		REQUIRE(std::int64_t(array::max()) == maxv);
+
+		// 200 values, the values straddle the words (if Bits is not a power of two)
+		array a(200);
+		REQUIRE(a.size() == 200);
+		REQUIRE(a.encoded_bytes() == (200 * Bits + 63) / 64 * 8);
+		std::vector<raw_type> raw(a.size());
+		for(std::size_t i = 0; i != raw.size(); ++i){
+			raw[i] = raw_type(i % 3 == 0 ? minv + std::int64_t(i % (Bits > 2 ? 5 : 2)) : maxv - std::int64_t(i % (Bits > 2 ? 7 : 2)));
+			a[i] = raw[i];
+		}
+		for(std::size_t i = 0; i != raw.size(); ++i){
+			REQUIRE(a[i] == raw[i]);
+		}
+
+		if(Bits < unsigned(std::numeric_limits<raw_type>::digits + (Signed ? 1 : 0))){
+			REQUIRE_THROWS_AS(a[7] = raw_type(std::uint64_t(maxv) + 1), std::out_of_range);
+			REQUIRE_THROWS_AS(a[9] = raw_type(minv - 1), std::out_of_range);
+		}
+		a[10] = raw_type(maxv);
+		REQUIRE_THROWS_AS(a[10] += 1, std::out_of_range);
+		REQUIRE_THROWS_AS(++a[10], std::out_of_range);
+		REQUIRE(a[10] == raw_type(maxv));
+		a[11] = raw_type(minv);
+		REQUIRE_THROWS_AS(a[11] -= 1, std::out_of_range);
+		REQUIRE_THROWS_AS(--a[11], std::out_of_range);
+		REQUIRE(a[11] == raw_type(minv));
+		raw[10] = raw_type(maxv);
+		raw[11] = raw_type(minv);
+		// the neighbours are not modified
+		REQUIRE(a[9] == raw[9]);
+		REQUIRE(a[12] == raw[12]);
+
+		std::vector<raw_type> out(raw.size());
+		a.unpack(0, a.size(), out.data());
+		REQUIRE(out == raw);
+
+		array b(200);
+		REQUIRE(b.pack(0, raw.data(), raw.size()) == raw.size());
+		b.unpack(0, b.size(), out.data());
+		REQUIRE(out == raw);
+		// unaligned ranges
+		std::vector<raw_type> part(37);
+		b.unpack(13, part.size(), part.data());
+		REQUIRE(std::equal(part.begin(), part.end(), raw.begin() + 13));
+		REQUIRE(b.pack(101, part.data(), part.size()) == part.size());
+		b.unpack(101, part.size(), out.data());
+		REQUIRE(std::equal(part.begin(), part.end(), out.begin()));
+		REQUIRE(b[100] == raw[100]);
+		REQUIRE(b[138] == raw[138]);
+	}
+
+	template <unsigned Bits, bool Signed>
+	void test_pack_invalid() {
+		using array = packed_safe_array<Bits, Signed>;
+		using raw_type = typename array::raw_type;
+		std::vector<raw_type> raw(5000, array::max());
+		raw[3000] = raw_type(array::max() + raw_type(1));
+		array a(raw.size());
+		REQUIRE(a.pack(0, raw.data(), raw.size()) == 3000);
+		REQUIRE(a[2999] == array::max());
+		REQUIRE(a[3000] == 0);
+		REQUIRE_THROWS_AS(a.pack(4999, raw.data(), 2), std::out_of_range);
+		REQUIRE_THROWS_AS(a.unpack(4999, 2, raw.data()), std::out_of_range);
+		REQUIRE_THROWS_AS(a.at(5000), std::out_of_range);
+	}
+}
+
+TEST_CASE("packed_safe_array limits", "[packed]") {
+	test_limits<1, false>();
+	test_limits<2, true>();
+	test_limits<5, false>();
+	test_limits<5, true>();
+	test_limits<8, false>();
+	test_limits<8, true>();
+	test_limits<12, false>();
+	test_limits<12, true>();
+	test_limits<20, false>();
+	test_limits<20, true>();
+	test_limits<33, true>();
+	test_limits<63, false>();
+}
+
+TEST_CASE("packed_safe_array 64 bits", "[packed]") {
+	packed_safe_array<64, true> s(3);
+	s[0] = std::numeric_limits<std::int64_t>::min();
+	s[1] = std::numeric_limits<std::int64_t>::max();
+	REQUIRE(s[0] == std::numeric_limits<std::int64_t>::min());
+	REQUIRE(s[1] == std::numeric_limits<std::int64_t>::max());
+	REQUIRE_THROWS_AS(s[1] += 1, std::out_of_range);
+	REQUIRE(s.encoded_bytes() == 24);
+
+	packed_safe_array<64> u(2);
+	u[1] = std::numeric_limits<std::uint64_t>::max();
+	REQUIRE(u.at(1) == std::numeric_limits<std::uint64_t>::max());
+	REQUIRE(u.at(0) == 0u);
+}
+
+TEST_CASE("packed_safe_array invalid pack", "[packed]") {
+	test_pack_invalid<5, false>();
+	test_pack_invalid<12, true>();
+	test_pack_invalid<20, false>();
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+}
+
+TEST_CASE("sum of std::vector<safe_int>", "[packed][.]") {
+	std::vector<safe_int> v(bigvector);
+	for(std::size_t i = 0; i != v.size(); ++i){
+		v[i] = int(i % 100000) - 50000;
+	}
+	safe_int sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		sum = std::accumulate(v.begin(), v.end(), safe_int(0));
+	}
+	REQUIRE(sum < 0);
+}
+
+TEST_CASE("sum of packed_safe_array<20, true>, unpacked in blocks", "[packed][.]") {
+	packed_safe_array<20, true> a(bigvector);
+	for(std::size_t i = 0; i != a.size(); ++i){
+		a[i] = int(i % 100000) - 50000;
+	}
+	INFO("encoded bytes: " << a.encoded_bytes() << " of " << a.size() * sizeof(int));
+	std::vector<std::int32_t> buffer(1024);
+	safe_int sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		sum = 0;
+		for(std::size_t i = 0; i < a.size(); i += buffer.size()){
+			a.unpack(i, buffer.size(), buffer.data());
+			sum = std::accumulate(buffer.begin(), buffer.end(), sum);
+		}
+	}
+	REQUIRE(sum < 0);
+}
@@ -0,0 +1,118 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeintegral.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+namespace {
+	// repeated multiplication of the magnitude, with a check for every step
+	template <typename T0, typename T1>
+	std::optional<T0> pow_with_mult(const T1 base, const int exp) {
+		const auto m = *safeintegralop::safe_abs<std::uint64_t>(base);
+		std::optional<std::uint64_t> res = 1;
+		for(int i = 0; i != exp && res; ++i){
+			res = safeintegralop::safe_mult<std::uint64_t>(*res, m);
+		}
+		return !res ? std::optional<T0>{} :
+		  (base < T1{0} && exp % 2 == 1) ? safeintegralop::safe_neg<T0>(*res) : safeintegralop::safe_cast<T0>(*res);
+	}
+
+	template <typename T0, typename T1>
+	void compare_with_mult(const T1 base) {
+		for(int exp = 0; exp != std::numeric_limits<T0>::digits + 3; ++exp){
+			if(safeintegralop::safe_pow<T0>(base, exp) != pow_with_mult<T0>(base, exp)){
+				FAIL(+base << "^" << exp);
+			}
+		}
+	}
+
+	template <typename T0, int E, typename T1>
+	void compare_constant_with_mult(const T1 base) {
+		if(safeintegralop::safe_pow<T0>(base, std::integral_constant<int, E>{}) != pow_with_mult<T0>(base, E)){
+			FAIL(+base << "^" << E);
+		}
+	}
+
+	template <typename T0, typename T1>
+	void compare_with_mult() {
+		for(int i = std::numeric_limits<std::int16_t>::min(); i <= std::numeric_limits<std::int16_t>::max(); ++i){
+			if(safeintegralop::in_range<T1>(i)){
+				compare_with_mult<T0>(T1(i));
+				compare_constant_with_mult<T0, 2>(T1(i));
+				compare_constant_with_mult<T0, 3>(T1(i));
+				compare_constant_with_mult<T0, 7>(T1(i));
+			}
+		}
+		for(int i = 0; i != 3; ++i){
+			compare_with_mult<T0>(T1(std::numeric_limits<T1>::max() - i));
+			compare_with_mult<T0>(T1(std::numeric_limits<T1>::min() + i));
+		}
+	}
+}
+
+TEST_CASE("safe_pow, same results of repeated safe_mult", "[pow]") {
+	compare_with_mult<std::int8_t, std::int8_t>();
+	compare_with_mult<std::uint8_t, std::int16_t>();
+	compare_with_mult<std::int16_t, std::int16_t>();
+	compare_with_mult<std::int32_t, std::int32_t>();
+	compare_with_mult<std::uint32_t, std::int64_t>();
+	compare_with_mult<std::int64_t, std::int64_t>();
+	compare_with_mult<std::uint64_t, std::uint64_t>();
+	compare_with_mult<std::int64_t, std::uint64_t>();
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 16;
+	const auto repetitions = 200;
+
+	std::vector<int> make_bases() {
+		std::vector<int> v(bigvector);
+		for(std::size_t i = 0; i != v.size(); ++i){
+			v[i] = int(i * 2654435761u % 1001);
+		}
+		return v;
+	}
+}
+
+TEST_CASE("pow with safe_integral", "[pow][.]") {
+	const auto bases = make_bases();
+	long long res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto base : bases){
+			safe_longlong p = 1;
+			for(int j = 0; j != 6; ++j){
+				p *= safe_longlong(base);
+			}
+			res ^= p.getvalue();
+		}
+	}
+	REQUIRE(res == 0);
+}
+
+TEST_CASE("pow with safe_pow", "[pow][.]") {
+	const auto bases = make_bases();
+	const int exp = bases[0] + 6; // bases[0] == 0, not known at compile time
+	long long res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto base : bases){
+			res ^= *safeintegralop::safe_pow<long long>(base, exp);
+		}
+	}
+	REQUIRE(res == 0);
+}
+
+TEST_CASE("pow with safe_pow and a constant exponent", "[pow][.]") {
+	const auto bases = make_bases();
+	long long res = 0;
+	for(int r = 0; r != repetitions; ++r){
+		for(const auto base : bases){
+			res ^= *safeintegralop::safe_pow<long long>(base, std::integral_constant<int, 6>{});
+		}
+	}
+	REQUIRE(res == 0);
+}
+#endif
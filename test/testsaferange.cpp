@@ -0,0 +1,154 @@
+#include "catch.hpp"
+
+#include "../safeintegral/saferange.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#if  __cplusplus > 201703L // compiling with c++20 or greater
+#include <ranges>
+#endif
+#include <type_traits>
+#include <vector>
+
+namespace {
+	// reference implementation, with a wider type
+	template <typename T>
+	std::vector<safe_integral<T>> iota_with_step(const T begin, const T end, const T step) {
+		std::vector<safe_integral<T>> v;
+		for(long long i = begin; step > 0 ? i < end : i > end; i += step){
+			v.push_back(static_cast<T>(i));
+		}
+		return v;
+	}
+
+	template <typename T>
+	void compare_with_loop(const T begin, const T end, const T step) {
+		const auto r = safe_range<T>(begin, end, step);
+		const auto expected = iota_with_step(begin, end, step);
+		REQUIRE(r.size() == expected.size());
+		REQUIRE(std::equal(r.begin(), r.end(), expected.begin()));
+	}
+}
+
+TEST_CASE("safe_range, same values of loop", "[range]") {
+	compare_with_loop<int>(0, 10, 1);
+	compare_with_loop<int>(0, 10, 3);
+	compare_with_loop<int>(10, 0, -3);
+	compare_with_loop<int>(-5, 5, 2);
+	compare_with_loop<int>(5, 5, 1);
+	compare_with_loop<int>(5, 0, 1);
+	compare_with_loop<int>(0, 5, -1);
+	compare_with_loop<signed char>(-128, 127, 17);
+	compare_with_loop<signed char>(127, -128, -1);
+	compare_with_loop<unsigned char>(0, 255, 2);
+	compare_with_loop<unsigned short>(0, 65535, 65535);
+	compare_with_loop<unsigned short>(65535, 0, 1);
+	compare_with_loop<short>(-32768, 32767, 1000);
+}
+
+TEST_CASE("safe_range, limits", "[range]") {
+	const auto max = std::numeric_limits<int>::max();
+	const auto min = std::numeric_limits<int>::min();
+
+	// the past-the-end value max+1 is never computed
+	const auto up = safe_range<int>(max - 3, max);
+	REQUIRE(up.size() == 3);
+	REQUIRE(*(up.end() - 1) == max - 1);
+
+	const auto down = safe_range<int>(min + 3, min, -1);
+	REQUIRE(down.size() == 3);
+	REQUIRE(down[2] == min + 1);
+
+	const auto all = safe_range<int>(min, max, max);
+	REQUIRE(all.size() == 3);
+	REQUIRE(all[0] == min);
+	REQUIRE(all[1] == -1);
+	REQUIRE(all[2] == max - 1);
+
+	const auto big_step = safe_range<int>(min, max, min);
+	REQUIRE(big_step.empty());
+	const auto big_step_down = safe_range<int>(max, min, min);
+	REQUIRE(big_step_down.size() == 2);
+	REQUIRE(big_step_down[1] == -1);
+
+	const auto umax = std::numeric_limits<unsigned long long>::max();
+	const auto uall = safe_range<unsigned long long>(0, umax, umax / 3);
+	REQUIRE(uall.size() == 3);
+	REQUIRE(uall[2] == umax / 3 * 2);
+}
+
+TEST_CASE("safe_range, invalid ranges", "[range][negative]") {
+	REQUIRE_THROWS_AS(safe_range<int>(0, 10, 0), std::out_of_range);
+	REQUIRE_THROWS_AS(make_safe_range(safe_int(0), safe_int(10), safe_int(0)), std::out_of_range);
+	if(sizeof(long long) == sizeof(std::ptrdiff_t)){
+		REQUIRE_THROWS_AS(safe_range<unsigned long long>(0, std::numeric_limits<unsigned long long>::max()), std::out_of_range);
+	}
+}
+
+TEST_CASE("safe_range, standard algorithms", "[range]") {
+	const auto r = make_safe_range(safe_int(1), safe_int(101));
+	REQUIRE(std::distance(r.begin(), r.end()) == 100);
+	REQUIRE(std::accumulate(r.begin(), r.end(), safe_int(0)) == 5050);
+	REQUIRE(*std::find(r.begin(), r.end(), 42) == 42);
+	REQUIRE(std::count_if(r.begin(), r.end(), [](const safe_int i){ return i % 2 == 0; }) == 50);
+
+	std::vector<safe_int> v(r.begin(), r.end());
+	REQUIRE(v.size() == 100);
+	REQUIRE(v.back() == 100);
+#if  __cplusplus > 201703L // compiling with c++20 or greater
+	// the algorithms that need forward or bidirectional iterators are used through std::ranges
+	REQUIRE(std::ranges::lower_bound(r, 50) - r.begin() == 49);
+	const auto reversed = r | std::views::reverse;
+	REQUIRE(*reversed.begin() == 100);
+#endif
+
+	int sum = 0;
+	for(const auto i : safe_range<int>(10, 0, -2)){
+		sum += i.getvalue();
+	}
+	REQUIRE(sum == 30);
+}
+
+TEST_CASE("safe_range, iterator category", "[range]") {
+	// operator* returns a value
+	static_assert(std::is_same<std::iterator_traits<safe_range<int>::iterator>::iterator_category, std::input_iterator_tag>::value, "");
+#if  __cplusplus > 201703L // compiling with c++20 or greater
+	static_assert(std::random_access_iterator<safe_range<int>::iterator>, "");
+	static_assert(std::ranges::random_access_range<safe_range<int>>, "");
+#endif
+	const safe_range<int> r(0, 10);
+	auto it = r.begin();
+	it += 3;
+	REQUIRE(it[2] == 5);
+	REQUIRE(r.end() - it == 7);
+}
+
+// Simple profiling test
+namespace {
+	const auto bigvector = 30000;
+	const auto repetitions = 20000;
+}
+
+TEST_CASE("loop with safe_int", "[range][.]") {
+	std::vector<int> out(bigvector/3 + 1);
+	for(int r = 0; r != repetitions; ++r){
+		std::size_t j = 0;
+		for(safe_int i = r; i < bigvector; i += 3){
+			out[j++] += i.getvalue();
+		}
+	}
+	REQUIRE(out[1] == repetitions * (repetitions - 1) / 2 + 3 * repetitions);
+}
+
+TEST_CASE("loop with safe_range", "[range][.]") {
+	std::vector<int> out(bigvector/3 + 1);
+	for(int r = 0; r != repetitions; ++r){
+		std::size_t j = 0;
+		for(const auto i : safe_range<int>(r, bigvector, 3)){
+			out[j++] += i.getvalue();
+		}
+	}
+	REQUIRE(out[1] == repetitions * (repetitions - 1) / 2 + 3 * repetitions);
+}
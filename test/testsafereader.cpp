@@ -0,0 +1,191 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safereader.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+	void put_le(std::vector<unsigned char>& v, const std::uint64_t x, const std::size_t bytes) {
+		for(std::size_t i = 0; i != bytes; ++i){
+			v.push_back(static_cast<unsigned char>(x >> (8 * i)));
+		}
+	}
+
+	void put_be(std::vector<unsigned char>& v, const std::uint64_t x, const std::size_t bytes) {
+		for(std::size_t i = bytes; i != 0; --i){
+			v.push_back(static_cast<unsigned char>(x >> (8 * (i - 1))));
+		}
+	}
+}
+
+TEST_CASE("safe_reader fields", "[reader]") {
+	std::vector<unsigned char> data;
+	put_le(data, 0x1234, 2);
+	put_be(data, 0x1234, 2);
+	put_le(data, std::uint32_t(-5), 4);
+	put_be(data, 0x0102030405060708ull, 8);
+	data.push_back(0xFF);
+
+	safe_reader r(data.data(), data.size());
+	REQUIRE(r.size() == 17);
+	REQUIRE(r.read_le<std::uint16_t>() == 0x1234);
+	REQUIRE(r.read_be<std::uint16_t>() == 0x1234);
+	REQUIRE(r.read_le<std::int32_t>() == -5);
+	REQUIRE(r.read_be<std::uint64_t>() == 0x0102030405060708ull);
+	REQUIRE(r.position() == 16);
+	REQUIRE(r.remaining() == 1);
+	REQUIRE_THROWS_AS(r.read_le<std::uint16_t>(), std::out_of_range);
+	REQUIRE(r.position() == 16);
+	REQUIRE(r.read_le<std::int8_t>() == -1);
+	REQUIRE_THROWS_AS(r.read_le<std::uint8_t>(), std::out_of_range);
+
+	r.seek(safe_int(4));
+	REQUIRE(r.read_le<std::int32_t>() == -5);
+	r.seek(safe_integral<std::size_t>(17));
+	REQUIRE_THROWS_AS(r.seek(safe_int(18)), std::out_of_range);
+	REQUIRE_THROWS_AS(r.seek(safe_int(-1)), std::out_of_range);
+	r.seek(safe_int(0));
+	r.skip(safe_int(2));
+	REQUIRE(r.read_bytes(safe_int(2))[1] == 0x34);
+	REQUIRE_THROWS_AS(r.skip(safe_integral<std::size_t>(std::numeric_limits<std::size_t>::max())), std::out_of_range);
+	REQUIRE(r.position() == 4);
+}
+
+TEST_CASE("safe_reader arrays, records and subreaders", "[reader]") {
+	std::vector<unsigned char> data;
+	for(std::uint32_t i = 0; i != 100; ++i){
+		put_le(data, i * 1000, 4);
+	}
+	for(std::uint32_t i = 0; i != 10; ++i){
+		put_be(data, i, 2);
+		put_le(data, std::uint64_t(-std::int64_t(i)), 8);
+	}
+
+	safe_reader r(data.data(), data.size());
+	std::vector<std::uint32_t> raw(100);
+	r.read_array_le<std::uint32_t>(raw.data(), safe_int(100));
+	REQUIRE(raw[99] == 99000);
+	r.seek(safe_int(0));
+	std::vector<safe_integral<std::uint32_t>> safe_values(100);
+	r.read_array_le<std::uint32_t>(safe_values.data(), safe_int(100));
+	REQUIRE(safe_values[42] == 42000);
+
+	std::vector<std::uint16_t> be(10);
+	const auto records = r.read_records(safe_int(10), 10);
+	REQUIRE(r.remaining() == 0);
+	REQUIRE(records.size() == 10);
+	REQUIRE(records.be<std::uint16_t>(3, 0) == 3);
+	REQUIRE(records.le<std::int64_t>(3, 2) == -3);
+	std::vector<safe_integral<std::int64_t>> column(10);
+	records.column_le<std::int64_t>(2, column.data());
+	REQUIRE(column[9] == -9);
+	records.column_be<std::uint16_t>(0, be.data());
+	REQUIRE(be[7] == 7);
+	REQUIRE_THROWS_AS(records.column_le<std::int64_t>(3, column.data()), std::out_of_range);
+
+	r.seek(safe_int(0));
+	// the size of the array (count * 4 bytes) overflows, or is bigger than the buffer
+	REQUIRE_THROWS_AS(r.read_array_le<std::uint32_t>(raw.data(), safe_integral<std::size_t>(std::numeric_limits<std::size_t>::max() / 2)), std::out_of_range);
+	std::vector<std::uint32_t> too_big(131);
+	REQUIRE_THROWS_AS(r.read_array_le<std::uint32_t>(too_big.data(), safe_int(131)), std::out_of_range);
+	REQUIRE_THROWS_AS(r.read_records(safe_int(-1), 10), std::out_of_range);
+	REQUIRE(r.position() == 0);
+
+	auto sub = r.subreader(safe_int(400), safe_int(10));
+	REQUIRE(sub.size() == 10);
+	REQUIRE(sub.read_be<std::uint16_t>() == 0);
+	REQUIRE(sub.read_le<std::int64_t>() == 0);
+	REQUIRE_THROWS_AS(sub.read_le<std::uint8_t>(), std::out_of_range);
+	REQUIRE_THROWS_AS(r.subreader(safe_int(400), safe_int(101)), std::out_of_range);
+	REQUIRE_THROWS_AS(r.subreader(safe_integral<std::size_t>(1), safe_integral<std::size_t>(std::numeric_limits<std::size_t>::max())), std::out_of_range);
+}
+
+TEST_CASE("validate_extents", "[reader]") {
+	std::vector<std::int64_t> offsets(5000);
+	std::vector<std::int64_t> sizes(5000);
+	for(std::size_t i = 0; i != offsets.size(); ++i){
+		offsets[i] = std::int64_t(i * 10);
+		sizes[i] = 10;
+	}
+	REQUIRE(safeintegralop::validate_extents(offsets.data(), sizes.data(), offsets.size(), std::int64_t(50000)) == offsets.size());
+	REQUIRE(safeintegralop::validate_extents(offsets.data(), sizes.data(), offsets.size(), std::int64_t(49999)) == 4999);
+	sizes[3000] = -1;
+	REQUIRE(safeintegralop::validate_extents(offsets.data(), sizes.data(), offsets.size(), std::int64_t(50000)) == 3000);
+	sizes[3000] = 10;
+	offsets[2500] = std::numeric_limits<std::int64_t>::max();
+	REQUIRE(safeintegralop::validate_extents(offsets.data(), sizes.data(), offsets.size(), std::numeric_limits<std::int64_t>::max()) == 2500);
+
+	const std::uint32_t uoffsets[] = {0, 100, std::numeric_limits<std::uint32_t>::max()};
+	const std::uint32_t usizes[] = {100, 100, 1};
+	REQUIRE(safeintegralop::validate_extents(uoffsets, usizes, 3, std::numeric_limits<std::uint32_t>::max()) == 2);
+}
+
+TEST_CASE("safe_mapped_file", "[reader]") {
+	const char* path = "testsafereader.bin";
+	{
+		std::ofstream out(path, std::ios::binary);
+		const unsigned char content[] = {4, 0, 0, 0, 0xAA, 0xBB, 0xCC, 0xDD};
+		out.write(reinterpret_cast<const char*>(content), sizeof(content));
+	}
+	{
+		const safe_mapped_file f(path);
+		REQUIRE(f.size() == 8);
+		safe_reader r(f);
+		const auto n = r.read_le<std::uint32_t>();
+		REQUIRE(r.read_bytes(n)[3] == 0xDD);
+		REQUIRE(r.remaining() == 0);
+	}
+	std::remove(path);
+	REQUIRE_THROWS_AS(safe_mapped_file(path), std::runtime_error);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t records = 1 << 20;
+	const std::size_t record_size = 16;
+	const auto repetitions = 100;
+
+	std::vector<unsigned char> make_records() {
+		std::vector<unsigned char> data;
+		for(std::size_t i = 0; i != records; ++i){
+			put_le(data, i, 8);
+			put_le(data, i % 1000, 4);
+			put_le(data, 0, 4);
+		}
+		return data;
+	}
+}
+
+TEST_CASE("sum of fields read one by one", "[reader][.]") {
+	const auto data = make_records();
+	safe_longlong sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		safe_reader reader(data.data(), data.size());
+		sum = 0;
+		for(std::size_t i = 0; i != records; ++i){
+			reader.skip(safe_int(8));
+			sum += reader.read_le<std::int32_t>().getvalue();
+			reader.skip(safe_int(4));
+		}
+	}
+	REQUIRE(sum > 0);
+}
+
+TEST_CASE("sum of fields of a record batch", "[reader][.]") {
+	const auto data = make_records();
+	safe_longlong sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		safe_reader reader(data.data(), data.size());
+		const auto batch = reader.read_records(safe_integral<std::size_t>(records), record_size);
+		long long s = 0;
+		for(std::size_t i = 0; i != batch.size(); ++i){
+			s += batch.le<std::int32_t>(i, 8);
+		}
+		sum = s;
+	}
+	REQUIRE(sum > 0);
+}
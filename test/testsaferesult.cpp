@@ -0,0 +1,121 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safeintegralop.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// available since c++11, in constant expressions too
+static_assert(safeintegralop::safe_add_result<std::int8_t>(100, 27).value == 127, "");
+static_assert(!safeintegralop::safe_add_result<std::int8_t>(100, 28), "");
+static_assert(!safeintegralop::safe_diff_result<unsigned>(0u, 1u), "");
+static_assert(safeintegralop::safe_mult_result<int>(-3, 7u).value == -21, "");
+static_assert(safeintegralop::safe_mult_result<int>(-65536, 32768).value == std::numeric_limits<int>::min(), "");
+static_assert(safeintegralop::safe_div_result<int>(7, std::integral_constant<int, 2>{}).value == 3, "");
+static_assert(safeintegralop::safe_cast_result<std::uint8_t>(-1).value_or(42) == 42, "");
+static_assert(std::is_trivially_copyable<safeintegralop::safe_result<long long>>::value, "");
+
+namespace {
+	// reference result with int arithmetic, for all values of 8 bits
+	template <typename T0>
+	safeintegralop::safe_result<T0> reference(const int r) {
+		return safeintegralop::in_range<T0>(r) ? safeintegralop::safe_result<T0>(T0(r)) : safeintegralop::safe_result<T0>();
+	}
+
+	template <typename T0>
+	void require_equal(const safeintegralop::safe_result<T0> res, const safeintegralop::safe_result<T0> expected) {
+		REQUIRE(res.ok == expected.ok);
+		if(expected.ok){
+			REQUIRE(res.value == expected.value);
+		}
+	}
+
+	template <typename T0, typename T1, typename T2>
+	void check_all_values() {
+		for(int a = std::numeric_limits<T1>::min(); a <= std::numeric_limits<T1>::max(); ++a){
+			for(int b = std::numeric_limits<T2>::min(); b <= std::numeric_limits<T2>::max(); ++b){
+				const T1 x = T1(a);
+				const T2 y = T2(b);
+				require_equal(safeintegralop::safe_add_result<T0>(x, y), reference<T0>(a + b));
+				require_equal(safeintegralop::safe_diff_result<T0>(x, y), reference<T0>(a - b));
+				require_equal(safeintegralop::safe_mult_result<T0>(x, y), reference<T0>(a * b));
+				require_equal(safeintegralop::safe_div_result<T0>(x, y), b == 0 ? safeintegralop::safe_result<T0>() : reference<T0>(a / b));
+				require_equal(safeintegralop::safe_mod_result<T0>(x, y), b == 0 ? safeintegralop::safe_result<T0>() : reference<T0>(a % b));
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+				const auto opt = safeintegralop::safe_mult<T0>(x, y);
+				REQUIRE(opt.has_value() == safeintegralop::safe_mult_result<T0>(x, y).ok);
+#endif
+			}
+			require_equal(safeintegralop::safe_neg_result<T0>(T1(a)), reference<T0>(-a));
+			require_equal(safeintegralop::safe_abs_result<T0>(T1(a)), reference<T0>(a < 0 ? -a : a));
+			require_equal(safeintegralop::safe_cast_result<T0>(T1(a)), reference<T0>(a));
+		}
+	}
+}
+
+TEST_CASE("safe_result of all values of 8 bits", "[result]") {
+	check_all_values<std::int8_t, std::int8_t, std::int8_t>();
+	check_all_values<std::int8_t, std::uint8_t, std::int8_t>();
+	check_all_values<std::uint8_t, std::int8_t, std::uint8_t>();
+	check_all_values<std::int16_t, std::int8_t, std::uint8_t>();
+}
+
+TEST_CASE("safe_result of shifts", "[result]") {
+	REQUIRE(safeintegralop::safe_shl_result<int>(-3, 4).value == -48);
+	REQUIRE(!safeintegralop::safe_shl_result<int>(1, 31));
+	REQUIRE(safeintegralop::safe_shl_result<unsigned>(1, 31).value == 0x80000000u);
+	REQUIRE(!safeintegralop::safe_shl_result<int>(1, -1));
+	REQUIRE(safeintegralop::safe_shr_result<int>(-5, 1).value == -3);
+	REQUIRE(safeintegralop::safe_shr_result<short>(std::numeric_limits<long long>::min(), 100).value == -1);
+	REQUIRE(safeintegralop::safe_mod_result<short>(123456789LL, std::integral_constant<int, 60>{}).value == 9);
+
+	std::int64_t res = 0;
+	if(const auto r = safeintegralop::safe_mult_result<std::int64_t>(std::int64_t(1) << 40, 1 << 20)){
+		res = r.value;
+	}
+	REQUIRE(res == std::int64_t(1) << 60);
+}
+
+TEST_CASE("safe_result of products equal to min", "[result]") {
+	const auto int_min = std::numeric_limits<int>::min();
+	const auto llong_min = std::numeric_limits<long long>::min();
+	REQUIRE(safeintegralop::safe_mult_result<int>(-65536, 32768).value == int_min);
+	REQUIRE(safeintegralop::safe_mult_result<int>(65536, -32768).value == int_min);
+	REQUIRE(safeintegralop::safe_mult_result<int>(int_min, 1).value == int_min);
+	REQUIRE(safeintegralop::safe_mult_result<int>(1u, int_min).value == int_min);
+	REQUIRE(!safeintegralop::safe_mult_result<int>(int_min, -1));
+	REQUIRE(!safeintegralop::safe_mult_result<int>(-65536, 32769));
+	REQUIRE(safeintegralop::safe_mult_result<int>(0, -5).value == 0);
+	REQUIRE(safeintegralop::safe_mult_result<long long>(-4294967296LL, 2147483648LL).value == llong_min);
+	REQUIRE(safeintegralop::safe_mult_result<long long>(llong_min, 1).value == llong_min);
+	REQUIRE(safeintegralop::safe_mult_result<long long>(2LL, llong_min / 2).value == llong_min);
+	REQUIRE(!safeintegralop::safe_mult_result<long long>(-4294967296LL, 2147483649LL));
+#if  __cplusplus > 201402L // compiling with c++17 or greater
+	REQUIRE(safeintegralop::safe_mult<int>(-65536, 32768) == int_min);
+	REQUIRE(safeintegralop::safe_mult<long long>(-4294967296LL, 2147483648LL) == llong_min);
+#endif
+}
+
+TEST_CASE("safe_result of differences equal to min", "[result]") {
+	const auto int_min = std::numeric_limits<int>::min();
+	const auto llong_min = std::numeric_limits<long long>::min();
+	REQUIRE(safeintegralop::safe_diff_result<int>(-1, 2147483647u).value == int_min);
+	REQUIRE(safeintegralop::safe_diff_result<int>(int_min, 0u).value == int_min);
+	REQUIRE(!safeintegralop::safe_diff_result<int>(-1, 2147483648u));
+	REQUIRE(safeintegralop::safe_diff_result<long long>(-1LL, 9223372036854775807ULL).value == llong_min);
+	REQUIRE(!safeintegralop::safe_diff_result<long long>(-2LL, 9223372036854775807ULL));
+}
+
+#if  __cplusplus >= 201402L // compiling with c++14 or greater
+TEST_CASE("safe_result of gcd, lcm, midpoint and isqrt", "[result]") {
+	REQUIRE(safeintegralop::safe_gcd_result<int>(-12, 18u).value == 6);
+	REQUIRE(!safeintegralop::safe_gcd_result<int>(std::numeric_limits<int>::min(), 0));
+	REQUIRE(!safeintegralop::safe_lcm_result<int>(65536, 65535));
+	REQUIRE(safeintegralop::safe_midpoint_result<int>(std::numeric_limits<int>::max(), std::numeric_limits<int>::max() - 2).value == std::numeric_limits<int>::max() - 1);
+	REQUIRE(safeintegralop::safe_isqrt_result<long long>(std::numeric_limits<long long>::max()).value == 3037000499);
+	const int values[] = {12, 18, 30};
+	REQUIRE(safeintegralop::safe_gcd_reduce_result<int>(values, 3).value == 6);
+	REQUIRE(safeintegralop::safe_lcm_reduce_result<int>(values, 3).value == 180);
+}
+#endif
@@ -0,0 +1,183 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safescan.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+	// running sum with a check for every value
+	template <typename T>
+	std::size_t reference_scan(const std::vector<T>& values, std::vector<T>& out, T sum, const bool exclusive) {
+		for(std::size_t i = 0; i != values.size(); ++i){
+			if(!safeintegralop::is_safe_add(sum, values[i])){
+				return i;
+			}
+			if(exclusive) out[i] = sum;
+			sum = static_cast<T>(sum + values[i]);
+			if(!exclusive) out[i] = sum;
+		}
+		return values.size();
+	}
+
+	// values in [lo, hi], with a big value at position spike
+	template <typename T>
+	std::vector<T> make_values(const std::size_t count, const T lo, const T hi, const std::size_t spike, const T spike_value) {
+		std::vector<T> values(count);
+		std::uint64_t state = 42;
+		const auto range = std::uint64_t(std::int64_t(hi) - std::int64_t(lo)) + 1;
+		for(auto& v : values){
+			state = state * 6364136223846793005u + 1442695040888963407u;
+			v = static_cast<T>(std::int64_t(lo) + std::int64_t((state >> 33) % range));
+		}
+		if(spike < count){
+			values[spike] = spike_value;
+		}
+		return values;
+	}
+
+	template <typename T>
+	void compare_with_reference(const std::vector<T>& values, const T init) {
+		const auto count = values.size();
+		for(const bool exclusive : {false, true}){
+			std::vector<T> expected(count), out(count);
+			const auto expected_index = reference_scan(values, expected, init, exclusive);
+			const auto index = exclusive ? safeintegralop::safe_exclusive_scan(values.data(), count, out.data(), init) :
+			                               safeintegralop::safe_inclusive_scan(values.data(), count, out.data(), init);
+			REQUIRE(index == expected_index);
+			REQUIRE(std::equal(out.begin(), out.begin() + std::ptrdiff_t(index), expected.begin()));
+
+			std::vector<T> pout(count);
+			const auto pindex = exclusive ? safeintegralop::safe_exclusive_scan_parallel(values.data(), count, pout.data(), init, 4) :
+			                                safeintegralop::safe_inclusive_scan_parallel(values.data(), count, pout.data(), init, 4);
+			REQUIRE(pindex == expected_index);
+			REQUIRE(std::equal(pout.begin(), pout.begin() + std::ptrdiff_t(pindex), expected.begin()));
+		}
+	}
+
+	template <typename T>
+	void compare_with_reference(const T lo, const T hi) {
+		const std::size_t count = std::size_t(1) << 19;
+		const T max = std::numeric_limits<T>::max();
+		const T min = std::numeric_limits<T>::min();
+		compare_with_reference(make_values<T>(100, lo, hi, 100, T{0}), T{0});
+		compare_with_reference(make_values<T>(count, lo, hi, count, T{0}), T{0});
+		// overflow in the first, middle, and last chunk
+		compare_with_reference(make_values<T>(count, lo, hi, 10, max), max);
+		compare_with_reference(make_values<T>(count, lo, hi, count / 2 + 5, max), T{0});
+		compare_with_reference(make_values<T>(count, lo, hi, count / 2 + 5, min), T{0});
+		compare_with_reference(make_values<T>(count, lo, hi, count - 1, max), T{0});
+		// overflow of a chunk sum, but not of the running sum
+		auto values = make_values<T>(count, T{0}, T{0}, 0, max);
+		values[1] = max;
+		compare_with_reference(values, min);
+	}
+}
+
+TEST_CASE("safe_inclusive_scan, same results of checked loop", "[scan]") {
+	compare_with_reference<std::int8_t>(-1, 1);
+	compare_with_reference<std::uint8_t>(0, 0);
+	compare_with_reference<std::int16_t>(0, 1);
+	compare_with_reference<std::int32_t>(-100, 100);
+	compare_with_reference<std::uint32_t>(0, 4000);
+	compare_with_reference<std::int64_t>(-1000000, 1000000);
+	compare_with_reference<std::uint64_t>(0, 1000000);
+}
+
+TEST_CASE("safe_inclusive_scan", "[scan]") {
+	const std::vector<int> sizes = {1, 2, 3, 4};
+	std::vector<int> offsets(sizes.size());
+	REQUIRE(safeintegralop::safe_inclusive_scan(sizes.data(), sizes.size(), offsets.data()) == 4);
+	REQUIRE(offsets == std::vector<int>({1, 3, 6, 10}));
+	REQUIRE(safeintegralop::safe_exclusive_scan(sizes.data(), sizes.size(), offsets.data(), 10) == 4);
+	REQUIRE(offsets == std::vector<int>({10, 11, 13, 16}));
+
+	std::vector<int> values = {1, std::numeric_limits<int>::max(), 1};
+	REQUIRE(safeintegralop::safe_inclusive_scan(values.data(), values.size(), values.data()) == 1);
+	REQUIRE(values[0] == 1);
+	REQUIRE(values[1] == std::numeric_limits<int>::max());
+
+	std::vector<safe_int> svalues = {1, 2, std::numeric_limits<int>::max()};
+	safeintegralop::safe_inclusive_scan(svalues.data(), 2, svalues.data());
+	REQUIRE(svalues[1] == 3);
+	REQUIRE_THROWS_AS(safeintegralop::safe_exclusive_scan(svalues.data(), svalues.size(), svalues.data(), 1), std::out_of_range);
+}
+
+TEST_CASE("safe_inclusive_scan with another type of the running sum", "[scan]") {
+	// offsets of 64 bits of sizes of 32 bits, the sum does not fit in 32 bits
+	const std::size_t count = std::size_t(1) << 17;
+	const std::vector<std::uint32_t> sizes(count, 100000);
+	std::vector<std::uint64_t> offsets(count);
+	REQUIRE(safeintegralop::safe_inclusive_scan(sizes.data(), count, offsets.data()) == count);
+	REQUIRE(offsets.back() == std::uint64_t(count) * 100000);
+	REQUIRE(safeintegralop::safe_exclusive_scan(sizes.data(), count, offsets.data(), 7) == count);
+	REQUIRE(offsets[0] == 7);
+	REQUIRE(offsets.back() == std::uint64_t(count - 1) * 100000 + 7);
+	std::vector<std::uint64_t> poffsets(count);
+	REQUIRE(safeintegralop::safe_inclusive_scan_parallel(sizes.data(), count, poffsets.data(), 0, 4) == count);
+	REQUIRE(poffsets.back() == std::uint64_t(count) * 100000);
+	REQUIRE(safeintegralop::safe_exclusive_scan_parallel(sizes.data(), count, poffsets.data(), 7, 4) == count);
+	REQUIRE(poffsets == offsets);
+
+	// the same sizes with offsets of 32 bits: the index where the running sum leaves std::uint32_t
+	std::vector<std::uint32_t> offsets32(count);
+	const std::size_t fits = std::numeric_limits<std::uint32_t>::max() / 100000;
+	REQUIRE(safeintegralop::safe_inclusive_scan(sizes.data(), count, offsets32.data()) == fits);
+	REQUIRE(safeintegralop::safe_inclusive_scan_parallel(sizes.data(), count, offsets32.data(), 0, 4) == fits);
+
+	// values that are not representable by the type of the sum
+	std::vector<std::int32_t> values(count, 1);
+	values[5000] = -1;
+	std::vector<std::uint64_t> out(count);
+	REQUIRE(safeintegralop::safe_inclusive_scan(values.data(), count, out.data()) == 5000);
+	REQUIRE(out[4999] == 5000);
+	REQUIRE(safeintegralop::safe_inclusive_scan(values.data(), count, out.data(), 10) == 5000);
+	REQUIRE(safeintegralop::safe_exclusive_scan_parallel(values.data(), count, out.data(), 10, 4) == 5000);
+	std::vector<std::int64_t> wide(100, 1);
+	wide[50] = std::int64_t(1) << 40;
+	std::vector<std::int32_t> narrow(wide.size());
+	REQUIRE(safeintegralop::safe_exclusive_scan(wide.data(), wide.size(), narrow.data()) == 50);
+	REQUIRE(narrow[49] == 49);
+	wide[50] = -1;
+	REQUIRE(safeintegralop::safe_exclusive_scan(wide.data(), wide.size(), narrow.data()) == wide.size());
+	REQUIRE(narrow[99] == 97);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = std::size_t(1) << 24;
+	const auto repetitions = 10;
+}
+
+TEST_CASE("prefix sum with safe_int", "[scan][.]") {
+	const std::vector<safe_int> sizes(bigvector, 3);
+	std::vector<safe_int> offsets(bigvector);
+	for(int r = 0; r != repetitions; ++r){
+		safe_int sum = r;
+		for(std::size_t i = 0; i != sizes.size(); ++i){
+			sum += sizes[i];
+			offsets[i] = sum;
+		}
+	}
+	REQUIRE(offsets.back() == static_cast<int>(3 * bigvector + repetitions - 1));
+}
+
+TEST_CASE("prefix sum with safe_inclusive_scan", "[scan][.]") {
+	const std::vector<int> sizes(bigvector, 3);
+	std::vector<int> offsets(bigvector);
+	for(int r = 0; r != repetitions; ++r){
+		safeintegralop::safe_inclusive_scan(sizes.data(), sizes.size(), offsets.data(), r);
+	}
+	REQUIRE(offsets.back() == static_cast<int>(3 * bigvector + repetitions - 1));
+}
+
+TEST_CASE("prefix sum with safe_inclusive_scan_parallel", "[scan][.]") {
+	const std::vector<int> sizes(bigvector, 3);
+	std::vector<int> offsets(bigvector);
+	for(int r = 0; r != repetitions; ++r){
+		safeintegralop::safe_inclusive_scan_parallel(sizes.data(), sizes.size(), offsets.data(), r);
+	}
+	REQUIRE(offsets.back() == static_cast<int>(3 * bigvector + repetitions - 1));
+}
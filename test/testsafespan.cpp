@@ -0,0 +1,121 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safespan.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+static_assert(safeintegralop::is_layout_compatible_safe_integral<std::int8_t>::value, "");
+static_assert(safeintegralop::is_layout_compatible_safe_integral<std::uint16_t>::value, "");
+static_assert(safeintegralop::is_layout_compatible_safe_integral<std::int32_t>::value, "");
+static_assert(safeintegralop::is_layout_compatible_safe_integral<std::uint64_t>::value, "");
+
+TEST_CASE("safe_span over a raw buffer", "[span]") {
+	std::vector<std::int32_t> raw = {1, 2, 3, std::numeric_limits<std::int32_t>::max()};
+	safe_span<std::int32_t> s(raw.data(), raw.size());
+	REQUIRE(s.size() == 4);
+	REQUIRE(!s.empty());
+	REQUIRE(s.data() == raw.data());
+
+	s[0] += 41;
+	REQUIRE(raw[0] == 42);
+	REQUIRE(s[0] == 42);
+	s[1] = s[2];
+	REQUIRE(raw[1] == 3);
+	++s[2];
+	REQUIRE(raw[2] == 4);
+
+	// the element is not modified if the operation fails
+	REQUIRE_THROWS_AS(s[3] += 1, std::out_of_range);
+	REQUIRE(raw[3] == std::numeric_limits<std::int32_t>::max());
+	REQUIRE_THROWS_AS(++s[3], std::out_of_range);
+	REQUIRE_THROWS_AS(s[0] /= 0, std::out_of_range);
+	REQUIRE(raw[0] == 42);
+
+	REQUIRE_THROWS_AS(s.at(4), std::out_of_range);
+	REQUIRE(s.at(3).getvalue() == std::numeric_limits<std::int32_t>::max());
+}
+
+TEST_CASE("safe_span with algorithms", "[span]") {
+	std::int16_t raw[] = {1, 2, 3, 4, 5};
+	safe_span<std::int16_t> s(raw);
+	REQUIRE(s.size() == 5);
+	REQUIRE(std::accumulate(s.begin(), s.end(), safe_integral<std::int16_t>(0)) == 15);
+	REQUIRE(std::count_if(s.begin(), s.end(), [](const safe_integral<std::int16_t> v){ return v > 2; }) == 3);
+	REQUIRE(std::distance(s.begin(), s.end()) == 5);
+	REQUIRE(*(s.end() - 1) == 5);
+
+	std::fill(s.begin(), s.end(), safe_integral<std::int16_t>(std::numeric_limits<std::int16_t>::max()));
+	REQUIRE(raw[4] == std::numeric_limits<std::int16_t>::max());
+	REQUIRE_THROWS_AS(std::accumulate(s.begin(), s.end(), safe_integral<std::int16_t>(0)), std::out_of_range);
+
+	const auto sub = s.subspan(1, 3);
+	REQUIRE(sub.size() == 3);
+	REQUIRE(sub.data() == raw + 1);
+	REQUIRE_THROWS_AS(s.subspan(3, 3), std::out_of_range);
+	REQUIRE(s.subspan(5, 0).empty());
+}
+
+TEST_CASE("safe_span, const and conversions", "[span]") {
+	const std::vector<std::uint8_t> raw = {200, 100};
+	const auto s = make_safe_span(raw.data(), raw.size());
+	REQUIRE_THROWS_AS(s[0].get() + s[1], std::out_of_range);
+	REQUIRE(s[0].get() - s[1] == 100);
+
+	std::vector<safe_int> v(3);
+	v[2] = 7;
+	safe_span<int> view(v.data(), v.size());
+	view[0] = 5;
+	REQUIRE(v[0] == 5);
+	REQUIRE(safeintegralop::raw_data(v.data())[2] == 7);
+
+	const safe_span<const int> cview = view;
+	REQUIRE(cview[0] == 5);
+	REQUIRE(cview.data() == safeintegralop::raw_data(v.data()));
+	const std::vector<safe_int>& cv = v;
+	REQUIRE(safe_span<const int>(cv.data(), cv.size())[2] == 7);
+}
+
+TEST_CASE("safe_span, iterator category", "[span]") {
+	// operator* returns a proxy
+	static_assert(std::is_same<std::iterator_traits<safe_span<int>::iterator>::iterator_category, std::input_iterator_tag>::value, "");
+#if  __cplusplus > 201703L // compiling with c++20 or greater
+	static_assert(std::random_access_iterator<safe_span<int>::iterator>, "");
+	static_assert(std::random_access_iterator<safe_span<const int>::iterator>, "");
+#endif
+	int raw[] = {1, 2, 3, 4};
+	const safe_span<int> s(raw);
+	REQUIRE(*(s.end() - 1) == 4);
+	REQUIRE(s.begin()[2] == 3);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+}
+
+TEST_CASE("sum of raw buffer, copied to std::vector<safe_int>", "[span][.]") {
+	const std::vector<std::int32_t> raw(bigvector, 1);
+	safe_int sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		const std::vector<safe_int> copy(raw.begin(), raw.end());
+		sum = std::accumulate(copy.begin(), copy.end(), safe_int(0));
+	}
+	REQUIRE(sum == static_cast<int>(bigvector));
+}
+
+TEST_CASE("sum of raw buffer, with safe_span", "[span][.]") {
+	std::vector<std::int32_t> raw(bigvector, 1);
+	safe_int sum = 0;
+	for(int r = 0; r != repetitions; ++r){
+		const safe_span<const std::int32_t> s(raw.data(), raw.size());
+		sum = std::accumulate(s.begin(), s.end(), safe_int(0));
+	}
+	REQUIRE(sum == static_cast<int>(bigvector));
+}
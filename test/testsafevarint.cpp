@@ -0,0 +1,260 @@
+#include "catch.hpp"
+
+#include "../safeintegral/safevarint.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+static_assert(safeintegralop::varint_size(0) == 1, "");
+static_assert(safeintegralop::varint_size(127) == 1, "");
+static_assert(safeintegralop::varint_size(128) == 2, "");
+static_assert(safeintegralop::varint_size(std::numeric_limits<std::uint64_t>::max()) == safeintegralop::max_varint_bytes, "");
+static_assert(safeintegralop::zigzag_encode(-1) == 1, "");
+static_assert(safeintegralop::zigzag_encode(1) == 2, "");
+static_assert(safeintegralop::zigzag_encode(std::numeric_limits<std::int64_t>::min()) == std::numeric_limits<std::uint64_t>::max(), "");
+static_assert(safeintegralop::zigzag_decode(std::numeric_limits<std::uint64_t>::max()) == std::numeric_limits<std::int64_t>::min(), "");
+static_assert(safeintegralop::zigzag_decode(4) == 2, "");
+
+namespace {
+	// values of every length, with more short values
+	std::vector<std::uint64_t> make_values(const std::size_t count) {
+		std::vector<std::uint64_t> v(count);
+		std::uint64_t x = 88172645463325252ull;
+		for(std::size_t i = 0; i != count; ++i){
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+			const unsigned bits = unsigned(x % 4 == 0 ? x % 64 : x % 14) + 1;
+			v[i] = (x >> 7) & (bits == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1);
+		}
+		return v;
+	}
+
+	std::vector<unsigned char> encode_all(const std::vector<std::uint64_t>& values) {
+		std::vector<unsigned char> res(values.size() * safeintegralop::max_varint_bytes);
+		std::size_t n = 0;
+		for(const auto v : values){
+			n += safeintegralop::encode_varint(v, res.data() + n);
+		}
+		res.resize(n);
+		return res;
+	}
+}
+
+TEST_CASE("varint encode and decode", "[varint]") {
+	unsigned char buffer[safeintegralop::max_varint_bytes];
+	REQUIRE(safeintegralop::encode_varint(std::uint32_t(300), buffer) == 2);
+	REQUIRE(buffer[0] == 0xAC);
+	REQUIRE(buffer[1] == 0x02);
+
+	const std::uint64_t values[] = {0, 1, 127, 128, 16383, 16384, 0xFFFFFFFFu, std::uint64_t(1) << 63, std::numeric_limits<std::uint64_t>::max()};
+	for(const auto v : values){
+		const auto n = safeintegralop::encode_varint(v, buffer);
+		REQUIRE(n == safeintegralop::varint_size(v));
+		safe_integral<std::uint64_t> res;
+		REQUIRE(safeintegralop::decode_varint(buffer, n, res) == n);
+		REQUIRE(res == v);
+		// truncated
+		REQUIRE(safeintegralop::decode_varint(buffer, n - 1, res) == 0);
+	}
+
+	const std::int64_t signed_values[] = {0, -1, 1, -64, 64, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()};
+	for(const auto v : signed_values){
+		const auto n = safeintegralop::encode_zigzag(safe_integral<std::int64_t>(v), buffer);
+		REQUIRE(n == safeintegralop::varint_size(safeintegralop::zigzag_encode(v)));
+		safe_integral<std::int64_t> res;
+		REQUIRE(safeintegralop::decode_zigzag(buffer, n, res) == n);
+		REQUIRE(res == v);
+	}
+}
+
+TEST_CASE("varint malformed and out of range", "[varint]") {
+	safe_integral<std::uint64_t> res = 42;
+	// 11 bytes
+	const unsigned char too_long[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+	REQUIRE(safeintegralop::decode_varint(too_long, sizeof(too_long), res) == 0);
+	// 10 bytes, but 65 bits
+	const unsigned char too_big[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02};
+	REQUIRE(safeintegralop::decode_varint(too_big, sizeof(too_big), res) == 0);
+	REQUIRE(res == 42u);
+	// over-long encodings of small values are accepted
+	const unsigned char padded[] = {0x81, 0x80, 0x00};
+	REQUIRE(safeintegralop::decode_varint(padded, sizeof(padded), res) == 3);
+	REQUIRE(res == 1u);
+
+	unsigned char buffer[safeintegralop::max_varint_bytes];
+	const auto n = safeintegralop::encode_varint(std::uint32_t(65536), buffer);
+	safe_integral<std::uint16_t> narrow = 7;
+	REQUIRE(safeintegralop::decode_varint(buffer, n, narrow) == 0);
+	REQUIRE(narrow == 7);
+	safe_integral<std::int32_t> wide;
+	REQUIRE(safeintegralop::decode_varint(buffer, n, wide) == n);
+	REQUIRE(wide == 65536);
+
+	safe_integral<std::int8_t> s8;
+	REQUIRE(safeintegralop::decode_zigzag(buffer, safeintegralop::encode_zigzag(-128, buffer), s8) != 0);
+	REQUIRE(s8 == -128);
+	REQUIRE(safeintegralop::decode_zigzag(buffer, safeintegralop::encode_zigzag(-129, buffer), s8) == 0);
+	REQUIRE(safeintegralop::decode_zigzag(buffer, safeintegralop::encode_zigzag(128, buffer), s8) == 0);
+}
+
+TEST_CASE("decode_varints", "[varint]") {
+	const auto values = make_values(5000);
+	const auto bytes = encode_all(values);
+
+	std::vector<std::uint64_t> out(values.size());
+	std::size_t read = 0;
+	REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), out.data(), out.size(), read) == values.size());
+	REQUIRE(read == bytes.size());
+	REQUIRE(out == values);
+
+	std::vector<safe_integral<std::uint64_t>> safe_out(values.size());
+	REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), safe_out.data(), safe_out.size(), read) == values.size());
+	for(std::size_t i = 0; i != values.size(); ++i){
+		REQUIRE(safe_out[i] == values[i]);
+	}
+
+	// less values than available
+	REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), out.data(), 100, read) == 100);
+	REQUIRE(read == encode_all(std::vector<std::uint64_t>(values.begin(), values.begin() + 100)).size());
+	// truncated input
+	REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size() - 1, out.data(), out.size(), read) == values.size() - 1);
+
+	// the first value not representable by std::uint16_t, at every position of the blocks of 16 bytes
+	for(std::size_t k = 0; k != 100; ++k){
+		std::vector<std::uint64_t> small(300, 1000);
+		small[k] = 70000;
+		const auto b = encode_all(small);
+		std::vector<std::uint16_t> out16(small.size());
+		REQUIRE(safeintegralop::decode_varints(b.data(), b.size(), out16.data(), out16.size(), read) == k);
+		REQUIRE(read == 2 * k);
+		REQUIRE(out16[k] == 0);
+		if(k != 0){
+			REQUIRE(out16[k - 1] == 1000);
+		}
+	}
+}
+
+TEST_CASE("decode_varints malformed", "[varint]") {
+	auto values = make_values(1000);
+	for(std::size_t k = 0; k < values.size(); k += 37){
+		auto bytes = encode_all(values);
+		const auto prefix = encode_all(std::vector<std::uint64_t>(values.begin(), values.begin() + std::ptrdiff_t(k))).size();
+		// value k has 11 bytes
+		bytes.insert(bytes.begin() + std::ptrdiff_t(prefix), std::size_t(11), static_cast<unsigned char>(0x80));
+		std::vector<std::uint64_t> out(values.size());
+		std::size_t read = 0;
+		REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), out.data(), out.size(), read) == k);
+		REQUIRE(read == prefix);
+		REQUIRE(std::equal(out.begin(), out.begin() + std::ptrdiff_t(k), values.begin()));
+	}
+}
+
+TEST_CASE("decode_zigzags", "[varint]") {
+	std::vector<std::int32_t> values(3000);
+	for(std::size_t i = 0; i != values.size(); ++i){
+		values[i] = (i % 2 == 0 ? -1 : 1) * std::int32_t(i * i * 239);
+	}
+	values[17] = std::numeric_limits<std::int32_t>::min();
+	values[18] = std::numeric_limits<std::int32_t>::max();
+	std::vector<unsigned char> bytes(values.size() * safeintegralop::max_varint_bytes);
+	std::size_t n = 0;
+	for(const auto v : values){
+		n += safeintegralop::encode_zigzag(v, bytes.data() + n);
+	}
+	std::vector<safe_integral<std::int32_t>> out(values.size());
+	std::size_t read = 0;
+	REQUIRE(safeintegralop::decode_zigzags(bytes.data(), n, out.data(), out.size(), read) == values.size());
+	REQUIRE(read == n);
+	for(std::size_t i = 0; i != values.size(); ++i){
+		REQUIRE(out[i] == values[i]);
+	}
+	std::vector<std::int16_t> out16(values.size());
+	REQUIRE(safeintegralop::decode_zigzags(bytes.data(), n, out16.data(), out16.size(), read) == 12); // 12 * 12 * 239 > 32767
+}
+
+TEST_CASE("decode_zigzags of values of one byte", "[varint]") {
+	// -1, 1, -2, 2, ..., -64 63: 16 bytes without continuation bit, more than once
+	std::vector<std::int64_t> values;
+	for(std::int64_t v = 1; v <= 64; ++v){
+		values.push_back(-v);
+		values.push_back(v == 64 ? 63 : v);
+	}
+	std::vector<unsigned char> bytes(values.size() * safeintegralop::max_varint_bytes);
+	std::size_t n = 0;
+	for(const auto v : values){
+		n += safeintegralop::encode_zigzag(v, bytes.data() + n);
+	}
+	REQUIRE(n == values.size());
+	bytes.resize(n + 32);
+	std::vector<std::int8_t> out(values.size());
+	std::size_t read = 0;
+	REQUIRE(safeintegralop::decode_zigzags(bytes.data(), bytes.size(), out.data(), out.size(), read) == values.size());
+	REQUIRE(read == n);
+	for(std::size_t i = 0; i != values.size(); ++i){
+		REQUIRE(out[i] == values[i]);
+	}
+	std::vector<safe_integral<std::int64_t>> out64(values.size());
+	REQUIRE(safeintegralop::decode_zigzags(bytes.data(), bytes.size(), out64.data(), out64.size(), read) == values.size());
+	for(std::size_t i = 0; i != values.size(); ++i){
+		REQUIRE(out64[i] == values[i]);
+	}
+	// the first value is negative
+	std::vector<std::uint32_t> out_u(values.size());
+	REQUIRE(safeintegralop::decode_zigzags(bytes.data(), bytes.size(), out_u.data(), out_u.size(), read) == 0);
+	REQUIRE(read == 0);
+}
+
+// Simple profiling test
+namespace {
+	const std::size_t bigvector = 1 << 20;
+	const auto repetitions = 100;
+}
+
+TEST_CASE("decode varints one by one", "[varint][.]") {
+	const auto bytes = encode_all(make_values(bigvector));
+	std::vector<safe_integral<std::uint64_t>> out(bigvector);
+	std::size_t read = 0;
+	for(int r = 0; r != repetitions; ++r){
+		read = 0;
+		for(std::size_t i = 0; i != out.size(); ++i){
+			read += safeintegralop::decode_varint(bytes.data() + read, bytes.size() - read, out[i]);
+		}
+	}
+	REQUIRE(read == bytes.size());
+}
+
+TEST_CASE("decode_varints in blocks", "[varint][.]") {
+	const auto bytes = encode_all(make_values(bigvector));
+	std::vector<safe_integral<std::uint64_t>> out(bigvector);
+	std::size_t read = 0;
+	for(int r = 0; r != repetitions; ++r){
+		REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), out.data(), out.size(), read) == out.size());
+	}
+	REQUIRE(read == bytes.size());
+}
+
+TEST_CASE("decode_varints, malformed last value", "[varint][.]") {
+	auto bytes = encode_all(make_values(bigvector - 1));
+	const auto size = bytes.size();
+	bytes.insert(bytes.end(), std::size_t(11), static_cast<unsigned char>(0xFF));
+	std::vector<safe_integral<std::uint64_t>> out(bigvector);
+	std::size_t read = 0;
+	for(int r = 0; r != repetitions; ++r){
+		REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), out.data(), out.size(), read) == bigvector - 1);
+	}
+	REQUIRE(read == size);
+}
+
+TEST_CASE("decode_varints, last value not representable by std::uint16_t", "[varint][.]") {
+	std::vector<std::uint64_t> values(bigvector, 60000);
+	values.back() = 70000;
+	const auto bytes = encode_all(values);
+	std::vector<std::uint16_t> out(bigvector);
+	std::size_t read = 0;
+	for(int r = 0; r != repetitions; ++r){
+		REQUIRE(safeintegralop::decode_varints(bytes.data(), bytes.size(), out.data(), out.size(), read) == bigvector - 1);
+	}
+	REQUIRE(read == 3 * (bigvector - 1));
+}